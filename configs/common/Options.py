@@ -186,6 +186,10 @@ def addCommonOptions(parser):
     parser.add_option("--indirect-bp-type", type="choice", default=None,
                       choices=ObjectList.indirect_bp_list.get_names(),
                       help = "type of indirect branch predictor to run with")
+    parser.add_option("--record-bp-trace", action="store_true",
+                      help="""Record the branches committed by each CPU's
+                      branch predictor to a trace that can be replayed
+                      with bp_replay.py""")
     parser.add_option("--list-hwp-types",
                       action="callback", callback=_listHWPTypes,
                       help="List available hardware prefetcher types")
@@ -424,6 +428,12 @@ def addFSOptions(parser):
     # Simulation options
     parser.add_option("--timesync", action="store_true",
             help="Prevent simulated time from getting ahead of real time")
+    parser.add_option("--parallel-fast-forward", action="store_true",
+            help="(Experimental) Run each non-caching CPU on its own event "\
+            "queue and host thread while fast-forwarding")
+    parser.add_option("--sim-quantum", action="store", type="string",
+            default="1ms",
+            help="Simulation quantum for --parallel-fast-forward")
 
     # System options
     parser.add_option("--kernel", action="store", type="string")
@@ -85,8 +85,12 @@ def setCPUClass(options):
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
     elif options.fast_forward:
         CPUClass = TmpClass
-        TmpClass = AtomicSimpleCPU
-        test_mem_mode = 'atomic'
+        if getattr(options, 'parallel_fast_forward', False):
+            TmpClass = NonCachingSimpleCPU
+            test_mem_mode = 'atomic_noncaching'
+        else:
+            TmpClass = AtomicSimpleCPU
+            test_mem_mode = 'atomic'
 
     # Ruby only supports atomic accesses in noncaching mode
     if test_mem_mode == 'atomic' and options.ruby:
@@ -100,6 +104,40 @@ def setMemClass(options):
 
     return ObjectList.mem_list.get(options.mem_type)
 
+def setParallelFastForward(options, root, testsys):
+    """Place each of the initial non-caching CPUs on an event queue of
+    its own. Everything else, including the CPUs' caches and interrupt
+    controllers, stays on the main event queue, and the CPUs
+    synchronize with each other every simulation quantum. The CPUs
+    access memory through the backing store in parallel and only
+    migrate to the main event queue to access devices."""
+
+    cpus = testsys.cpu
+    if not all(isinstance(cpu, NonCachingSimpleCPU) for cpu in cpus):
+        fatal("--parallel-fast-forward requires --fast-forward or "
+              "--cpu-type=NonCachingSimpleCPU")
+    if options.ruby:
+        fatal("--parallel-fast-forward is not supported with Ruby")
+    if len(cpus) < 2:
+        return
+
+    for cpu in cpus:
+        cpu.backdoor_access = True
+
+    # This has to be done after creating caches and other child
+    # objects since these mustn't inherit the CPU event queue.
+    device_eq = 0
+    first_cpu_eq = 1
+    for idx, cpu in enumerate(cpus):
+        for obj in cpu.descendants():
+            obj.eventq_index = device_eq
+        cpu.eventq_index = first_cpu_eq + idx
+
+    inform("Running in PDES mode with a %s simulation quantum.",
+           options.sim_quantum)
+    root.sim_quantum = m5.ticks.fromSeconds(convert.anyToLatency(
+        options.sim_quantum))
+
 def setWorkCountOptions(system, options):
     if options.work_item_id != None:
         system.work_item_id = options.work_item_id
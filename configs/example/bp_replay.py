@@ -0,0 +1,76 @@
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace recorded with --record-bp-trace through a
+# standalone branch predictor. The predictor's accuracy and MPKI are
+# reported in the replayer's stats.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = optparse.OptionParser()
+
+parser.add_option("--trace-file", action="store", type="string",
+                  help="Branch trace to replay")
+parser.add_option("--bp-type", type="choice", default="TAGE_SC_L_64KB",
+                  choices=ObjectList.bp_list.get_names(),
+                  help="type of branch predictor to evaluate")
+parser.add_option("--indirect-bp-type", type="choice", default=None,
+                  choices=ObjectList.indirect_bp_list.get_names(),
+                  help="type of indirect branch predictor to evaluate")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print("Error: script doesn't take any positional arguments")
+    sys.exit(1)
+
+if not options.trace_file:
+    fatal("A branch trace is required, use --trace-file\n")
+
+bp = ObjectList.bp_list.get(options.bp_type)()
+if options.indirect_bp_type:
+    bp.indirectBranchPred = \
+        ObjectList.indirect_bp_list.get(options.indirect_bp_type)()
+
+root = Root(full_system=False)
+root.replayer = BranchTraceReplayer(branch_pred=bp,
+                                    trace_file=options.trace_file)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' % (m5.curTick(), exit_event.getCause()))
@@ -216,6 +216,13 @@ def build_test_system(np):
                         options.indirect_bp_type)
                     test_sys.cpu[i].branchPred.indirectBranchPred = \
                         IndirectBPClass()
+                if options.record_bp_trace:
+                    if not buildEnv['HAVE_PROTOBUF']:
+                        fatal("--record-bp-trace requires protobuf support")
+                    if test_sys.cpu[i].branchPred == m5.params.NULL:
+                        fatal("--record-bp-trace requires a branch "
+                              "predictor. Select one with --bp-type.")
+                    test_sys.cpu[i].branchTrace = BranchTraceRecorder()
             test_sys.cpu[i].createThreads()
 
         # If elastic tracing is enabled when not restoring from checkpoint and
@@ -361,6 +368,9 @@ else:
 if options.timesync:
     root.time_sync_enable = True
 
+if options.parallel_fast_forward:
+    Simulation.setParallelFastForward(options, root, test_sys)
+
 if options.frame_capture:
     VncServer.frame_capture = True
 
@@ -242,6 +242,14 @@ for i in range(np):
             ObjectList.indirect_bp_list.get(options.indirect_bp_type)
         system.cpu[i].branchPred.indirectBranchPred = indirectBPClass()
 
+    if options.record_bp_trace:
+        if not buildEnv['HAVE_PROTOBUF']:
+            fatal("--record-bp-trace requires protobuf support")
+        if system.cpu[i].branchPred == NULL:
+            fatal("--record-bp-trace requires a branch predictor. Select "
+                  "one with --bp-type.")
+        system.cpu[i].branchTrace = BranchTraceRecorder()
+
     system.cpu[i].createThreads()
 
 if options.ruby:
@@ -42,9 +42,9 @@ def define_options(parser):
     parser.add_option("--mesh-rows", type="int", default=0,
                       help="the number of rows in the mesh topology")
     parser.add_option("--network", type="choice", default="simple",
-                      choices=['simple', 'garnet'],
-                      help="""'simple'|'garnet' (garnet2.0 will be
-                      deprecated.)""")
+                      choices=['simple', 'garnet', 'analytical'],
+                      help="""'simple'|'garnet'|'analytical' (garnet2.0
+                      will be deprecated.)""")
     parser.add_option("--router-latency", action="store", type="int",
                       default=1,
                       help="""number of pipeline stages in the garnet router.
@@ -58,7 +58,8 @@ def define_options(parser):
                             in the topology file.""")
     parser.add_option("--link-width-bits", action="store", type="int",
                       default=128,
-                      help="width in bits for all links inside garnet.")
+                      help="""width in bits for all links inside garnet
+                            and the analytical network.""")
     parser.add_option("--vcs-per-vnet", action="store", type="int", default=4,
                       help="""number of virtual channels per virtual network
                             inside garnet network.""")
@@ -75,6 +76,11 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--garnet-router-threads", action="store",
+                      type="int", default=0,
+                      help="""number of host threads evaluating the garnet
+                            routers of a cycle in parallel. 0 disables
+                            batched router evaluation.""")
 
 def create_network(options, ruby):
 
@@ -94,6 +100,13 @@ def create_network(options, ruby):
         RouterClass = GarnetRouter
         InterfaceClass = GarnetNetworkInterface
 
+    elif options.network == "analytical":
+        NetworkClass = AnalyticalNetwork
+        IntLinkClass = BasicIntLink
+        ExtLinkClass = BasicExtLink
+        RouterClass = BasicRouter
+        InterfaceClass = None
+
     else:
         NetworkClass = SimpleNetwork
         IntLinkClass = SimpleIntLink
@@ -116,6 +129,7 @@ def init_network(options, network, InterfaceClass):
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.router_threads = options.garnet_router_threads
 
         # Create Bridges and connect them to the corresponding links
         for intLink in network.int_links:
@@ -184,6 +198,11 @@ def init_network(options, network, InterfaceClass):
     if options.network == "simple":
         network.setup_buffers()
 
+    if options.network == "analytical":
+        # Model the same link width as garnet would use
+        for link in list(network.int_links) + list(network.ext_links):
+            link.bandwidth_factor = options.link_width_bits // 8
+
     if InterfaceClass != None:
         netifs = [InterfaceClass(id=i) \
                   for (i,n) in enumerate(network.ext_links)]
@@ -89,6 +89,10 @@ def define_options(parser):
     parser.add_option("--recycle-latency", type="int", default=10,
                       help="Recycle latency for ruby controller input buffers")
 
+    parser.add_option("--ruby-warmup-outstanding", type="int", default=1,
+                      help="Number of cache warmup requests kept in flight "
+                           "when restoring ruby caches from a checkpoint")
+
     protocol = buildEnv['PROTOCOL']
     exec("from . import %s" % protocol)
     eval("%s.define_options(parser)" % protocol)
@@ -235,6 +239,7 @@ def create_system(options, full_system, system, piobus = None, dma_ports = [],
     ruby.number_of_virtual_networks = ruby.network.number_of_virtual_networks
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
+    ruby.warmup_max_outstanding = options.ruby_warmup_outstanding
 
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
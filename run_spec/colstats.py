@@ -0,0 +1,216 @@
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for gem5 columnar stat files (--stats-file=col://stats.col).
+
+The file is memory mapped, so opening it is cheap even for long runs
+with many periodic dumps, and stats can be read while gem5 is still
+writing it (open it again to see new dumps).
+
+    import colstats
+    s = colstats.open_stats('m5out/stats.col')
+    s.num_dumps
+    s.get('sim_insts')                # value in the last dump
+    s.get('system.cpu.ipc', dump=0)   # value in the first dump
+    s.series('system.l2cache.overall_misses::total')  # one value per dump
+
+Names follow stats.txt: 'stat' for scalars and formulas, 'stat::sub'
+for vector elements (or 'stat::<index>' when there are no subnames)
+and 'stat::total' for the sum of a vector.  get() on a vector without
+'::' returns the list of its values.
+
+StatSampler objects write the same format with one dump per sample, so
+s.series('final_tick') gives the tick of each sample.
+
+The format is described in src/base/stats/columnar.hh.
+"""
+
+import mmap
+import struct
+
+MAGIC = b'gem5col\0'
+FULL_RECORD = 0
+DELTA_RECORD = 1
+
+TYPES = ['scalar', 'vector', 'vector2d', 'formula', 'dist']
+
+def _align(offset):
+    return (offset + 7) & ~7
+
+class Stat(object):
+    def __init__(self, name, type, desc, first, count, names):
+        self.name = name
+        self.type = type
+        self.desc = desc
+        # Index of the stat's first column and number of columns
+        self.first = first
+        self.count = count
+        self.names = names
+
+class ColumnarStats(object):
+    def __init__(self, path):
+        self._file = open(path, 'rb')
+        self._map = mmap.mmap(self._file.fileno(), 0,
+                              access=mmap.ACCESS_READ)
+        self.stats = []
+        self._by_name = {}
+        self._records = []
+        self._cache = {}
+        self._read_schema()
+        self._index_records()
+
+    def close(self):
+        self._map.close()
+        self._file.close()
+
+    def _word(self, offset):
+        return struct.unpack_from('=I', self._map, offset)[0], offset + 4
+
+    def _string(self, offset):
+        size, offset = self._word(offset)
+        value = self._map[offset:offset + size].decode('utf-8')
+        return value, offset + size
+
+    def _read_schema(self):
+        if self._map[:8] != MAGIC:
+            raise ValueError('Not a gem5 columnar stat file')
+        self.version, self.flags = struct.unpack_from('=II', self._map, 8)
+        offset = 16
+        num_stats, offset = self._word(offset)
+        self.num_columns, offset = self._word(offset)
+        first = 0
+        for _ in range(num_stats):
+            stat_type, offset = self._word(offset)
+            count, offset = self._word(offset)
+            name, offset = self._string(offset)
+            desc, offset = self._string(offset)
+            num_names, offset = self._word(offset)
+            names = []
+            for _ in range(num_names):
+                sub, offset = self._string(offset)
+                names.append(sub)
+            stat = Stat(name, TYPES[stat_type], desc, first, count, names)
+            self.stats.append(stat)
+            self._by_name[name] = stat
+            first += count
+        self._data = _align(offset)
+
+    def _index_records(self):
+        """Find the offset of every complete record in the file"""
+        offset = self._data
+        end = len(self._map)
+        while offset + 8 <= end:
+            kind, count = struct.unpack_from('=II', self._map, offset)
+            body = offset + 8
+            if kind == FULL_RECORD:
+                next_offset = body + 8 * count
+            else:
+                next_offset = _align(body + 4 * count) + 8 * count
+            if next_offset > end:
+                # Partially written record
+                break
+            self._records.append((offset, kind, count))
+            offset = next_offset
+
+    @property
+    def num_dumps(self):
+        return len(self._records)
+
+    def _apply(self, index, values):
+        """Update values with the record of a dump"""
+        offset, kind, count = self._records[index]
+        body = offset + 8
+        if kind == FULL_RECORD:
+            values[:] = struct.unpack_from('=%dd' % count, self._map, body)
+        else:
+            columns = struct.unpack_from('=%dI' % count, self._map, body)
+            changed = struct.unpack_from('=%dd' % count, self._map,
+                                         _align(body + 4 * count))
+            for column, value in zip(columns, changed):
+                values[column] = value
+
+    def dump(self, index):
+        """All column values of a dump as a list"""
+        if index < 0:
+            index += len(self._records)
+        if index in self._cache:
+            return self._cache[index]
+
+        # Delta records only hold the changed columns, so start from the
+        # closest cached dump or full record and replay forward.
+        start = index
+        while start not in self._cache and \
+                self._records[start][1] != FULL_RECORD:
+            start -= 1
+        values = list(self._cache.get(start, [0.0] * self.num_columns))
+        for i in range(start, index + 1):
+            if i != start or start not in self._cache:
+                self._apply(i, values)
+
+        # Keep a few dumps around to make sequential access cheap
+        if len(self._cache) > 4:
+            self._cache.clear()
+        self._cache[index] = values
+        return values
+
+    def _lookup(self, name):
+        if name in self._by_name:
+            return self._by_name[name], None
+        base, sep, sub = name.rpartition('::')
+        if not sep or base not in self._by_name:
+            raise KeyError(name)
+        return self._by_name[base], sub
+
+    def get(self, name, dump=-1):
+        stat, sub = self._lookup(name)
+        values = self.dump(dump)[stat.first:stat.first + stat.count]
+        if sub is None:
+            return values[0] if stat.count == 1 and not stat.names \
+                else values
+        if sub == 'total' and 'total' not in stat.names:
+            return sum(values)
+        if sub in stat.names:
+            return values[stat.names.index(sub)]
+        return values[int(sub)]
+
+    def series(self, name):
+        return [ self.get(name, i) for i in range(self.num_dumps) ]
+
+def open_stats(path):
+    return ColumnarStats(path)
+
+def get_stat(path, name, default=0.0):
+    """Value of a stat in the last dump, like gem5GetStat on stats.txt"""
+    try:
+        stats = ColumnarStats(path)
+    except (IOError, ValueError):
+        return default
+    try:
+        return stats.get(name) if stats.num_dumps else default
+    except KeyError:
+        return default
+    finally:
+        stats.close()
@@ -0,0 +1,180 @@
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Round-trip check for colstats.py.
+
+Writes files in the layout documented in src/base/stats/columnar.hh,
+which the Columnar stats output is checked against by
+src/base/stats/columnar.test.cc, and reads them back with colstats.
+
+    python3 test_colstats.py
+"""
+
+import math
+import os
+import struct
+import tempfile
+import unittest
+
+import colstats
+
+SCALAR, VECTOR, VECTOR2D, FORMULA, DIST = range(5)
+
+def _pad(data):
+    return data + b'\0' * (-len(data) % 8)
+
+def _string(value):
+    value = value.encode('utf-8')
+    return struct.pack('=I', len(value)) + value
+
+class Writer(object):
+    """Minimal writer following the documented layout"""
+
+    def __init__(self, stats, changed=False):
+        # stats is a list of (type, name, desc, num_columns, names)
+        self.changed = changed
+        self.last = None
+        self.data = b'gem5col\0' + struct.pack('=II', 1, int(changed))
+        self.data += struct.pack('=II', len(stats),
+                                 sum(s[3] for s in stats))
+        for stat_type, name, desc, count, names in stats:
+            self.data += struct.pack('=II', stat_type, count)
+            self.data += _string(name) + _string(desc)
+            self.data += struct.pack('=I', len(names))
+            for sub in names:
+                self.data += _string(sub)
+        self.data = _pad(self.data)
+
+    def dump(self, values):
+        if not self.changed or self.last is None:
+            self.data += struct.pack('=II', colstats.FULL_RECORD,
+                                     len(values))
+            self.data += struct.pack('=%dd' % len(values), *values)
+        else:
+            columns = [ i for i, (a, b) in
+                        enumerate(zip(self.last, values))
+                        if struct.pack('=d', a) != struct.pack('=d', b) ]
+            self.data += struct.pack('=II', colstats.DELTA_RECORD,
+                                     len(columns))
+            self.data = _pad(self.data +
+                             struct.pack('=%dI' % len(columns), *columns))
+            self.data += struct.pack('=%dd' % len(columns),
+                                     *[ values[i] for i in columns ])
+        self.last = list(values)
+
+STATS = [
+    (SCALAR, 'sim_insts', 'Number of instructions', 1, []),
+    (VECTOR, 'system.cpu.misses', 'Misses', 3, ['read', 'write', 'total']),
+    (FORMULA, 'system.cpu.ratio', '', 2, []),
+    (DIST, 'system.cpu.lat', '', 11,
+     ['samples', 'sum', 'squares', 'min_value', 'max_value',
+      'underflows', 'overflows', 'min', 'bucket_size', '0', '1']),
+]
+
+DUMPS = [
+    [100, 1, 2, 3, 0.5, 0.25] + [2, 3, 5, 1, 2, 0, 0, 0, 1, 1, 1],
+    [100, 1, 4, 5, 0.5, 0.75] + [2, 3, 5, 1, 2, 0, 0, 0, 1, 1, 1],
+    [300, 1, 4, 5, 0.5, 0.75] + [4, 9, 25, 1, 4, 0, 1, 0, 1, 2, 1],
+    [300, 1, 4, 5, 0.5, 0.75] + [4, 9, 25, 1, 4, 0, 1, 0, 1, 2, 1],
+]
+
+class ColstatsTest(unittest.TestCase):
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix='.col')
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def write(self, changed, dumps=DUMPS, truncate=0):
+        writer = Writer(STATS, changed)
+        for values in dumps:
+            writer.dump(values)
+        with open(self.path, 'wb') as f:
+            f.write(writer.data[:len(writer.data) - truncate])
+        return colstats.open_stats(self.path)
+
+    def check(self, stats):
+        self.assertEqual(stats.num_dumps, len(DUMPS))
+        self.assertEqual([ s.name for s in stats.stats ],
+                         [ s[1] for s in STATS ])
+        self.assertEqual(stats.stats[0].desc, 'Number of instructions')
+        for i, values in enumerate(DUMPS):
+            self.assertEqual(stats.dump(i), values)
+        self.assertEqual(stats.series('sim_insts'), [100, 100, 300, 300])
+        self.assertEqual(stats.get('system.cpu.misses::write', dump=0), 2)
+        self.assertEqual(stats.get('system.cpu.misses::total'), 5)
+        self.assertEqual(stats.get('system.cpu.misses'), [1, 4, 5])
+        # Formulas without subnames are addressed by index and summed
+        self.assertEqual(stats.get('system.cpu.ratio::1', dump=1), 0.75)
+        self.assertEqual(stats.get('system.cpu.ratio::total'), 1.25)
+        self.assertEqual(stats.get('system.cpu.lat::samples'), 4)
+        self.assertEqual(stats.get('system.cpu.lat::0', dump=1), 1)
+        self.assertRaises(KeyError, stats.get, 'system.cpu.nothing')
+
+    def test_full_records(self):
+        stats = self.write(False)
+        self.assertEqual(stats.flags, 0)
+        self.check(stats)
+        stats.close()
+
+    def test_delta_records(self):
+        stats = self.write(True)
+        self.assertEqual(stats.flags, 1)
+        self.assertEqual([ r[1] for r in stats._records ],
+                         [ colstats.FULL_RECORD ] +
+                         [ colstats.DELTA_RECORD ] * 3)
+        # The changed column lists of the second and third dump have an
+        # odd length and are padded, the last dump changes nothing.
+        self.assertEqual([ r[2] for r in stats._records ], [17, 3, 7, 0])
+        self.check(stats)
+        # Random access has to replay the deltas from the full record
+        self.assertEqual(stats.dump(1), DUMPS[1])
+        self.assertEqual(stats.dump(-1), DUMPS[-1])
+        stats.close()
+
+    def test_nan(self):
+        dumps = [ [ float('nan') ] + DUMPS[0][1:], DUMPS[1] ]
+        stats = self.write(True, dumps)
+        self.assertTrue(math.isnan(stats.get('sim_insts', dump=0)))
+        self.assertEqual(stats.get('sim_insts'), 100)
+        stats.close()
+
+    def test_partial_record(self):
+        # A dump that is still being written is ignored
+        stats = self.write(True, truncate=4)
+        self.assertEqual(stats.num_dumps, len(DUMPS) - 1)
+        self.assertEqual(stats.get('sim_insts'), 300)
+        stats.close()
+
+    def test_not_columnar(self):
+        with open(self.path, 'wb') as f:
+            f.write(b'---------- Begin Simulation Statistics ----------\n')
+        self.assertRaises(ValueError, colstats.open_stats, self.path)
+        self.assertEqual(colstats.get_stat(self.path, 'sim_insts', -1), -1)
+
+if __name__ == '__main__':
+    unittest.main()
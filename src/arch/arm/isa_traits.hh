@@ -50,6 +50,11 @@ namespace ArmISA
 
     const Addr PageShift = 12;
     const Addr PageBytes = ULL(1) << PageShift;
+
+    // Whether the decoder builds each instruction from the instruction
+    // word at its PC alone, so that decoded instructions can be cached
+    // by PC and instruction word
+    const bool StatelessDecoder = false;
 } // namespace ArmISA
 
 #endif // __ARCH_ARM_ISA_TRAITS_HH__
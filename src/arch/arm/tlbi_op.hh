@@ -40,7 +40,9 @@
 
 #include "arch/arm/system.hh"
 #include "arch/arm/tlb.hh"
+#include "cpu/base.hh"
 #include "cpu/thread_context.hh"
+#include "sim/eventq.hh"
 
 /**
  * @file
@@ -68,8 +70,13 @@ class TLBIOp
     void
     broadcast(ThreadContext *tc)
     {
-        for (auto *oc: tc->getSystemPtr()->threads)
+        for (auto *oc: tc->getSystemPtr()->threads) {
+            // The other cores may run on event queues and host
+            // threads of their own.
+            EventQueue::ScopedMigration migrate(
+                oc->getCpuPtr()->eventQueue());
             (*this)(oc);
+        }
     }
 
   protected:
@@ -40,6 +40,11 @@ const ByteOrder GuestByteOrder = ByteOrder::little;
 const Addr PageShift = 13;
 const Addr PageBytes = ULL(1) << PageShift;
 
+// Whether the decoder builds each instruction from the instruction
+// word at its PC alone, so that decoded instructions can be cached
+// by PC and instruction word
+const bool StatelessDecoder = true;
+
 } // namespace MipsISA
 
 #endif // __ARCH_MIPS_ISA_TRAITS_HH__
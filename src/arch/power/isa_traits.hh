@@ -41,6 +41,11 @@ const ByteOrder GuestByteOrder = ByteOrder::big;
 const Addr PageShift = 12;
 const Addr PageBytes = ULL(1) << PageShift;
 
+// Whether the decoder builds each instruction from the instruction
+// word at its PC alone, so that decoded instructions can be cached
+// by PC and instruction word
+const bool StatelessDecoder = true;
+
 } // namespace PowerISA
 
 #endif // __ARCH_POWER_ISA_TRAITS_HH__
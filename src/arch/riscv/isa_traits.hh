@@ -52,6 +52,11 @@ const ByteOrder GuestByteOrder = ByteOrder::little;
 const Addr PageShift = 12;
 const Addr PageBytes = ULL(1) << PageShift;
 
+// Whether the decoder builds each instruction from the instruction
+// word at its PC alone, so that decoded instructions can be cached
+// by PC and instruction word
+const bool StatelessDecoder = false;
+
 }
 
 #endif //__ARCH_RISCV_ISA_TRAITS_HH__
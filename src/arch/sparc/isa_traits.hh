@@ -39,6 +39,11 @@ const ByteOrder GuestByteOrder = ByteOrder::big;
 const Addr PageShift = 13;
 const Addr PageBytes = ULL(1) << PageShift;
 
+// Whether the decoder builds each instruction from the instruction
+// word at its PC alone, so that decoded instructions can be cached
+// by PC and instruction word
+const bool StatelessDecoder = false;
+
 }
 
 #endif // __ARCH_SPARC_ISA_TRAITS_HH__
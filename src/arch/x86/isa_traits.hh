@@ -46,6 +46,11 @@ namespace X86ISA
 
     const Addr PageShift = 12;
     const Addr PageBytes = ULL(1) << PageShift;
+
+    // Whether the decoder builds each instruction from the instruction
+    // word at its PC alone, so that decoded instructions can be cached
+    // by PC and instruction word
+    const bool StatelessDecoder = false;
 }
 
 #endif // __ARCH_X86_ISATRAITS_HH__
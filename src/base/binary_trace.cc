@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/binary_trace.hh"
+
+#include <atomic>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "sim/core.hh"
+
+namespace Trace {
+
+namespace {
+
+/** Serial number of the next logger.  The per-thread cache below goes
+ *  by serial number rather than address, since a new logger can be
+ *  allocated where an old one was. */
+std::atomic<uint64_t> nextSerial(1);
+
+/** Per-thread cache of the thread's state in the current logger */
+thread_local uint64_t cachedSerial = 0;
+thread_local void *cachedState = nullptr;
+
+} // anonymous namespace
+
+const uint32_t RecordLogger::Version;
+
+static_assert(sizeof(RecordLogger::FileHeader) == 16 &&
+              sizeof(RecordLogger::ChunkHeader) == 16 &&
+              sizeof(RecordLogger::RecordHeader) == 24,
+              "Unexpected trace header padding");
+
+RecordLogger::RecordLogger()
+    : serial(nextSerial++), textBuf(*this), textStream(&textBuf)
+{
+    textFormat = intern("%s");
+    deferFormat = true;
+}
+
+RecordLogger::ThreadState &
+RecordLogger::threadState()
+{
+    if (cachedSerial == serial)
+        return *static_cast<ThreadState *>(cachedState);
+
+    std::lock_guard<std::mutex> lock(stringMutex);
+    threads.emplace_back(newThreadState());
+    ThreadState *state = threads.back().get();
+    state->index = threads.size() - 1;
+    cachedSerial = serial;
+    cachedState = state;
+    return *state;
+}
+
+uint32_t
+RecordLogger::intern(const std::string &str)
+{
+    std::lock_guard<std::mutex> lock(stringMutex);
+    auto it = stringIds.find(str);
+    if (it != stringIds.end())
+        return it->second;
+
+    strings.push_back(str);
+    return stringIds.emplace(str, strings.size() - 1).first->second;
+}
+
+uint32_t
+RecordLogger::nameId(ThreadState &state, const std::string &name)
+{
+    auto it = state.names.find(name);
+    if (it != state.names.end())
+        return it->second;
+    return state.names.emplace(name, intern(name)).first->second;
+}
+
+uint32_t
+RecordLogger::formatId(ThreadState &state, const char *fmt)
+{
+    auto it = state.formats.find(fmt);
+    if (it != state.formats.end() && it->second.first == fmt)
+        return it->second.second;
+
+    auto &entry = state.formats[fmt];
+    entry.first = fmt;
+    entry.second = intern(entry.first);
+    return entry.second;
+}
+
+void
+RecordLogger::writeRecord(Tick when, const std::string &name,
+        const std::string &flag, const char *fmt,
+        const char *args, size_t args_size)
+{
+    ThreadState &state = threadState();
+
+    RecordHeader header;
+    header.tick = when;
+    header.name = nameId(state, name);
+    header.flag = nameId(state, flag);
+    header.format = fmt ? formatId(state, fmt) : textFormat;
+    header.argsSize = args_size;
+
+    char *record = reserve(state, sizeof(header) + args_size);
+    if (!record)
+        return;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), args, args_size);
+}
+
+void
+RecordLogger::logArgs(Tick when, const std::string &name,
+        const std::string &flag, const char *fmt, const TraceArgs &args)
+{
+    writeRecord(when, name, flag, fmt, args.data(), args.size());
+}
+
+void
+RecordLogger::logMessage(Tick when, const std::string &name,
+        const std::string &flag, const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    TraceArgs &args = TraceArgs::local();
+    args.clear();
+    args.add(message);
+    writeRecord(when, name, flag, nullptr, args.data(), args.size());
+}
+
+RecordLogger::FileHeader::FileHeader()
+    : magic("gem5dbg"), version(Version), byteOrder(0x01020304)
+{
+}
+
+void
+RecordLogger::writeFileHeader(std::ostream &os)
+{
+    const FileHeader header;
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void
+RecordLogger::writeChunk(std::ostream &os, ChunkKind kind, uint32_t thread,
+                         const char *data, uint64_t size)
+{
+    const ChunkHeader header = { kind, thread, size };
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(data, size);
+}
+
+void
+RecordLogger::encodeStrings(std::vector<char> &data, size_t first)
+{
+    for (size_t id = first; id < strings.size(); ++id) {
+        const std::string &str = strings[id];
+        const uint32_t header[] = { (uint32_t)id, (uint32_t)str.size() };
+        const char *bytes = reinterpret_cast<const char *>(header);
+        data.insert(data.end(), bytes, bytes + sizeof(header));
+        data.insert(data.end(), str.begin(), str.end());
+    }
+}
+
+RecordLogger::LineBuf::int_type
+RecordLogger::LineBuf::overflow(int_type c)
+{
+    if (c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    line.push_back(traits_type::to_char_type(c));
+    if (c == '\n') {
+        logger.logMessage(MaxTick, "", "", line);
+        line.clear();
+    }
+    return c;
+}
+
+BinaryLogger::BinaryLogger(std::ostream &_stream, size_t chunk_size,
+                           unsigned max_chunks)
+    : stream(_stream), chunkSize(chunk_size), maxChunks(max_chunks)
+{
+    fatal_if(max_chunks < 2, "The binary debug logger needs two chunks.");
+
+    writeFileHeader(stream);
+    writer = std::thread([this]() { writeLoop(); });
+    registerExitCallback([this]() { close(); });
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    close();
+}
+
+char *
+BinaryLogger::reserve(ThreadState &thread_state, size_t size)
+{
+    if (closed)
+        return nullptr;
+
+    ChunkState &state = static_cast<ChunkState &>(thread_state);
+    Chunk *chunk = state.chunk;
+    if (chunk && !chunk->data.empty() &&
+        chunk->data.size() + size > chunkSize) {
+        submit(chunk);
+        chunk = nullptr;
+    }
+    if (!chunk) {
+        chunk = getChunk();
+        chunk->kind = RecordChunk;
+        chunk->thread = state.index;
+        state.chunk = chunk;
+    }
+
+    // A record larger than a chunk gets a chunk of its own
+    size_t offset = chunk->data.size();
+    chunk->data.resize(offset + size);
+    return chunk->data.data() + offset;
+}
+
+BinaryLogger::Chunk *
+BinaryLogger::getChunk()
+{
+    std::unique_lock<std::mutex> lock(chunkMutex);
+    if (freeChunks.empty() && chunks.size() >= maxChunks) {
+        // Only wait if a chunk is on its way back.  Otherwise all the
+        // chunks are being filled, some maybe by threads that are done
+        // logging, and waiting could take forever.
+        freeCond.wait(lock, [this]() {
+                return !freeChunks.empty() || !chunksWriting; });
+    }
+    if (freeChunks.empty()) {
+        chunks.emplace_back(new Chunk);
+        chunks.back()->data.reserve(chunkSize);
+        return chunks.back().get();
+    }
+
+    Chunk *chunk = freeChunks.back();
+    freeChunks.pop_back();
+    return chunk;
+}
+
+void
+BinaryLogger::submit(Chunk *chunk)
+{
+    std::lock_guard<std::mutex> string_lock(stringMutex);
+    std::lock_guard<std::mutex> chunk_lock(chunkMutex);
+
+    if (stringsWritten < strings.size()) {
+        // String chunks are rare and small, so they are not recycled
+        Chunk *new_strings = new Chunk;
+        new_strings->kind = StringChunk;
+        new_strings->thread = chunk ? chunk->thread : 0;
+        encodeStrings(new_strings->data, stringsWritten);
+        stringsWritten = strings.size();
+        fullChunks.push_back(new_strings);
+    }
+    if (chunk) {
+        fullChunks.push_back(chunk);
+        ++chunksWriting;
+    }
+    fullCond.notify_one();
+}
+
+void
+BinaryLogger::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(chunkMutex);
+    while (true) {
+        fullCond.wait(lock, [this]() {
+                return stopping || !fullChunks.empty(); });
+        if (fullChunks.empty())
+            break;
+
+        Chunk *chunk = fullChunks.front();
+        fullChunks.pop_front();
+        lock.unlock();
+
+        writeChunk(stream, chunk->kind, chunk->thread, chunk->data.data(),
+                   chunk->data.size());
+
+        lock.lock();
+        if (chunk->kind == StringChunk) {
+            delete chunk;
+        } else {
+            chunk->data.clear();
+            freeChunks.push_back(chunk);
+            --chunksWriting;
+            freeCond.notify_all();
+        }
+    }
+    stream.flush();
+}
+
+void
+BinaryLogger::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    // Called once simulation is over, so no thread is adding records
+    for (auto &thread_state : threads) {
+        ChunkState &state = static_cast<ChunkState &>(*thread_state);
+        if (state.chunk && !state.chunk->data.empty())
+            submit(state.chunk);
+        state.chunk = nullptr;
+    }
+    submit(nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(chunkMutex);
+        stopping = true;
+    }
+    fullCond.notify_one();
+    writer.join();
+}
+
+} // namespace Trace
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_BINARY_TRACE_HH__
+#define __BASE_BINARY_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/trace.hh"
+
+namespace Trace {
+
+/**
+ * Base class of loggers that keep debug messages as binary records and
+ * leave the formatting to util/decode_debug_trace.py.  Object names,
+ * flags and format strings are interned and referred to by ID, and
+ * messages whose arguments are all built-in types (see TraceArgs) are
+ * stored with the raw arguments instead of the formatted text.  Other
+ * messages are formatted as usual and stored with the "%s" format.
+ *
+ * Records are laid out as (uint64 tick, uint32 name id, uint32 flag id,
+ * uint32 format id, uint32 argument size, arguments), and where they go
+ * is up to the subclass.  Traces written to a file look like:
+ *
+ *   char[8]   magic "gem5dbg\0"
+ *   uint32    version
+ *   uint32    byte order mark, 0x01020304 in native order
+ *   chunks:
+ *     uint32  kind, StringChunk or RecordChunk
+ *     uint32  thread index
+ *     uint64  payload size in bytes
+ *     payload
+ *
+ * A StringChunk payload is a list of (uint32 id, uint32 length, chars)
+ * and a RecordChunk payload a list of records.  Strings are always
+ * written before the first chunk that uses them.
+ */
+class RecordLogger : public Logger
+{
+  public:
+    enum ChunkKind : uint32_t
+    {
+        StringChunk,
+        RecordChunk
+    };
+
+    static const uint32_t Version = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+
+        FileHeader();
+    };
+
+    struct ChunkHeader
+    {
+        uint32_t kind;
+        uint32_t thread;
+        /** Size of the payload that follows the header */
+        uint64_t size;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t tick;
+        uint32_t name;
+        uint32_t flag;
+        uint32_t format;
+        /** Size of the arguments that follow the header */
+        uint32_t argsSize;
+    };
+
+    RecordLogger();
+
+    void logMessage(Tick when, const std::string &name,
+            const std::string &flag, const std::string &message) override;
+
+    std::ostream &getOstream() override { return textStream; }
+
+  protected:
+    /** The string IDs known by one simulation thread */
+    struct ThreadState
+    {
+        uint32_t index;
+        std::unordered_map<std::string, uint32_t> names;
+        /** Format strings by address, with their text to catch a
+         *  buffer that got reused for a different string */
+        std::unordered_map<const char *,
+                           std::pair<std::string, uint32_t>> formats;
+
+        virtual ~ThreadState() {}
+    };
+
+    /** Guards strings and threads */
+    std::mutex stringMutex;
+    /** Interned strings by ID */
+    std::vector<std::string> strings;
+    std::vector<std::unique_ptr<ThreadState>> threads;
+
+    void logArgs(Tick when, const std::string &name,
+            const std::string &flag, const char *fmt,
+            const TraceArgs &args) override;
+
+    /** Create the state of a thread that logs its first message */
+    virtual ThreadState *newThreadState() { return new ThreadState; }
+
+    /**
+     * Find room for a record.
+     *
+     * @param state State of the logging thread
+     * @param size Size of the record in bytes
+     * @return Where to put the record, or nullptr to drop it
+     */
+    virtual char *reserve(ThreadState &state, size_t size) = 0;
+
+    static void writeFileHeader(std::ostream &os);
+    static void writeChunk(std::ostream &os, ChunkKind kind,
+                           uint32_t thread, const char *data,
+                           uint64_t size);
+
+    /** Encode strings from ID first on as a StringChunk payload */
+    void encodeStrings(std::vector<char> &data, size_t first);
+
+  private:
+    /** Identifies the logger in the per-thread state cache */
+    const uint64_t serial;
+
+    /** Sends whole lines written to getOstream() to logMessage */
+    class LineBuf : public std::streambuf
+    {
+      private:
+        RecordLogger &logger;
+        std::string line;
+
+      protected:
+        int_type overflow(int_type c) override;
+
+      public:
+        LineBuf(RecordLogger &_logger) : logger(_logger) {}
+    };
+
+    LineBuf textBuf;
+    std::ostream textStream;
+
+    std::unordered_map<std::string, uint32_t> stringIds;
+
+    /** The ID of the format string "%s" for preformatted messages */
+    uint32_t textFormat;
+
+    ThreadState &threadState();
+    uint32_t intern(const std::string &str);
+    uint32_t nameId(ThreadState &state, const std::string &name);
+    uint32_t formatId(ThreadState &state, const char *fmt);
+
+    void writeRecord(Tick when, const std::string &name,
+            const std::string &flag, const char *fmt,
+            const char *args, size_t args_size);
+};
+
+/**
+ * A RecordLogger that streams the trace to a file.  Each thread fills its
+ * own chunk of records without taking a lock.  Full chunks go to a writer
+ * thread, which writes them out and hands them back to be refilled.
+ */
+class BinaryLogger : public RecordLogger
+{
+  public:
+    /**
+     * @param stream Binary stream to write the trace to
+     * @param chunk_size Size of a chunk of records in bytes
+     * @param max_chunks Number of chunks to allocate before threads
+     *                   wait for the writer to hand full ones back;
+     *                   more are allocated if there are more threads
+     *                   filling chunks than that
+     */
+    BinaryLogger(std::ostream &stream, size_t chunk_size = 1 << 20,
+                 unsigned max_chunks = 64);
+    ~BinaryLogger();
+
+    /** Write out all the buffered records and stop the writer */
+    void close();
+
+  protected:
+    char *reserve(ThreadState &state, size_t size) override;
+    ThreadState *newThreadState() override { return new ChunkState; }
+
+  private:
+    struct Chunk
+    {
+        ChunkKind kind;
+        uint32_t thread;
+        std::vector<char> data;
+    };
+
+    struct ChunkState : public ThreadState
+    {
+        Chunk *chunk = nullptr;
+    };
+
+    std::ostream &stream;
+    const size_t chunkSize;
+    const unsigned maxChunks;
+
+    /** Number of strings handed to the writer, guarded by stringMutex */
+    size_t stringsWritten = 0;
+
+    /** Guards the chunk lists and stopping */
+    std::mutex chunkMutex;
+    std::condition_variable fullCond;
+    std::condition_variable freeCond;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk *> freeChunks;
+    std::deque<Chunk *> fullChunks;
+    /** Number of record chunks queued or being written */
+    unsigned chunksWriting = 0;
+    bool stopping = false;
+
+    /** Set once the trace is complete, later messages are dropped */
+    bool closed = false;
+
+    std::thread writer;
+
+    Chunk *getChunk();
+    /** Queue a chunk for writing, after the strings it may use */
+    void submit(Chunk *chunk);
+    void writeLoop();
+};
+
+} // namespace Trace
+
+#endif // __BASE_BINARY_TRACE_HH__
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/binary_trace.hh"
+#include "base/cprintf.hh"
+#include "base/gtest/trace_reader.hh"
+
+using Trace::BinaryLogger;
+using Trace::RecordLogger;
+
+namespace {
+
+struct Unformatted {};
+
+std::ostream &
+operator<<(std::ostream &os, const Unformatted &)
+{
+    return os << "unformatted";
+}
+
+} // anonymous namespace
+
+TEST(BinaryLoggerTest, Empty)
+{
+    std::stringstream ss;
+    {
+        BinaryLogger logger(ss);
+    }
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(1u, reader.chunks.size());
+    EXPECT_EQ(RecordLogger::StringChunk, reader.chunks[0]);
+    EXPECT_EQ(std::vector<std::string>{ "%s" }, reader.strings);
+    EXPECT_TRUE(reader.records.empty());
+}
+
+TEST(BinaryLoggerTest, Records)
+{
+    std::stringstream ss;
+    BinaryLogger logger(ss);
+    logger.dprintf_flag(10, "system.cpu", "Fetch", "pc %#x\n", 0x400u);
+    logger.dprintf(20, "system.mem", "%s %d %c\n", "read", -1, 'x');
+    logger.dprintf_flag(30, "system.cpu", "Exec", "%s\n", Unformatted());
+    logger.getOstream() << "a line" << std::endl;
+    logger.close();
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(4u, reader.records.size());
+
+    const TraceRecord &fetch = reader.records[0];
+    EXPECT_EQ(10u, fetch.tick);
+    EXPECT_EQ("system.cpu", fetch.name);
+    EXPECT_EQ("Fetch", fetch.flag);
+    EXPECT_EQ("pc %#x\n", fetch.format);
+    EXPECT_EQ(encodeTraceArgs(0x400u), fetch.args);
+
+    const TraceRecord &mem = reader.records[1];
+    EXPECT_EQ(20u, mem.tick);
+    EXPECT_EQ("system.mem", mem.name);
+    EXPECT_EQ("", mem.flag);
+    EXPECT_EQ(encodeTraceArgs("read", -1, 'x'), mem.args);
+
+    // Messages with other arguments are formatted where they are logged
+    const TraceRecord &exec = reader.records[2];
+    EXPECT_EQ("%s", exec.format);
+    EXPECT_EQ(encodeTraceArgs("unformatted\n"), exec.args);
+
+    const TraceRecord &line = reader.records[3];
+    EXPECT_EQ(MaxTick, line.tick);
+    EXPECT_EQ("%s", line.format);
+    EXPECT_EQ(encodeTraceArgs("a line\n"), line.args);
+
+    // Everything is interned once
+    EXPECT_EQ(8u, reader.strings.size());
+}
+
+TEST(BinaryLoggerTest, ReusedFormatBuffer)
+{
+    std::stringstream ss;
+    BinaryLogger logger(ss);
+    char fmt[8];
+    strcpy(fmt, "a %d\n");
+    logger.dprintf(0, "obj", fmt, 1);
+    strcpy(fmt, "b %d\n");
+    logger.dprintf(1, "obj", fmt, 2);
+    logger.close();
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(2u, reader.records.size());
+    EXPECT_EQ("a %d\n", reader.records[0].format);
+    EXPECT_EQ("b %d\n", reader.records[1].format);
+}
+
+TEST(BinaryLoggerTest, StringsBeforeRecords)
+{
+    // Small chunks, so new strings keep turning up between record chunks
+    std::stringstream ss;
+    BinaryLogger logger(ss, 128, 2);
+    for (int i = 0; i < 200; ++i) {
+        logger.dprintf_flag(i, csprintf("obj%d", i / 10), "Flag",
+                            "%d\n", i);
+    }
+    logger.close();
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(200u, reader.records.size());
+    for (int i = 0; i < 200; ++i) {
+        const TraceRecord &record = reader.records[i];
+        EXPECT_EQ((uint64_t)i, record.tick);
+        EXPECT_EQ(csprintf("obj%d", i / 10), record.name);
+        EXPECT_EQ(encodeTraceArgs(i), record.args);
+    }
+
+    size_t string_chunks = 0;
+    for (auto kind : reader.chunks)
+        string_chunks += kind == RecordLogger::StringChunk;
+    EXPECT_GT(string_chunks, 1u);
+    EXPECT_GT(reader.chunks.size(), string_chunks + 1);
+}
+
+TEST(BinaryLoggerTest, LargeRecord)
+{
+    std::stringstream ss;
+    BinaryLogger logger(ss, 64, 2);
+    const std::string big(200, 'x');
+    logger.dprintf(0, "obj", "%d\n", 1);
+    logger.dprintf(1, "obj", "%s\n", big);
+    logger.dprintf(2, "obj", "%d\n", 2);
+    logger.close();
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(3u, reader.records.size());
+    EXPECT_EQ(encodeTraceArgs(1), reader.records[0].args);
+    EXPECT_EQ(encodeTraceArgs(big), reader.records[1].args);
+    EXPECT_EQ(encodeTraceArgs(2), reader.records[2].args);
+}
+
+TEST(BinaryLoggerTest, Threads)
+{
+    const int num_threads = 4;
+    const int num_messages = 500;
+
+    // Two chunks are not enough for every thread, so they have to wait
+    // for the writer to hand chunks back
+    std::stringstream ss;
+    BinaryLogger logger(ss, 256, 2);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&logger, t]() {
+            const std::string name = csprintf("thread%d", t);
+            for (int i = 0; i < num_messages; ++i)
+                logger.dprintf(i, name, "%d %d\n", t, i);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    logger.close();
+
+    TraceReader reader(ss.str());
+    ASSERT_EQ(num_threads * num_messages, (int)reader.records.size());
+
+    // The records of each thread are in order and the chunks they are
+    // in are labelled with the same thread index
+    std::map<std::string, uint32_t> indices;
+    std::map<std::string, uint64_t> next;
+    for (const auto &record : reader.records) {
+        auto index = indices.emplace(record.name, record.thread).first;
+        EXPECT_EQ(index->second, record.thread);
+        EXPECT_EQ(next[record.name]++, record.tick);
+    }
+    EXPECT_EQ(num_threads, (int)indices.size());
+    for (const auto &count : next)
+        EXPECT_EQ(num_messages, (int)count.second);
+}
+
+TEST(BinaryLoggerTest, AfterClose)
+{
+    std::stringstream ss;
+    BinaryLogger logger(ss);
+    logger.dprintf(0, "obj", "%d\n", 1);
+    logger.close();
+    const std::string trace = ss.str();
+
+    logger.dprintf(1, "obj", "%d\n", 2);
+    logger.close();
+    EXPECT_EQ(trace, ss.str());
+}
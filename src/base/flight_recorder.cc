@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/flight_recorder.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+
+#include "base/atomicio.hh"
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+
+namespace Trace {
+
+namespace {
+
+/** Set once the simulator is going down and a dump was attempted */
+std::atomic<bool> crashed(false);
+
+} // anonymous namespace
+
+const size_t FlightRecorder::SlotSize;
+FlightRecorder *FlightRecorder::_active = nullptr;
+
+FlightRecorder::FlightRecorder(size_t slots)
+    : numSlots(slots)
+{
+    fatal_if(slots == 0, "The debug flight recorder needs some slots.");
+
+    dirFd = open(simout.directory().c_str(),
+                 O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    warn_if(dirFd < 0, "Can't open the output directory, the flight "
+            "recorder won't be dumped on a crash signal.");
+
+    _active = this;
+    ::Logger::setExitHook([]() { dumpFlightRecorder(true); });
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    if (_active == this)
+        _active = nullptr;
+    if (dirFd >= 0)
+        close(dirFd);
+}
+
+RecordLogger::ThreadState *
+FlightRecorder::newThreadState()
+{
+    Ring *ring = new Ring;
+    ring->data.resize(numSlots * SlotSize);
+    ring->spans.resize(numSlots);
+    return ring;
+}
+
+char *
+FlightRecorder::reserve(ThreadState &state, size_t size)
+{
+    Ring &ring = static_cast<Ring &>(state);
+    const size_t span = divCeil(size, SlotSize);
+    if (span > numSlots)
+        return nullptr;
+
+    if (ring.next + span > numSlots) {
+        // Drop the records at the end of the ring rather than wrap
+        std::fill(ring.spans.begin() + ring.next, ring.spans.end(), 0);
+        ring.next = 0;
+    }
+
+    // This may overwrite the start of a record that continues past the
+    // new one, so that record's slots stop counting as a record
+    const size_t first = ring.next;
+    ring.spans[first] = span;
+    std::fill(ring.spans.begin() + first + 1,
+              ring.spans.begin() + first + span, 0);
+    ring.next = first + span == numSlots ? 0 : first + span;
+
+    return ring.data.data() + first * SlotSize;
+}
+
+template <typename Visit>
+void
+FlightRecorder::visitRecords(const Ring &ring, Visit &&visit) const
+{
+    for (size_t i = 0; i < numSlots; ++i) {
+        const size_t slot = (ring.next + i) % numSlots;
+        const size_t span = ring.spans[slot];
+        if (!span || span > numSlots - slot)
+            continue;
+
+        // A crash may have cut short writing the record
+        const char *record = ring.data.data() + slot * SlotSize;
+        RecordHeader header;
+        memcpy(&header, record, sizeof(header));
+        const size_t size = sizeof(header) + header.argsSize;
+        if (size <= span * SlotSize)
+            visit(record, size);
+    }
+}
+
+template <typename Write>
+void
+FlightRecorder::dump(Write &&write, bool from_signal)
+{
+    auto write_header = [&write](const ChunkHeader &header) {
+        write(reinterpret_cast<const char *>(&header), sizeof(header));
+    };
+
+    const FileHeader file_header;
+    write(reinterpret_cast<const char *>(&file_header),
+          sizeof(file_header));
+
+    // The thread that crashed may hold the lock
+    std::unique_lock<std::mutex> lock(stringMutex, std::defer_lock);
+    if (from_signal)
+        lock.try_lock();
+    else
+        lock.lock();
+
+    if (lock.owns_lock()) {
+        uint64_t size = 0;
+        for (const auto &str : strings)
+            size += 2 * sizeof(uint32_t) + str.size();
+        write_header({ StringChunk, 0, size });
+        for (uint32_t id = 0; id < strings.size(); ++id) {
+            const uint32_t header[] = { id, (uint32_t)strings[id].size() };
+            write(reinterpret_cast<const char *>(header), sizeof(header));
+            write(strings[id].data(), strings[id].size());
+        }
+    }
+
+    for (auto &state : threads) {
+        const Ring &ring = static_cast<const Ring &>(*state);
+        visitRecords(ring, [&](const char *record, size_t size) {
+            write_header({ RecordChunk, ring.index, size });
+            write(record, size);
+        });
+    }
+}
+
+void
+FlightRecorder::dump(std::ostream &os)
+{
+    dump([&os](const char *data, size_t size) { os.write(data, size); },
+         false);
+    os.flush();
+}
+
+bool
+FlightRecorder::dumpFromSignal(const char *name)
+{
+    if (dirFd < 0)
+        return false;
+
+    const int fd = openat(dirFd, name, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return false;
+
+    dump([fd](const char *data, size_t size) {
+            atomic_write(fd, data, size); }, true);
+    close(fd);
+    return true;
+}
+
+bool
+dumpFlightRecorder(bool crash)
+{
+    static std::atomic<unsigned> dumps(0);
+
+    FlightRecorder *recorder = FlightRecorder::active();
+    if (!recorder || (crash && crashed.exchange(true)))
+        return false;
+
+    const std::string name = csprintf("flight_recorder.%d.bin", dumps++);
+    OutputStream *file = simout.create(name, true);
+    recorder->dump(*file->stream());
+    simout.close(file);
+
+    ccprintf(std::cerr, "Debug flight recorder written to %s\n",
+             simout.resolve(name));
+    return true;
+}
+
+void
+dumpFlightRecorderFromSignal()
+{
+    FlightRecorder *recorder = FlightRecorder::active();
+    if (!recorder || crashed.exchange(true))
+        return;
+
+    if (recorder->dumpFromSignal("flight_recorder.crash.bin")) {
+        STATIC_ERR("Debug flight recorder written to "
+                   "flight_recorder.crash.bin in the output directory\n");
+    }
+}
+
+} // namespace Trace
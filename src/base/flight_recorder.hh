@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_FLIGHT_RECORDER_HH__
+#define __BASE_FLIGHT_RECORDER_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "base/binary_trace.hh"
+
+namespace Trace {
+
+/**
+ * A debug logger that keeps the most recent messages of each thread in
+ * a fixed size ring in memory, to find out what led up to a failure
+ * without tracing a whole run to a file.  The rings are written out as a
+ * binary trace (see RecordLogger) by dumpFlightRecorder(), which is
+ * called on panic, fatal and the m5 dumptrace op, and by
+ * dumpFlightRecorderFromSignal() on a crash signal.
+ *
+ * The ring is made of SlotSize byte slots and a record takes as many
+ * whole slots as it needs, which is one for most messages.  Records
+ * never wrap around the end of the ring.  Each record is dumped in a
+ * chunk of its own, so that dumping does not allocate memory.
+ */
+class FlightRecorder : public RecordLogger
+{
+  public:
+    static const size_t SlotSize = 64;
+
+    /**
+     * @param slots Number of slots in the ring of each thread
+     */
+    FlightRecorder(size_t slots);
+    ~FlightRecorder();
+
+    /** Write the messages in the rings, oldest first, to a stream */
+    void dump(std::ostream &os);
+
+    /**
+     * Write the messages to a file in the output directory using only
+     * async-signal-safe calls.  The strings are left out if another
+     * thread is interning one.
+     *
+     * @param name Name of the file
+     * @return Whether the file could be created
+     */
+    bool dumpFromSignal(const char *name);
+
+    /** The flight recorder in use, or nullptr */
+    static FlightRecorder *active() { return _active; }
+
+  protected:
+    char *reserve(ThreadState &state, size_t size) override;
+    ThreadState *newThreadState() override;
+
+  private:
+    struct Ring : public ThreadState
+    {
+        std::vector<char> data;
+        /** Number of slots taken by the record that starts in each
+         *  slot, 0 if no complete record starts there */
+        std::vector<uint32_t> spans;
+        /** The slot to put the next record in */
+        size_t next = 0;
+    };
+
+    const size_t numSlots;
+
+    /** The output directory, opened up front for dumpFromSignal */
+    int dirFd;
+
+    /** Pass each complete record of a ring, oldest first, to visit */
+    template <typename Visit>
+    void visitRecords(const Ring &ring, Visit &&visit) const;
+
+    /**
+     * Write the trace with write(data, size).
+     *
+     * @param from_signal Leave out the strings rather than wait for the
+     *                    lock that guards them
+     */
+    template <typename Write>
+    void dump(Write &&write, bool from_signal);
+
+    static FlightRecorder *_active;
+};
+
+/**
+ * Dump the active flight recorder, if any, to a new file in the output
+ * directory.
+ *
+ * @param crash Set when the simulator is going down, only the first
+ *              crash dump is written
+ * @return Whether the recorder was dumped
+ */
+bool dumpFlightRecorder(bool crash = false);
+
+/**
+ * Dump the active flight recorder, if any, to flight_recorder.crash.bin
+ * in the output directory from a crash signal handler, unless a crash
+ * dump was already written.
+ */
+void dumpFlightRecorderFromSignal();
+
+} // namespace Trace
+
+#endif // __BASE_FLIGHT_RECORDER_HH__
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/flight_recorder.hh"
+#include "base/gtest/trace_reader.hh"
+#include "base/output.hh"
+
+using Trace::FlightRecorder;
+
+namespace {
+
+class TestRecorder : public FlightRecorder
+{
+  public:
+    using FlightRecorder::FlightRecorder;
+    using FlightRecorder::stringMutex;
+
+    /** Log a message with its tick as the argument */
+    void log(Tick when) { dprintf(when, "obj", "%d\n", when); }
+
+    /** Log a message that takes three slots */
+    void
+    logLarge(Tick when)
+    {
+        dprintf(when, "obj", "%s\n", std::string(100, 'x'));
+    }
+
+    std::vector<Tick>
+    ticks()
+    {
+        std::stringstream ss;
+        dump(ss);
+        std::vector<Tick> ticks;
+        for (const auto &record : TraceReader(ss.str()).records)
+            ticks.push_back(record.tick);
+        return ticks;
+    }
+};
+
+class FlightRecorderTest : public testing::Test
+{
+  protected:
+    static std::string dir;
+
+    static void
+    SetUpTestCase()
+    {
+        const char *tmp = std::getenv("TMPDIR");
+        dir = std::string(tmp ? tmp : "/tmp") +
+            "/flight_recorder.test.XXXXXX";
+        ASSERT_NE(mkdtemp(&dir[0]), nullptr);
+        simout.setDirectory(dir);
+    }
+
+    static void
+    TearDownTestCase()
+    {
+        rmdir(dir.c_str());
+    }
+};
+
+std::string FlightRecorderTest::dir;
+
+} // anonymous namespace
+
+TEST_F(FlightRecorderTest, NotFull)
+{
+    TestRecorder recorder(8);
+    for (Tick i = 0; i < 3; ++i)
+        recorder.log(i);
+    EXPECT_EQ(std::vector<Tick>({ 0, 1, 2 }), recorder.ticks());
+}
+
+TEST_F(FlightRecorderTest, Wraparound)
+{
+    TestRecorder recorder(4);
+    for (Tick i = 0; i < 10; ++i)
+        recorder.log(i);
+    EXPECT_EQ(std::vector<Tick>({ 6, 7, 8, 9 }), recorder.ticks());
+}
+
+TEST_F(FlightRecorderTest, MultiSlotRecord)
+{
+    TestRecorder recorder(8);
+    recorder.log(0);
+    recorder.logLarge(1);
+    recorder.log(2);
+
+    std::stringstream ss;
+    recorder.dump(ss);
+    TraceReader reader(ss.str());
+    ASSERT_EQ(3u, reader.records.size());
+    EXPECT_EQ(encodeTraceArgs((Tick)0), reader.records[0].args);
+    EXPECT_EQ(encodeTraceArgs(std::string(100, 'x')),
+              reader.records[1].args);
+    EXPECT_EQ(encodeTraceArgs((Tick)2), reader.records[2].args);
+}
+
+TEST_F(FlightRecorderTest, MultiSlotRecordDoesNotWrap)
+{
+    // The large record doesn't fit in the last two slots, so it goes at
+    // the start and takes the place of the first two records
+    TestRecorder recorder(4);
+    recorder.log(0);
+    recorder.log(1);
+    recorder.logLarge(2);
+    EXPECT_EQ(std::vector<Tick>({ 2 }), recorder.ticks());
+
+    recorder.log(3);
+    EXPECT_EQ(std::vector<Tick>({ 2, 3 }), recorder.ticks());
+}
+
+TEST_F(FlightRecorderTest, MultiSlotRecordOverwritten)
+{
+    // Overwriting the first slot of a record drops all of it
+    TestRecorder recorder(4);
+    recorder.logLarge(0);
+    recorder.log(1);
+    recorder.log(2);
+    EXPECT_EQ(std::vector<Tick>({ 1, 2 }), recorder.ticks());
+}
+
+TEST_F(FlightRecorderTest, TooLarge)
+{
+    TestRecorder recorder(2);
+    recorder.log(0);
+    recorder.logLarge(1);
+    recorder.log(2);
+    EXPECT_EQ(std::vector<Tick>({ 0, 2 }), recorder.ticks());
+}
+
+TEST_F(FlightRecorderTest, Threads)
+{
+    TestRecorder recorder(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&recorder, t]() {
+            for (Tick i = 0; i < 10; ++i)
+                recorder.log(t * 100 + i);
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    std::stringstream ss;
+    recorder.dump(ss);
+    TraceReader reader(ss.str());
+    ASSERT_EQ(8u, reader.records.size());
+    for (int i = 0; i < 8; ++i) {
+        const TraceRecord &record = reader.records[i];
+        const Tick base = record.tick < 100 ? 0 : 100;
+        EXPECT_EQ(reader.records[i / 4 * 4].thread, record.thread);
+        EXPECT_EQ(base + 6 + i % 4, record.tick);
+    }
+    EXPECT_NE(reader.records[0].thread, reader.records[4].thread);
+}
+
+TEST_F(FlightRecorderTest, DumpFromSignal)
+{
+    TestRecorder recorder(4);
+    for (Tick i = 0; i < 6; ++i)
+        recorder.log(i);
+
+    std::stringstream expected;
+    recorder.dump(expected);
+
+    ASSERT_TRUE(recorder.dumpFromSignal("signal.bin"));
+    const std::string path = simout.resolve("signal.bin");
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    EXPECT_EQ(expected.str(), ss.str());
+    std::remove(path.c_str());
+}
+
+TEST_F(FlightRecorderTest, DumpFromSignalWithoutStrings)
+{
+    TestRecorder recorder(4);
+    for (Tick i = 0; i < 6; ++i)
+        recorder.log(i);
+
+    // Another thread holds the string lock, so the strings are skipped
+    // rather than waited for
+    recorder.stringMutex.lock();
+    bool dumped = false;
+    std::thread([&]() {
+        dumped = recorder.dumpFromSignal("signal.bin");
+    }).join();
+    recorder.stringMutex.unlock();
+    ASSERT_TRUE(dumped);
+
+    const std::string path = simout.resolve("signal.bin");
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    std::remove(path.c_str());
+
+    TraceReader reader(ss.str(), false);
+    EXPECT_TRUE(reader.strings.empty());
+    ASSERT_EQ(4u, reader.records.size());
+    for (Tick i = 0; i < 4; ++i) {
+        EXPECT_EQ(i + 2, reader.records[i].tick);
+        EXPECT_EQ(encodeTraceArgs(i + 2), reader.records[i].args);
+    }
+}
@@ -75,6 +75,11 @@ GTestLogger hackLogger("hack: ");
 
 } // anonymous namespace
 
+// Panics and fatals are expected by some of the tests, so nothing that
+// is meant to help debugging a dying simulator is run.
+void Logger::setExitHook(void (*hook)()) {}
+void Logger::runExitHook() {}
+
 Logger &Logger::getPanic() { return panicLogger; }
 Logger &Logger::getFatal() { return fatalLogger; }
 Logger &Logger::getWarn() { return warnLogger; }
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_GTEST_TRACE_READER_HH__
+#define __BASE_GTEST_TRACE_READER_HH__
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/binary_trace.hh"
+#include "base/trace_args.hh"
+
+/** A record read back from a binary trace, with its strings resolved */
+struct TraceRecord
+{
+    uint32_t thread;
+    uint64_t tick;
+    std::string name;
+    std::string flag;
+    std::string format;
+    std::string args;
+};
+
+/**
+ * Reads a whole binary trace (see Trace::RecordLogger), checking that
+ * every string is defined before the first record that uses it.
+ */
+class TraceReader
+{
+  private:
+    typedef Trace::RecordLogger RecordLogger;
+
+    std::string data;
+    size_t offset = 0;
+    const bool stringsRequired;
+
+    template <typename T>
+    T
+    get()
+    {
+        T value;
+        EXPECT_LE(offset + sizeof(value), data.size());
+        memcpy(&value, data.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+
+    std::string
+    string(uint32_t id)
+    {
+        if (id < strings.size())
+            return strings[id];
+        EXPECT_FALSE(stringsRequired) << "String used before its chunk";
+        return "";
+    }
+
+    void
+    read()
+    {
+        EXPECT_EQ(0, memcmp(data.data(), "gem5dbg", 8));
+        offset = 8;
+        EXPECT_EQ(RecordLogger::Version, get<uint32_t>());
+        EXPECT_EQ(0x01020304u, get<uint32_t>());
+
+        while (offset < data.size()) {
+            const auto header = get<RecordLogger::ChunkHeader>();
+            const size_t end = header.size + offset;
+            ASSERT_LE(end, data.size());
+            chunks.push_back((RecordLogger::ChunkKind)header.kind);
+
+            while (offset < end) {
+                if (header.kind == RecordLogger::StringChunk) {
+                    const uint32_t id = get<uint32_t>();
+                    const uint32_t size = get<uint32_t>();
+                    // Strings are numbered in the order they are written
+                    EXPECT_EQ(strings.size(), id);
+                    strings.emplace_back(data.data() + offset, size);
+                    offset += size;
+                } else {
+                    ASSERT_EQ(RecordLogger::RecordChunk, header.kind);
+                    const auto record = get<RecordLogger::RecordHeader>();
+                    records.push_back({ header.thread, record.tick,
+                            string(record.name), string(record.flag),
+                            string(record.format),
+                            data.substr(offset, record.argsSize) });
+                    offset += record.argsSize;
+                }
+            }
+            EXPECT_EQ(end, offset);
+        }
+    }
+
+  public:
+    std::vector<std::string> strings;
+    std::vector<RecordLogger::ChunkKind> chunks;
+    std::vector<TraceRecord> records;
+
+    /**
+     * @param _data The trace
+     * @param strings_required Whether strings may be missing, as they
+     *                         are from some flight recorder dumps
+     */
+    TraceReader(const std::string &_data, bool strings_required=true)
+        : data(_data), stringsRequired(strings_required)
+    {
+        read();
+    }
+};
+
+/** The arguments of a message as the loggers encode them */
+template <typename ...Args>
+std::string
+encodeTraceArgs(const Args &...args)
+{
+    Trace::TraceArgs encoded;
+    encoded.add(args...);
+    return std::string(encoded.data(), encoded.size());
+}
+
+#endif // __BASE_GTEST_TRACE_READER_HH__
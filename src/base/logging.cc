@@ -85,8 +85,26 @@ NormalLogger warnLogger("warn: ");
 NormalLogger infoLogger("info: ");
 NormalLogger hackLogger("hack: ");
 
+void (*exitHook)() = nullptr;
+
 } // anonymous namespace
 
+void
+Logger::setExitHook(void (*hook)())
+{
+    exitHook = hook;
+}
+
+void
+Logger::runExitHook()
+{
+    // Clear the hook first in case it fails itself
+    auto hook = exitHook;
+    exitHook = nullptr;
+    if (hook)
+        hook();
+}
+
 Logger &Logger::getPanic() { return panicLogger; }
 Logger &Logger::getFatal() { return fatalLogger; }
 Logger &Logger::getWarn() { return warnLogger; }
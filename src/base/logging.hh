@@ -121,7 +121,13 @@ class Logger
      * functions, and gcc will get mad if a function calls panic and then
      * doesn't return.
      */
-    void exit_helper() M5_ATTR_NORETURN { exit(); ::abort(); }
+    void exit_helper() M5_ATTR_NORETURN { runExitHook(); exit(); ::abort(); }
+
+    /**
+     * Set a function to call when a panic or fatal is about to end the
+     * process, e.g. to save state that helps debugging.
+     */
+    static void setExitHook(void (*hook)());
 
   protected:
     bool enabled;
@@ -129,6 +135,8 @@ class Logger
     virtual void log(const Loc &loc, std::string s) = 0;
     virtual void exit() { /* Fall through to the abort in exit_helper. */ }
 
+    static void runExitHook();
+
     const char *prefix;
 };
 
@@ -60,6 +60,8 @@ using namespace std;
 
 namespace Stats {
 
+thread_local unsigned threadShard = 0;
+
 std::string Info::separatorString = "::";
 
 // We wrap these in a function to make sure they're built in time.
@@ -84,12 +86,14 @@ InfoAccess::setInfo(Group *parent, Info *info)
              _info != nullptr,
              "shouldn't register stat twice!");
 
+    // Keep the info at hand for all stats, looking legacy stats up in
+    // the map on every reset or prepare is slow with many stats.
+    _info = info;
+
     // New-style stats are reachable through the hierarchy and
     // shouldn't be added to the global lists.
-    if (parent) {
-        _info = info;
+    if (parent)
         return;
-    }
 
     statsList().push_back(info);
 
@@ -113,34 +117,6 @@ InfoAccess::setInit()
     info()->flags.set(init);
 }
 
-Info *
-InfoAccess::info()
-{
-    if (_info) {
-        // New-style stats
-        return _info;
-    } else {
-        // Legacy stats
-        MapType::const_iterator i = statsMap().find(this);
-        assert(i != statsMap().end());
-        return (*i).second;
-    }
-}
-
-const Info *
-InfoAccess::info() const
-{
-    if (_info) {
-        // New-style stats
-        return _info;
-    } else {
-        // Legacy stats
-        MapType::const_iterator i = statsMap().find(this);
-        assert(i != statsMap().end());
-        return (*i).second;
-    }
-}
-
 StorageParams::~StorageParams()
 {
 }
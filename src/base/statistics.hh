@@ -192,9 +192,9 @@ class InfoAccess
     void setInit();
 
     /** Grab the information class for this statistic */
-    Info *info();
+    Info *info() { return _info; }
     /** Grab the information class for this statistic */
-    const Info *info() const;
+    const Info *info() const { return _info; }
 
   public:
     InfoAccess()
@@ -705,6 +705,11 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
         this->doInit();
     }
 
+    ~ScalarBase()
+    {
+        data()->~Storage();
+    }
+
   public:
     // Common operators for stats
     /**
@@ -1864,6 +1869,176 @@ class AvgSampleStor
     }
 };
 
+/**
+ * Maximum number of simulation threads that can update a sharded stat.
+ * The simulation loop refuses to run event queues with a higher index.
+ */
+const unsigned MaxShards = 64;
+
+/**
+ * Shard used by the calling thread when updating sharded stats. The
+ * simulation loop sets this to the index of the event queue the thread
+ * services, so the main thread uses shard 0.
+ */
+extern thread_local unsigned threadShard;
+
+/**
+ * Storage that keeps a private copy of another storage type for each
+ * simulation thread. Updates only touch the calling thread's copy, so
+ * a stat shared by objects on different event queues can be updated
+ * without locks or races. The copies are merged when the stat is read,
+ * prepared or reset, which only happens while the simulation threads
+ * are synchronized.
+ *
+ * Copies are allocated by their thread on first use and padded to keep
+ * them on separate cache lines. Setting a sharded stat is not thread
+ * safe. Supports StatStor, AvgStor and DistStor.
+ */
+template <class Stor>
+class ShardedStor
+{
+  public:
+    typedef typename Stor::Params Params;
+
+  private:
+    /** A copy of the storage, padded against false sharing */
+    struct Shard
+    {
+        char padBefore[64];
+        Stor stor;
+        char padAfter[64];
+
+        Shard(Info *info) : stor(info) { }
+    };
+
+    /** The info of the stat, needed to create new copies */
+    Info *statInfo;
+
+    /** Per-thread copies. Shard 0 always exists. */
+    std::unique_ptr<Shard> shards[MaxShards];
+
+    /** Create the calling thread's copy */
+    Stor *
+    makeShard()
+    {
+        assert(threadShard < MaxShards);
+        shards[threadShard].reset(new Shard(statInfo));
+        return &shards[threadShard]->stor;
+    }
+
+    /** Get the calling thread's copy */
+    Stor *
+    local()
+    {
+        Shard *shard = shards[threadShard].get();
+        return shard ? &shard->stor : makeShard();
+    }
+
+  public:
+    ShardedStor(Info *info)
+        : statInfo(info)
+    {
+        shards[0].reset(new Shard(info));
+    }
+
+    void
+    set(Counter val)
+    {
+        for (auto &shard : shards) {
+            if (shard)
+                shard->stor.reset(statInfo);
+        }
+        local()->set(val);
+    }
+
+    void inc(Counter val) { local()->inc(val); }
+    void dec(Counter val) { local()->dec(val); }
+    void sample(Counter val, int number) { local()->sample(val, number); }
+
+    Counter
+    value() const
+    {
+        Counter total = Counter();
+        for (const auto &shard : shards) {
+            if (shard)
+                total += shard->stor.value();
+        }
+        return total;
+    }
+
+    Result
+    result() const
+    {
+        Result total = 0.0;
+        for (const auto &shard : shards) {
+            if (shard)
+                total += shard->stor.result();
+        }
+        return total;
+    }
+
+    size_type size() const { return shards[0]->stor.size(); }
+
+    bool
+    zero() const
+    {
+        for (const auto &shard : shards) {
+            if (shard && !shard->stor.zero())
+                return false;
+        }
+        return true;
+    }
+
+    void
+    prepare(Info *info)
+    {
+        for (auto &shard : shards) {
+            if (shard)
+                shard->stor.prepare(info);
+        }
+    }
+
+    /** Merge the distributions of all the copies */
+    void
+    prepare(Info *info, DistData &data)
+    {
+        shards[0]->stor.prepare(info, data);
+        bool empty = shards[0]->stor.zero();
+
+        DistData part;
+        for (off_type i = 1; i < MaxShards; ++i) {
+            if (!shards[i] || shards[i]->stor.zero())
+                continue;
+
+            shards[i]->stor.prepare(info, part);
+            if (empty) {
+                data.min_val = part.min_val;
+                data.max_val = part.max_val;
+                empty = false;
+            } else {
+                data.min_val = std::min(data.min_val, part.min_val);
+                data.max_val = std::max(data.max_val, part.max_val);
+            }
+            data.underflow += part.underflow;
+            data.overflow += part.overflow;
+            for (off_type j = 0; j < data.cvec.size(); ++j)
+                data.cvec[j] += part.cvec[j];
+            data.sum += part.sum;
+            data.squares += part.squares;
+            data.samples += part.samples;
+        }
+    }
+
+    void
+    reset(Info *info)
+    {
+        for (auto &shard : shards) {
+            if (shard)
+                shard->stor.reset(info);
+        }
+    }
+};
+
 /**
  * Implementation of a distribution stat. The type of distribution is
  * determined by the Storage template. @sa ScalarBase
@@ -1914,6 +2089,13 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
     {
     }
 
+    ~DistBase()
+    {
+        // The storage is only constructed once the parameters are set
+        if (this->info()->flags.isSet(init))
+            data()->~Storage();
+    }
+
     /**
      * Add a value to the distribtion n times. Calls sample on the storage
      * class.
@@ -2542,6 +2724,22 @@ class Scalar : public ScalarBase<Scalar, StatStor>
     }
 };
 
+/**
+ * A scalar stat that can be updated from several simulation threads.
+ * @sa Stat, ScalarBase, ShardedStor
+ */
+class ShardedScalar : public ScalarBase<ShardedScalar, ShardedStor<StatStor>>
+{
+  public:
+    using ScalarBase<ShardedScalar, ShardedStor<StatStor>>::operator=;
+
+    ShardedScalar(Group *parent = nullptr, const char *name = nullptr,
+                  const char *desc = nullptr)
+        : ScalarBase<ShardedScalar, ShardedStor<StatStor>>(parent, name, desc)
+    {
+    }
+};
+
 /**
  * A stat that calculates the per tick average of a value.
  * @sa Stat, ScalarBase, AvgStor
@@ -2582,6 +2780,21 @@ class Vector : public VectorBase<Vector, StatStor>
     }
 };
 
+/**
+ * A vector of scalar stats that can be updated from several simulation
+ * threads.
+ * @sa Stat, VectorBase, ShardedStor
+ */
+class ShardedVector : public VectorBase<ShardedVector, ShardedStor<StatStor>>
+{
+  public:
+    ShardedVector(Group *parent = nullptr, const char *name = nullptr,
+                  const char *desc = nullptr)
+        : VectorBase<ShardedVector, ShardedStor<StatStor>>(parent, name, desc)
+    {
+    }
+};
+
 /**
  * A vector of Average stats.
  * @sa Stat, VectorBase, AvgStor
@@ -2647,6 +2860,44 @@ class Distribution : public DistBase<Distribution, DistStor>
     }
 };
 
+/**
+ * A simple distribution stat that can be sampled from several simulation
+ * threads.
+ * @sa Stat, DistBase, ShardedStor, DistStor
+ */
+class ShardedDistribution
+    : public DistBase<ShardedDistribution, ShardedStor<DistStor>>
+{
+  public:
+    ShardedDistribution(Group *parent = nullptr, const char *name = nullptr,
+                        const char *desc = nullptr)
+        : DistBase<ShardedDistribution, ShardedStor<DistStor>>(
+            parent, name, desc)
+    {
+    }
+
+    /**
+     * Set the parameters of this distribution. @sa Distribution::init
+     * @param min The minimum value of the distribution.
+     * @param max The maximum value of the distribution.
+     * @param bkt The number of values in each bucket.
+     * @return A reference to this distribution.
+     */
+    ShardedDistribution &
+    init(Counter min, Counter max, Counter bkt)
+    {
+        DistStor::Params *params = new DistStor::Params;
+        params->min = min;
+        params->max = max;
+        params->bucket_size = bkt;
+        assert(bkt > 0);
+        params->buckets = (size_type)ceil((max - min + 1.0) / bkt);
+        this->setParams(params);
+        this->doInit();
+        return this->self();
+    }
+};
+
 /**
  * A simple histogram stat.
  * @sa Stat, DistBase, HistStor
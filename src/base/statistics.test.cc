@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "base/statistics.hh"
+
+namespace {
+
+/** Switch the shard used by the calling thread for the life time */
+class ShardScope
+{
+  public:
+    ShardScope(unsigned shard) : saved(Stats::threadShard)
+    {
+        Stats::threadShard = shard;
+    }
+
+    ~ShardScope() { Stats::threadShard = saved; }
+
+  private:
+    const unsigned saved;
+};
+
+class TestDistribution : public Stats::ShardedDistribution
+{
+  public:
+    using Stats::ShardedDistribution::ShardedDistribution;
+
+    /** Merge the shards and return the result */
+    const Stats::DistData &
+    prepared()
+    {
+        prepare();
+        return static_cast<const Stats::DistInfo *>(info())->data;
+    }
+};
+
+} // anonymous namespace
+
+// The stats belong to a group, which keeps them out of the global stat
+// list and map. A legacy stat can't be registered at the address of a
+// destroyed one.
+
+TEST(ShardedStats, ScalarMerge)
+{
+    Stats::Group group(nullptr);
+    Stats::ShardedScalar scalar(&group, "scalar", "");
+    EXPECT_TRUE(scalar.zero());
+
+    scalar += 2;
+    {
+        ShardScope shard(1);
+        scalar++;
+        scalar++;
+    }
+    {
+        ShardScope shard(Stats::MaxShards - 1);
+        scalar += 10;
+        scalar--;
+    }
+
+    EXPECT_FALSE(scalar.zero());
+    EXPECT_EQ(scalar.value(), 13);
+    EXPECT_EQ(scalar.result(), 13.0);
+}
+
+TEST(ShardedStats, ScalarReset)
+{
+    Stats::Group group(nullptr);
+    Stats::ShardedScalar scalar(&group, "scalar", "");
+    scalar += 5;
+    {
+        ShardScope shard(3);
+        scalar += 7;
+    }
+
+    scalar.reset();
+    EXPECT_TRUE(scalar.zero());
+    EXPECT_EQ(scalar.value(), 0);
+
+    // Shards stay usable after a reset
+    {
+        ShardScope shard(3);
+        scalar += 4;
+    }
+    EXPECT_EQ(scalar.value(), 4);
+}
+
+TEST(ShardedStats, ScalarSet)
+{
+    Stats::Group group(nullptr);
+    Stats::ShardedScalar scalar(&group, "scalar", "");
+    {
+        ShardScope shard(2);
+        scalar += 7;
+    }
+
+    // Setting replaces the contributions of all the shards
+    scalar = 3;
+    EXPECT_EQ(scalar.value(), 3);
+}
+
+TEST(ShardedStats, VectorMerge)
+{
+    Stats::Group group(nullptr);
+    Stats::ShardedVector vector(&group, "vector", "");
+    vector.init(3);
+
+    vector[0] += 1;
+    vector[2] += 2;
+    {
+        ShardScope shard(4);
+        vector[0] += 10;
+        vector[1] += 20;
+    }
+
+    EXPECT_EQ(vector.size(), 3u);
+    EXPECT_EQ(vector[0].value(), 11);
+    EXPECT_EQ(vector[1].value(), 20);
+    EXPECT_EQ(vector[2].value(), 2);
+    EXPECT_EQ(vector.total(), 33.0);
+
+    vector.reset();
+    EXPECT_EQ(vector[0].value(), 0);
+    EXPECT_EQ(vector[1].value(), 0);
+    EXPECT_EQ(vector.total(), 0.0);
+}
+
+TEST(ShardedStats, DistributionMerge)
+{
+    Stats::Group group(nullptr);
+    TestDistribution dist(&group, "dist", "");
+    dist.init(0, 9, 2);
+
+    dist.sample(1);
+    dist.sample(4, 2);
+    {
+        ShardScope shard(5);
+        dist.sample(-1);
+        dist.sample(5);
+        dist.sample(12);
+    }
+
+    const Stats::DistData &data = dist.prepared();
+    EXPECT_EQ(data.samples, 6);
+    EXPECT_EQ(data.sum, 1 + 4 * 2 - 1 + 5 + 12);
+    EXPECT_EQ(data.squares, 1 + 16 * 2 + 1 + 25 + 144);
+    EXPECT_EQ(data.min_val, -1);
+    EXPECT_EQ(data.max_val, 12);
+    EXPECT_EQ(data.underflow, 1);
+    EXPECT_EQ(data.overflow, 1);
+    ASSERT_EQ(data.cvec.size(), 5u);
+    EXPECT_EQ(data.cvec[0], 1);
+    EXPECT_EQ(data.cvec[1], 0);
+    EXPECT_EQ(data.cvec[2], 3);
+    EXPECT_EQ(data.cvec[3], 0);
+    EXPECT_EQ(data.cvec[4], 0);
+
+    dist.reset();
+    EXPECT_TRUE(dist.zero());
+    EXPECT_EQ(dist.prepared().samples, 0);
+}
+
+TEST(ShardedStats, DistributionEmptyMainShard)
+{
+    Stats::Group group(nullptr);
+    TestDistribution dist(&group, "dist", "");
+    dist.init(0, 9, 1);
+
+    // The main thread's shard has no samples, so the minimum and
+    // maximum come from the other shards only.
+    {
+        ShardScope shard(1);
+        dist.sample(3);
+    }
+    {
+        ShardScope shard(2);
+        dist.sample(7);
+    }
+
+    const Stats::DistData &data = dist.prepared();
+    EXPECT_EQ(data.samples, 2);
+    EXPECT_EQ(data.min_val, 3);
+    EXPECT_EQ(data.max_val, 7);
+    EXPECT_EQ(data.cvec[3], 1);
+    EXPECT_EQ(data.cvec[7], 1);
+}
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <cstring>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+
+namespace Stats {
+
+namespace {
+
+/**
+ * Column names for a vector stat, or no names if the stat doesn't
+ * have any subnames.
+ */
+std::vector<std::string>
+columnNames(const std::vector<std::string> &subnames, size_t size)
+{
+    std::vector<std::string> names;
+    bool any = false;
+    for (const auto &s : subnames) {
+        if (!s.empty()) {
+            any = true;
+            break;
+        }
+    }
+    if (!any)
+        return names;
+
+    names.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        if (i < subnames.size() && !subnames[i].empty())
+            names[i] = subnames[i];
+        else
+            names[i] = std::to_string(i);
+    }
+    return names;
+}
+
+/** Bitwise comparison so that NaNs compare equal to themselves */
+bool
+sameValue(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // anonymous namespace
+
+const uint32_t Columnar::version;
+
+Columnar::Columnar(const std::string &file, bool changed, bool desc,
+                   bool flush_dumps)
+    : fname(file), onlyChanged(changed), enableDescriptions(desc),
+      flushDumps(flush_dumps), file(nullptr), stream(nullptr),
+      dumpCount(0), statIndex(0)
+{
+}
+
+Columnar::~Columnar()
+{
+    if (file)
+        simout.close(file);
+}
+
+void
+Columnar::begin()
+{
+    if (!file) {
+        // The file must not be compressed for readers to be able to
+        // memory map it.
+        file = simout.create(fname, true, true);
+        stream = file->stream();
+    }
+
+    statIndex = 0;
+    values.clear();
+}
+
+void
+Columnar::end()
+{
+    assert(valid());
+    assert(path.empty());
+
+    if (dumpCount == 0) {
+        writeSchema();
+        schema.clear();
+    } else if (statIndex != statColumns.size()) {
+        panic("%s: Dump %d has %d stats, the schema has %d\n", fname,
+              dumpCount, statIndex, statColumns.size());
+    }
+
+    writeRecord();
+    if (flushDumps)
+        stream->flush();
+
+    lastValues.swap(values);
+    dumpCount++;
+}
+
+bool
+Columnar::valid() const
+{
+    return true;
+}
+
+void
+Columnar::flush()
+{
+    if (stream)
+        stream->flush();
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push(name);
+    else
+        path.push(csprintf("%s.%s", path.top(), name));
+}
+
+void
+Columnar::endGroup()
+{
+    assert(!path.empty());
+    path.pop();
+}
+
+bool
+Columnar::include(const Info &info) const
+{
+    // Unlike the text output, don't look at prereqs. The set of stats
+    // has to be the same in every dump.
+    return info.flags.isSet(display);
+}
+
+std::string
+Columnar::statName(const std::string &name) const
+{
+    if (path.empty())
+        return name;
+    else
+        return csprintf("%s.%s", path.top(), name);
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (!include(info))
+        return;
+
+    appendStat(info.name, info.desc, ScalarStat, { info.result() }, {});
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (!include(info))
+        return;
+
+    appendVector(info, VectorStat);
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (!include(info))
+        return;
+
+    static const std::vector<std::string> summary_names = {
+        "samples", "sum", "squares", "min_value", "max_value",
+        "underflows", "overflows", "min", "bucket_size",
+    };
+
+    const DistData &data = info.data;
+    std::vector<double> dist_values = {
+        data.samples, data.sum, data.squares, data.min_val, data.max_val,
+        data.underflow, data.overflow, data.min, data.bucket_size,
+    };
+    dist_values.insert(dist_values.end(), data.cvec.begin(), data.cvec.end());
+
+    std::vector<std::string> names;
+    if (dumpCount == 0) {
+        names = summary_names;
+        for (size_t i = 0; i < data.cvec.size(); ++i)
+            names.push_back(std::to_string(i));
+    }
+
+    appendStat(info.name, info.desc, DistStat, dist_values, names);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    warn_once("Columnar stat files don't support vector distributions.\n");
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (!include(info))
+        return;
+
+    std::vector<std::string> names;
+    if (dumpCount == 0) {
+        auto x_names = columnNames(info.subnames, info.x);
+        auto y_names = columnNames(info.y_subnames, info.y);
+        if (!x_names.empty() || !y_names.empty()) {
+            for (size_t i = 0; i < info.x; ++i) {
+                for (size_t j = 0; j < info.y; ++j) {
+                    names.push_back(csprintf("%s::%s",
+                        x_names.empty() ? std::to_string(i) : x_names[i],
+                        y_names.empty() ? std::to_string(j) : y_names[j]));
+                }
+            }
+        }
+    }
+
+    appendStat(info.name, info.desc, Vector2dStat,
+               std::vector<double>(info.cvec.begin(), info.cvec.end()),
+               names);
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    if (!include(info))
+        return;
+
+    appendVector(info, FormulaStat);
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Columnar stat files don't support sparse histograms.\n");
+}
+
+void
+Columnar::appendVector(const VectorInfo &info, StatType type)
+{
+    const VResult &vr = info.result();
+    std::vector<std::string> names;
+    if (dumpCount == 0)
+        names = columnNames(info.subnames, vr.size());
+
+    appendStat(info.name, info.desc, type,
+               std::vector<double>(vr.begin(), vr.end()), names);
+}
+
+void
+Columnar::appendStat(const std::string &name, const std::string &desc,
+                     StatType type, const std::vector<double> &stat_values,
+                     const std::vector<std::string> &names)
+{
+    if (dumpCount == 0) {
+        schema.push_back({ type, statName(name),
+                           enableDescriptions ? desc : "", names });
+        statColumns.push_back(stat_values.size());
+    } else if (statIndex >= statColumns.size() ||
+               statColumns[statIndex] != stat_values.size()) {
+        panic("%s: Stat %s doesn't match the schema written in the "
+              "first dump\n", fname, statName(name));
+    }
+
+    values.insert(values.end(), stat_values.begin(), stat_values.end());
+    statIndex++;
+}
+
+void
+Columnar::writeWord(uint32_t value)
+{
+    stream->write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void
+Columnar::writeString(const std::string &str)
+{
+    writeWord(str.size());
+    stream->write(str.data(), str.size());
+}
+
+void
+Columnar::pad()
+{
+    static const char zeros[8] = {};
+    auto offset = stream->tellp();
+    if (offset % 8)
+        stream->write(zeros, 8 - offset % 8);
+}
+
+void
+Columnar::writeSchema()
+{
+    static const char magic[8] = "gem5col";
+    stream->write(magic, sizeof(magic));
+    writeWord(version);
+    writeWord(onlyChanged ? 1 : 0);
+
+    writeWord(schema.size());
+    writeWord(values.size());
+    for (size_t i = 0; i < schema.size(); ++i) {
+        const StatSchema &stat = schema[i];
+        writeWord(stat.type);
+        writeWord(statColumns[i]);
+        writeString(stat.name);
+        writeString(stat.desc);
+        writeWord(stat.names.size());
+        for (const auto &name : stat.names)
+            writeString(name);
+    }
+    pad();
+}
+
+void
+Columnar::writeRecord()
+{
+    if (!onlyChanged || dumpCount == 0) {
+        writeWord(FullRecord);
+        writeWord(values.size());
+        stream->write(reinterpret_cast<const char *>(values.data()),
+                      values.size() * sizeof(double));
+        return;
+    }
+
+    assert(values.size() == lastValues.size());
+    changedColumns.clear();
+    changedValues.clear();
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!sameValue(values[i], lastValues[i])) {
+            changedColumns.push_back(i);
+            changedValues.push_back(values[i]);
+        }
+    }
+
+    writeWord(DeltaRecord);
+    writeWord(changedColumns.size());
+    stream->write(reinterpret_cast<const char *>(changedColumns.data()),
+                  changedColumns.size() * sizeof(uint32_t));
+    pad();
+    stream->write(reinterpret_cast<const char *>(changedValues.data()),
+                  changedValues.size() * sizeof(double));
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename, bool changed, bool desc)
+{
+    return std::unique_ptr<Output>(new Columnar(filename, changed, desc));
+}
+
+} // namespace Stats
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <cstdint>
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+/**
+ * Binary, column oriented stat output.
+ *
+ * Every stat is flattened into one or more double columns. The schema
+ * (stat names, types, descriptions and column names) is written once,
+ * at the first dump. Each dump after that only appends a record with
+ * the column values, or optionally only the columns that changed since
+ * the previous dump. The file is never rewritten and is not compressed,
+ * so it can be memory mapped by readers while the simulation runs.
+ *
+ * All integers and doubles are stored in host byte order, and every
+ * section starts on an 8 byte boundary:
+ *
+ *   header:  char magic[8] = "gem5col\0", uint32 version, uint32 flags
+ *   schema:  uint32 num_stats, uint32 num_columns, then for each stat:
+ *            uint32 type, uint32 num_columns, string name, string desc,
+ *            uint32 num_names, string names[num_names]
+ *            where a string is a uint32 length followed by the bytes.
+ *            The schema is padded to a multiple of 8 bytes.
+ *   records: uint32 kind, uint32 count, then
+ *              kind 0 (full):  double values[count], count == num_columns
+ *              kind 1 (delta): uint32 columns[count] padded to 8 bytes,
+ *                              double values[count]
+ *
+ * The columns of a stat follow the columns of the stat before it in
+ * schema order. Distributions are flattened into their summary values
+ * followed by their bucket counts; vector distributions and sparse
+ * histograms aren't supported.
+ */
+class Columnar : public Output
+{
+  public:
+    /** Type of a stat in the schema */
+    enum StatType : uint32_t {
+        ScalarStat = 0,
+        VectorStat = 1,
+        Vector2dStat = 2,
+        FormulaStat = 3,
+        DistStat = 4,
+    };
+
+    /** Record kinds */
+    enum RecordKind : uint32_t {
+        FullRecord = 0,
+        DeltaRecord = 1,
+    };
+
+    static const uint32_t version = 1;
+
+  public:
+    /**
+     * @param file Name of the file in the output directory.
+     * @param changed Write delta records with the changed columns only.
+     * @param desc Include the stat descriptions in the schema.
+     * @param flush_dumps Flush the file after every dump. Frequent
+     *                    writers like samplers can leave this to the
+     *                    stream's buffer and call flush() themselves.
+     */
+    Columnar(const std::string &file, bool changed, bool desc,
+             bool flush_dumps = true);
+
+    ~Columnar();
+
+    Columnar() = delete;
+    Columnar(const Columnar &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    /** Write out any buffered records */
+    void flush();
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** Schema entry for a stat, only kept until the schema is written */
+    struct StatSchema
+    {
+        StatType type;
+        std::string name;
+        std::string desc;
+        std::vector<std::string> names;
+    };
+
+    /** Is the stat included in the output? */
+    bool include(const Info &info) const;
+
+    /** Full name of a stat including the group path */
+    std::string statName(const std::string &name) const;
+
+    /**
+     * Append the columns of a stat to the current dump.
+     *
+     * @param name Name of the stat within the current group.
+     * @param desc Description of the stat.
+     * @param type Type of the stat.
+     * @param values Column values.
+     * @param names Column names, used when the schema is written.
+     */
+    void appendStat(const std::string &name, const std::string &desc,
+                    StatType type, const std::vector<double> &values,
+                    const std::vector<std::string> &names);
+
+    /** Helper for vector stats and formulas */
+    void appendVector(const VectorInfo &info, StatType type);
+
+    /** Write the file header and the schema */
+    void writeSchema();
+
+    /** Write a full or a delta record for the current dump */
+    void writeRecord();
+
+    void writeWord(uint32_t value);
+    void writeString(const std::string &str);
+    void pad();
+
+  protected:
+    const std::string fname;
+    const bool onlyChanged;
+    const bool enableDescriptions;
+    const bool flushDumps;
+
+    OutputStream *file;
+    std::ostream *stream;
+
+    /** Object/group path */
+    std::stack<std::string> path;
+
+    /** Number of dumps written so far */
+    unsigned dumpCount;
+
+    /** Schema collected during the first dump */
+    std::vector<StatSchema> schema;
+
+    /** Number of columns of each stat, checked on every dump */
+    std::vector<uint32_t> statColumns;
+
+    /** Index of the next stat in the current dump */
+    size_t statIndex;
+
+    /** Column values of the current dump */
+    std::vector<double> values;
+
+    /** Column values of the previous dump, for delta records */
+    std::vector<double> lastValues;
+
+    /** Scratch space for delta records */
+    std::vector<uint32_t> changedColumns;
+    std::vector<double> changedValues;
+};
+
+std::unique_ptr<Output> initColumnar(
+    const std::string &filename, bool changed = false, bool desc = true);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_COLUMNAR_HH__
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/stats/columnar.hh"
+
+using namespace Stats;
+
+namespace {
+
+/** Columnar output that can be fed with stats without Info objects */
+class TestColumnar : public Columnar
+{
+  public:
+    using Columnar::Columnar;
+    using Columnar::appendStat;
+};
+
+/** Sequential reader for the documented file layout */
+class FileReader
+{
+  public:
+    explicit FileReader(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        data = ss.str();
+    }
+
+    uint32_t
+    word()
+    {
+        uint32_t value;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    double
+    real()
+    {
+        double value;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    std::string
+    string()
+    {
+        const uint32_t size = word();
+        EXPECT_LE(offset + size, data.size());
+        std::string value = data.substr(offset, size);
+        offset += size;
+        return value;
+    }
+
+    /** Skip the padding to the next 8 byte boundary, which must be 0 */
+    void
+    align()
+    {
+        while (offset % 8) {
+            ASSERT_LT(offset, data.size());
+            EXPECT_EQ(data[offset], '\0') << "at offset " << offset;
+            offset++;
+        }
+    }
+
+    void
+    read(void *dst, size_t size)
+    {
+        ASSERT_LE(offset + size, data.size()) << "reading past the end";
+        std::memcpy(dst, data.data() + offset, size);
+        offset += size;
+    }
+
+    bool atEnd() const { return offset == data.size(); }
+
+    std::string data;
+    size_t offset = 0;
+};
+
+} // anonymous namespace
+
+class ColumnarTest : public testing::Test
+{
+  protected:
+    static void
+    SetUpTestCase()
+    {
+        const char *tmp = std::getenv("TMPDIR");
+        dir = std::string(tmp ? tmp : "/tmp") + "/columnar.test.XXXXXX";
+        ASSERT_NE(mkdtemp(&dir[0]), nullptr);
+        simout.setDirectory(dir);
+    }
+
+    static void
+    TearDownTestCase()
+    {
+        rmdir(dir.c_str());
+    }
+
+    void
+    TearDown() override
+    {
+        std::remove(path().c_str());
+    }
+
+    std::string path() const { return simout.resolve(fileName); }
+
+    /** Write a dump with a scalar, a vector in a group and a dist */
+    void
+    dump(TestColumnar &col, double scalar, const std::vector<double> &vec,
+         const std::vector<double> &dist)
+    {
+        col.begin();
+        col.appendStat("scalar", "A scalar", Columnar::ScalarStat,
+                       { scalar }, {});
+        col.beginGroup("system");
+        col.beginGroup("cpu");
+        col.appendStat("vec", "A vector", Columnar::VectorStat, vec,
+                       { "x", "y", "z" });
+        col.endGroup();
+        col.endGroup();
+        col.appendStat("dist", "", Columnar::DistStat, dist, {});
+        col.end();
+    }
+
+    /** Check the header and schema written by dump() */
+    void
+    checkSchema(FileReader &file, bool changed, bool desc)
+    {
+        char magic[8];
+        file.read(magic, sizeof(magic));
+        EXPECT_EQ(std::memcmp(magic, "gem5col", 8), 0);
+        EXPECT_EQ(file.word(), Columnar::version);
+        EXPECT_EQ(file.word(), changed ? 1u : 0u);
+
+        EXPECT_EQ(file.word(), 3u); // stats
+        EXPECT_EQ(file.word(), 6u); // columns
+
+        EXPECT_EQ(file.word(), Columnar::ScalarStat);
+        EXPECT_EQ(file.word(), 1u);
+        EXPECT_EQ(file.string(), "scalar");
+        EXPECT_EQ(file.string(), desc ? "A scalar" : "");
+        EXPECT_EQ(file.word(), 0u);
+
+        EXPECT_EQ(file.word(), Columnar::VectorStat);
+        EXPECT_EQ(file.word(), 3u);
+        EXPECT_EQ(file.string(), "system.cpu.vec");
+        EXPECT_EQ(file.string(), desc ? "A vector" : "");
+        EXPECT_EQ(file.word(), 3u);
+        EXPECT_EQ(file.string(), "x");
+        EXPECT_EQ(file.string(), "y");
+        EXPECT_EQ(file.string(), "z");
+
+        EXPECT_EQ(file.word(), Columnar::DistStat);
+        EXPECT_EQ(file.word(), 2u);
+        EXPECT_EQ(file.string(), "dist");
+        EXPECT_EQ(file.string(), "");
+        EXPECT_EQ(file.word(), 0u);
+
+        file.align();
+    }
+
+    void
+    checkFullRecord(FileReader &file, const std::vector<double> &values)
+    {
+        EXPECT_EQ(file.offset % 8, 0u);
+        EXPECT_EQ(file.word(), Columnar::FullRecord);
+        ASSERT_EQ(file.word(), values.size());
+        for (double v : values)
+            EXPECT_EQ(file.real(), v);
+    }
+
+    void
+    checkDeltaRecord(FileReader &file, const std::vector<uint32_t> &columns,
+                     const std::vector<double> &values)
+    {
+        EXPECT_EQ(file.offset % 8, 0u);
+        EXPECT_EQ(file.word(), Columnar::DeltaRecord);
+        ASSERT_EQ(file.word(), columns.size());
+        for (uint32_t c : columns)
+            EXPECT_EQ(file.word(), c);
+        file.align();
+        for (double v : values)
+            EXPECT_EQ(file.real(), v);
+    }
+
+    static std::string dir;
+    const std::string fileName = "stats.col";
+};
+
+std::string ColumnarTest::dir;
+
+TEST_F(ColumnarTest, SchemaAndFullRecords)
+{
+    {
+        TestColumnar col(fileName, false, true);
+        dump(col, 1, { 2, 3, 4 }, { 5, 6 });
+        dump(col, 1, { 2, 3, 4 }, { 5, 6 });
+        dump(col, 7, { 8, 9, 10 }, { 11, 12 });
+    }
+
+    FileReader file(path());
+    checkSchema(file, false, true);
+    // Without delta records every dump is complete, even if nothing
+    // changed.
+    checkFullRecord(file, { 1, 2, 3, 4, 5, 6 });
+    checkFullRecord(file, { 1, 2, 3, 4, 5, 6 });
+    checkFullRecord(file, { 7, 8, 9, 10, 11, 12 });
+    EXPECT_TRUE(file.atEnd());
+}
+
+TEST_F(ColumnarTest, NoDescriptions)
+{
+    {
+        TestColumnar col(fileName, false, false);
+        dump(col, 1, { 2, 3, 4 }, { 5, 6 });
+    }
+
+    FileReader file(path());
+    checkSchema(file, false, false);
+    checkFullRecord(file, { 1, 2, 3, 4, 5, 6 });
+    EXPECT_TRUE(file.atEnd());
+}
+
+TEST_F(ColumnarTest, DeltaRecords)
+{
+    const double nan = std::nan("");
+    {
+        TestColumnar col(fileName, true, true);
+        dump(col, 1, { 2, 3, nan }, { 5, 6 });
+        // Two changed columns, the column list needs no padding
+        dump(col, 10, { 2, 30, nan }, { 5, 6 });
+        // One changed column, the column list is padded
+        dump(col, 10, { 2, 30, nan }, { 5, 60 });
+        // Nothing changed, NaNs compare equal to themselves
+        dump(col, 10, { 2, 30, nan }, { 5, 60 });
+    }
+
+    FileReader file(path());
+    checkSchema(file, true, true);
+
+    // The first record is always complete
+    EXPECT_EQ(file.word(), Columnar::FullRecord);
+    ASSERT_EQ(file.word(), 6u);
+    EXPECT_EQ(file.real(), 1);
+    EXPECT_EQ(file.real(), 2);
+    EXPECT_EQ(file.real(), 3);
+    EXPECT_TRUE(std::isnan(file.real()));
+    EXPECT_EQ(file.real(), 5);
+    EXPECT_EQ(file.real(), 6);
+
+    checkDeltaRecord(file, { 0, 2 }, { 10, 30 });
+    const size_t padded = file.offset;
+    checkDeltaRecord(file, { 5 }, { 60 });
+    EXPECT_EQ(file.offset - padded, 8u + 8 + 8);
+    checkDeltaRecord(file, {}, {});
+    EXPECT_TRUE(file.atEnd());
+}
+
+TEST_F(ColumnarTest, SchemaMismatch)
+{
+    TestColumnar col(fileName, false, true);
+    dump(col, 1, { 2, 3, 4 }, { 5, 6 });
+
+    // A stat that changes its number of columns
+    col.begin();
+    col.appendStat("scalar", "", Columnar::ScalarStat, { 1 }, {});
+    EXPECT_ANY_THROW(col.appendStat("system.cpu.vec", "",
+                                    Columnar::VectorStat, { 1, 2 }, {}));
+
+    // A dump with fewer stats than the schema
+    col.begin();
+    col.appendStat("scalar", "", Columnar::ScalarStat, { 1 }, {});
+    EXPECT_ANY_THROW(col.end());
+}
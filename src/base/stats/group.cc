@@ -167,4 +167,10 @@ Group::getStats() const
     return stats;
 }
 
+const std::vector<Group *> &
+Group::getMergedStatGroups() const
+{
+    return mergedStatGroups;
+}
+
 } // namespace Stats
@@ -132,10 +132,21 @@ class Group
     /**
      * Callback to reset stats.
      *
+     * Stats are normally reset in bulk without calling this method.
+     * Classes that override it must call setCustomReset() from their
+     * constructor.
+     *
      * @ingroup api_stats
      */
     virtual void resetStats();
 
+    /**
+     * Does this group override resetStats()?
+     *
+     * @ingroup api_stats
+     */
+    bool hasCustomReset() const { return customReset; }
+
     /**
      * Callback before stats are dumped. This can be overridden by
      * objects that need to perform calculations in addition to the
@@ -167,6 +178,14 @@ class Group
      */
     const std::vector<Info *> &getStats() const;
 
+    /**
+     * Get the groups merged into this one. Their stats are also in
+     * getStats().
+     *
+     * @ingroup api_stats
+     */
+    const std::vector<Group *> &getMergedStatGroups() const;
+
      /**
      * Add a stat block as a child of this block
      *
@@ -194,6 +213,16 @@ class Group
      */
     const Info * resolveStat(std::string name) const;
 
+  protected:
+    /**
+     * Declare that this group overrides resetStats(), so that it gets
+     * called when stats are reset instead of the group's stats being
+     * reset in bulk.
+     *
+     * @ingroup api_stats
+     */
+    void setCustomReset() { customReset = true; }
+
   private:
     /**
      * Merge the contents (stats & children) of a block to this block.
@@ -210,6 +239,9 @@ class Group
     std::map<std::string, Group *> statGroups;
     std::vector<Group *> mergedStatGroups;
     std::vector<Info *> stats;
+
+    /** Set by groups that override resetStats() */
+    bool customReset = false;
 };
 
 } // namespace Stats
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/registry.hh"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "base/stats/output.hh"
+#include "base/str.hh"
+
+namespace Stats {
+
+Registry &
+registry()
+{
+    static Registry the_registry;
+    return the_registry;
+}
+
+void
+Registry::add(Info *info)
+{
+    if (!info->check() || !info->baseCheck()) {
+        fatal("statistic '%s' (%d) was not properly initialized "
+              "by a regStats() function\n", info->name, info->id);
+    }
+
+    if (!(info->flags & display))
+        info->name = csprintf("__Stat%06d", info->id);
+
+    info->enable();
+    all.push_back(info);
+}
+
+void
+Registry::build(Group *root)
+{
+    legacy.clear();
+    all.clear();
+    steps.clear();
+    resetStats.clear();
+    resetGroups.clear();
+
+    for (auto *info : statsList())
+        add(info);
+
+    // Sort on the dotted components of the names, tokenizing each name
+    // only once
+    std::vector<std::pair<std::vector<std::string>, Info *>> keys;
+    keys.reserve(all.size());
+    for (auto *info : all) {
+        keys.emplace_back(std::vector<std::string>(), info);
+        tokenize(keys.back().first, info->name, '.', false);
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const std::pair<std::vector<std::string>, Info *> &a,
+                        const std::pair<std::vector<std::string>, Info *> &b)
+                     { return a.first < b.first; });
+
+    all.clear();
+    for (const auto &key : keys) {
+        legacy.push_back(key.second);
+        all.push_back(key.second);
+        steps.push_back({ key.second, nullptr });
+    }
+
+    resetStats = legacy;
+    if (root) {
+        addGroup(root);
+        addReset(root, false);
+    }
+}
+
+void
+Registry::addGroup(Group *group)
+{
+    for (auto *info : group->getStats()) {
+        add(info);
+        steps.push_back({ info, nullptr });
+    }
+
+    for (const auto &child : group->getStatGroups()) {
+        steps.push_back({ nullptr, child.first.c_str() });
+        addGroup(child.second);
+        steps.push_back({ nullptr, nullptr });
+    }
+}
+
+void
+Registry::addReset(Group *group, bool merged)
+{
+    if (group->hasCustomReset()) {
+        resetGroups.push_back(group);
+        return;
+    }
+
+    // The stats of a merged group are in its parent's stats
+    if (!merged) {
+        resetStats.insert(resetStats.end(), group->getStats().begin(),
+                          group->getStats().end());
+    }
+    for (auto *merged_group : group->getMergedStatGroups())
+        addReset(merged_group, true);
+    for (const auto &child : group->getStatGroups())
+        addReset(child.second, false);
+}
+
+void
+Registry::prepare() const
+{
+    for (auto *info : all)
+        info->prepare();
+}
+
+void
+Registry::reset() const
+{
+    for (auto *info : resetStats)
+        info->reset();
+    for (auto *group : resetGroups)
+        group->resetStats();
+}
+
+void
+Registry::visit(Output &output) const
+{
+    for (const auto &step : steps) {
+        if (step.info)
+            step.info->visit(output);
+        else if (step.group)
+            output.beginGroup(step.group);
+        else
+            output.endGroup();
+    }
+}
+
+} // namespace Stats
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_REGISTRY_HH__
+#define __BASE_STATS_REGISTRY_HH__
+
+#include <vector>
+
+namespace Stats {
+
+class Group;
+class Info;
+class Output;
+
+/**
+ * Flat view of all the stats, built once when the stats are enabled.
+ *
+ * Preparing, dumping and resetting the stats used to walk the legacy
+ * stat list and every group from Python, one call per stat. The
+ * registry keeps the stats in dump order in plain arrays instead, so
+ * these operations are a single linear scan in C++.
+ */
+class Registry
+{
+  public:
+    /**
+     * Check and enable the legacy stats and the stats of the groups
+     * below root, and record them in dump order. Stats that aren't
+     * displayed get a placeholder name, and legacy stats are sorted
+     * by name.
+     */
+    void build(Group *root);
+
+    /** Prepare all stats for data access */
+    void prepare() const;
+
+    /**
+     * Reset all stats. The stats of groups that don't override
+     * Group::resetStats() are reset in bulk, and the outermost groups
+     * that declare an override with Group::setCustomReset() get
+     * resetStats() called.
+     */
+    void reset() const;
+
+    /** Visit all stats in dump order, wrapped in their groups */
+    void visit(Output &output) const;
+
+    /** Legacy stats sorted by name */
+    const std::vector<Info *> &legacyStats() const { return legacy; }
+
+  private:
+    void addGroup(Group *group);
+    void add(Info *info);
+    void addReset(Group *group, bool merged);
+
+    /**
+     * A step of a dump: a stat to visit, or the beginning of a group
+     * with its name (or the end of a group if there is no name).
+     */
+    struct Step
+    {
+        Info *info;
+        const char *group;
+    };
+
+    std::vector<Info *> legacy;
+    std::vector<Info *> all;
+    std::vector<Step> steps;
+
+    /** Legacy stats and stats of groups reset in bulk */
+    std::vector<Info *> resetStats;
+    /** Outermost groups with a custom Group::resetStats() */
+    std::vector<Group *> resetGroups;
+};
+
+/** The registry of the simulator's stats */
+Registry &registry();
+
+} // namespace Stats
+
+#endif // __BASE_STATS_REGISTRY_HH__
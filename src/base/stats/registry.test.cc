@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "base/statistics.hh"
+#include "base/stats/registry.hh"
+
+using namespace Stats;
+
+namespace {
+
+/** A group that only has a stat */
+struct PlainGroup : public Group
+{
+    PlainGroup(Group *parent, const char *name=nullptr)
+        : Group(parent, name), ADD_STAT(count, "")
+    {}
+
+    Scalar count;
+};
+
+/** A group that counts its resets */
+struct ResetGroup : public PlainGroup
+{
+    ResetGroup(Group *parent, const char *name=nullptr)
+        : PlainGroup(parent, name)
+    {
+        setCustomReset();
+    }
+
+    int resets = 0;
+
+    void
+    resetStats() override
+    {
+        resets++;
+        PlainGroup::resetStats();
+    }
+};
+
+/** A group that overrides resetStats() through a secondary base */
+struct OtherBase
+{
+    virtual ~OtherBase() {}
+    int other = 0;
+};
+
+struct SecondaryResetGroup : public OtherBase, public ResetGroup
+{
+    using ResetGroup::ResetGroup;
+};
+
+} // anonymous namespace
+
+TEST(StatsRegistry, Reset)
+{
+    PlainGroup root(nullptr);
+    PlainGroup plain(&root, "plain");
+    ResetGroup reset(&root, "reset");
+    PlainGroup reset_child(&reset, "child");
+    ResetGroup reset_grandchild(&reset_child, "child");
+    PlainGroup merged(&plain);
+    ResetGroup reset_merged(&plain);
+    SecondaryResetGroup secondary(&plain, "secondary");
+
+    Registry registry;
+    registry.build(&root);
+
+    for (auto *stat : { &root.count, &plain.count, &reset.count,
+                        &reset_child.count, &reset_grandchild.count,
+                        &merged.count, &reset_merged.count,
+                        &secondary.count }) {
+        *stat = 1;
+    }
+
+    registry.reset();
+
+    // Overriding groups are reset once, through the outermost one
+    EXPECT_EQ(1, reset.resets);
+    EXPECT_EQ(1, reset_grandchild.resets);
+    EXPECT_EQ(1, reset_merged.resets);
+    EXPECT_EQ(1, secondary.resets);
+
+    for (auto *stat : { &root.count, &plain.count, &reset.count,
+                        &reset_child.count, &reset_grandchild.count,
+                        &merged.count, &reset_merged.count,
+                        &secondary.count }) {
+        EXPECT_EQ(0, stat->value());
+    }
+}
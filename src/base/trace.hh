@@ -37,6 +37,7 @@
 #include "base/cprintf.hh"
 #include "base/debug.hh"
 #include "base/match.hh"
+#include "base/trace_args.hh"
 #include "base/types.hh"
 #include "sim/core.hh"
 
@@ -50,6 +51,16 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /** Set by loggers that take messages with encodable arguments
+     *  unformatted through logArgs */
+    bool deferFormat = false;
+
+    /** Log a message whose arguments have not been formatted yet */
+    virtual void
+    logArgs(Tick when, const std::string &name, const std::string &flag,
+            const char *fmt, const TraceArgs &args)
+    { }
+
   public:
     /** Log a single message */
     template <typename ...Args>
@@ -67,6 +78,13 @@ class Logger
     {
         if (!name.empty() && ignore.match(name))
             return;
+        if (deferFormat && TraceArgs::AllEncodable<Args...>::value) {
+            TraceArgs &encoded = TraceArgs::local();
+            encoded.clear();
+            encoded.add(args...);
+            logArgs(when, name, flag, fmt, encoded);
+            return;
+        }
         std::ostringstream line;
         ccprintf(line, fmt, args...);
         logMessage(when, name, flag, line.str());
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_TRACE_ARGS_HH__
+#define __BASE_TRACE_ARGS_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Trace {
+
+/**
+ * The arguments of a debug message in a compact binary form, for loggers
+ * that defer formatting.  Only the built-in types that cprintf formats by
+ * itself (integers, characters, bools, floats and strings) can be encoded;
+ * a message with any other argument has to be formatted where it is
+ * logged, since its operator<< may depend on state that is gone by the
+ * time the trace is read.
+ *
+ * Each argument is a one byte Kind, followed by its size in bytes and its
+ * native byte order value for numbers, or a 32-bit length and the
+ * characters for strings.  Floats are widened to double.
+ */
+class TraceArgs
+{
+  public:
+    enum Kind : uint8_t
+    {
+        SignedInt,
+        UnsignedInt,
+        SignedChar,
+        UnsignedChar,
+        Bool,
+        Float,
+        String
+    };
+
+    /** Can an argument of type T be encoded? */
+    template <typename T>
+    struct Encodable : std::integral_constant<bool,
+        (std::is_integral<T>::value &&
+         !std::is_same<T, wchar_t>::value &&
+         !std::is_same<T, char16_t>::value &&
+         !std::is_same<T, char32_t>::value) ||
+        std::is_same<T, float>::value ||
+        std::is_same<T, double>::value ||
+        std::is_same<T, std::string>::value ||
+        std::is_same<typename std::decay<T>::type, char *>::value ||
+        std::is_same<typename std::decay<T>::type, const char *>::value>
+    {};
+
+    /** Can all the arguments of a message be encoded? */
+    template <typename ...Args>
+    struct AllEncodable;
+
+  private:
+    std::vector<char> _data;
+
+    void
+    put(const void *value, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(value);
+        _data.insert(_data.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void
+    putNumber(Kind kind, T value)
+    {
+        _data.push_back(kind);
+        _data.push_back(sizeof(value));
+        put(&value, sizeof(value));
+    }
+
+    void
+    putString(const char *str, size_t len)
+    {
+        uint32_t size = len;
+        _data.push_back(String);
+        put(&size, sizeof(size));
+        put(str, len);
+    }
+
+    void addValue(bool v) { putNumber<uint8_t>(Bool, v); }
+    void addValue(char v) { putNumber(std::is_signed<char>::value ?
+                                      SignedChar : UnsignedChar, v); }
+    void addValue(signed char v) { putNumber(SignedChar, v); }
+    void addValue(unsigned char v) { putNumber(UnsignedChar, v); }
+    void addValue(float v) { putNumber<double>(Float, v); }
+    void addValue(double v) { putNumber(Float, v); }
+    void addValue(const std::string &v) { putString(v.data(), v.size()); }
+
+    void
+    addValue(const char *v)
+    {
+        // Streaming a null string prints nothing
+        putString(v, v ? strlen(v) : 0);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type
+    addValue(T v)
+    {
+        putNumber(std::is_signed<T>::value ? SignedInt : UnsignedInt, v);
+    }
+
+    template <typename T>
+    void addArg(const T &value, std::true_type) { addValue(value); }
+
+    /** Never called, the logger formats messages with these itself */
+    template <typename T>
+    void addArg(const T &value, std::false_type) { }
+
+  public:
+    void clear() { _data.clear(); }
+
+    void add() { }
+
+    template <typename T, typename ...Args>
+    void
+    add(const T &value, const Args &...args)
+    {
+        addArg(value, Encodable<T>());
+        add(args...);
+    }
+
+    const char *data() const { return _data.data(); }
+    size_t size() const { return _data.size(); }
+
+    /** A per-thread instance to encode messages into */
+    static TraceArgs &
+    local()
+    {
+        static thread_local TraceArgs args;
+        return args;
+    }
+};
+
+template <>
+struct TraceArgs::AllEncodable<> : std::true_type
+{};
+
+template <typename T, typename ...Args>
+struct TraceArgs::AllEncodable<T, Args...> : std::integral_constant<bool,
+    Encodable<T>::value && AllEncodable<Args...>::value>
+{};
+
+} // namespace Trace
+
+#endif // __BASE_TRACE_ARGS_HH__
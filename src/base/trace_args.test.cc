@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/trace_args.hh"
+
+using Trace::TraceArgs;
+
+namespace {
+
+/** Reads the arguments back from an encoding */
+class ArgReader
+{
+  private:
+    const TraceArgs &args;
+    size_t offset = 0;
+
+    template <typename T>
+    T
+    get()
+    {
+        T value;
+        EXPECT_LE(offset + sizeof(value), args.size());
+        memcpy(&value, args.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+
+  public:
+    ArgReader(const TraceArgs &_args) : args(_args) {}
+
+    bool done() const { return offset == args.size(); }
+
+    /** Check the kind and size of a number and return its value */
+    template <typename T>
+    T
+    number(TraceArgs::Kind kind)
+    {
+        EXPECT_EQ(kind, get<uint8_t>());
+        EXPECT_EQ(sizeof(T), get<uint8_t>());
+        return get<T>();
+    }
+
+    std::string
+    string()
+    {
+        EXPECT_EQ(TraceArgs::String, get<uint8_t>());
+        const uint32_t size = get<uint32_t>();
+        EXPECT_LE(offset + size, args.size());
+        std::string value(args.data() + offset, size);
+        offset += size;
+        return value;
+    }
+};
+
+struct Unformatted {};
+
+} // anonymous namespace
+
+static_assert(TraceArgs::AllEncodable<>::value, "");
+static_assert(TraceArgs::AllEncodable<int, char, bool, double, float,
+                                      std::string, const char *>::value,
+              "");
+static_assert(TraceArgs::AllEncodable<char[4], const char[4]>::value, "");
+static_assert(!TraceArgs::AllEncodable<int, Unformatted>::value, "");
+static_assert(!TraceArgs::AllEncodable<wchar_t>::value, "");
+static_assert(!TraceArgs::AllEncodable<void *>::value, "");
+
+TEST(TraceArgsTest, Empty)
+{
+    TraceArgs args;
+    args.add();
+    EXPECT_EQ(0u, args.size());
+}
+
+TEST(TraceArgsTest, Integers)
+{
+    TraceArgs args;
+    args.add((int16_t)-2, 7u, (int64_t)-3, (uint64_t)0x123456789abULL);
+
+    ArgReader reader(args);
+    EXPECT_EQ(-2, reader.number<int16_t>(TraceArgs::SignedInt));
+    EXPECT_EQ(7u, reader.number<unsigned>(TraceArgs::UnsignedInt));
+    EXPECT_EQ(-3, reader.number<int64_t>(TraceArgs::SignedInt));
+    EXPECT_EQ(0x123456789abULL,
+              reader.number<uint64_t>(TraceArgs::UnsignedInt));
+    EXPECT_TRUE(reader.done());
+}
+
+TEST(TraceArgsTest, Bool)
+{
+    TraceArgs args;
+    args.add(true, false);
+
+    ArgReader reader(args);
+    EXPECT_EQ(1, reader.number<uint8_t>(TraceArgs::Bool));
+    EXPECT_EQ(0, reader.number<uint8_t>(TraceArgs::Bool));
+    EXPECT_TRUE(reader.done());
+}
+
+TEST(TraceArgsTest, CharSignedness)
+{
+    TraceArgs args;
+    args.add('a', (signed char)-1, (unsigned char)0xff);
+
+    // A plain char keeps the signedness it has on the host, so "%d"
+    // prints the same as it would have when formatted directly
+    ArgReader reader(args);
+    EXPECT_EQ('a', reader.number<char>(std::is_signed<char>::value ?
+                                       TraceArgs::SignedChar :
+                                       TraceArgs::UnsignedChar));
+    EXPECT_EQ(-1, reader.number<signed char>(TraceArgs::SignedChar));
+    EXPECT_EQ(0xff, reader.number<unsigned char>(TraceArgs::UnsignedChar));
+    EXPECT_TRUE(reader.done());
+}
+
+TEST(TraceArgsTest, FloatWidening)
+{
+    TraceArgs args;
+    args.add(0.1f, 0.1);
+
+    ArgReader reader(args);
+    EXPECT_EQ((double)0.1f, reader.number<double>(TraceArgs::Float));
+    EXPECT_EQ(0.1, reader.number<double>(TraceArgs::Float));
+    EXPECT_TRUE(reader.done());
+}
+
+TEST(TraceArgsTest, Strings)
+{
+    char buf[] = "buf";
+    const char *null_str = nullptr;
+    TraceArgs args;
+    args.add(std::string("str"), "literal", buf, null_str,
+             std::string("a\0b", 3));
+
+    ArgReader reader(args);
+    EXPECT_EQ("str", reader.string());
+    EXPECT_EQ("literal", reader.string());
+    EXPECT_EQ("buf", reader.string());
+    // Streaming a null string prints nothing
+    EXPECT_EQ("", reader.string());
+    EXPECT_EQ(std::string("a\0b", 3), reader.string());
+    EXPECT_TRUE(reader.done());
+}
+
+TEST(TraceArgsTest, Clear)
+{
+    TraceArgs args;
+    args.add(1, "one");
+    args.clear();
+    EXPECT_EQ(0u, args.size());
+
+    args.add(2);
+    ArgReader reader(args);
+    EXPECT_EQ(2, reader.number<int>(TraceArgs::SignedInt));
+    EXPECT_TRUE(reader.done());
+}
@@ -188,7 +188,12 @@ BaseCPU::~BaseCPU()
 void
 BaseCPU::postInterrupt(ThreadID tid, int int_num, int index)
 {
-    interrupts[tid]->post(int_num, index);
+    {
+        // Other CPUs, e.g., executing an Arm SEV, may post interrupts
+        // from their own event queue.
+        EventQueue::ScopedMigration migrate(interrupts[tid]->eventQueue());
+        interrupts[tid]->post(int_num, index);
+    }
     // Only wake up syscall emulation if it is not waiting on a futex.
     // This is to model the fact that instructions such as ARM SEV
     // should wake up a WFE sleep, but not a futex syscall WAIT. */
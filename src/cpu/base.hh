@@ -233,12 +233,15 @@ class BaseCPU : public ClockedObject
     void
     clearInterrupt(ThreadID tid, int int_num, int index)
     {
+        // See postInterrupt().
+        EventQueue::ScopedMigration migrate(interrupts[tid]->eventQueue());
         interrupts[tid]->clear(int_num, index);
     }
 
     void
     clearInterrupts(ThreadID tid)
     {
+        EventQueue::ScopedMigration migrate(interrupts[tid]->eventQueue());
         interrupts[tid]->clearAll();
     }
 
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/inst_col_trace.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "cpu/op_class.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/thread_context.hh"
+#include "debug/ExecEnable.hh"
+#include "sim/core.hh"
+
+namespace Trace {
+
+const unsigned InstColTrace::columnWidth[NumColumns] = {
+    8, 4, 8, 4, 1, 1, 1, 1, 1, 8, 8, 4, 4
+};
+
+InstColTrace::Writer *InstColTrace::writer = nullptr;
+
+void
+InstColTraceRecord::dump()
+{
+    // Like InstPBTrace, record macro-ops and instructions that aren't
+    // macro-oped, and attach the accesses of the micro-ops to them
+    if ((macroStaticInst && staticInst->isFirstMicroop()) ||
+            !staticInst->isMicroop()) {
+        tracer.traceInst(thread, staticInst, pc);
+    }
+
+    if (getMemValid())
+        tracer.traceMem(staticInst, getAddr(), getSize(), getFlags());
+
+    switch (data_status) {
+      case DataInt8:
+      case DataInt16:
+      case DataInt32:
+      case DataInt64:
+      case DataDouble:
+        // Doubles are kept as their bits
+        tracer.traceData(data_status, data.as_int);
+        break;
+      default:
+        break;
+    }
+}
+
+void
+InstColTrace::Block::clear()
+{
+    records = 0;
+    for (auto &column : columns)
+        column.clear();
+}
+
+InstColTrace::Writer::Writer(const std::string &filename)
+    : output(simout.create(filename, true, true))
+{
+    writeHeader();
+    thread = std::thread([this]() { writeLoop(); });
+    registerExitCallback([this]() { close(); });
+}
+
+InstColTrace::Writer::~Writer()
+{
+    close();
+}
+
+void
+InstColTrace::Writer::remove(InstColTrace *tracer)
+{
+    tracers.erase(std::remove(tracers.begin(), tracers.end(), tracer),
+                  tracers.end());
+}
+
+void
+InstColTrace::Writer::writeHeader()
+{
+    std::ostream &os = *output->stream();
+    auto put = [&os](uint32_t value) {
+        value = htole(value);
+        os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    os.write("gem5ict\0", 8);
+    put(Version);
+    put(NumColumns);
+    uint64_t freq = htole((uint64_t)SimClock::Frequency);
+    os.write(reinterpret_cast<const char *>(&freq), sizeof(freq));
+    put(Num_OpClasses);
+    for (int i = 0; i < Num_OpClasses; i++) {
+        const char *name = Enums::OpClassStrings[i];
+        put(strlen(name));
+        os.write(name, strlen(name));
+    }
+}
+
+InstColTrace::Block *
+InstColTrace::Writer::getBlock()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeBlocks.empty()) {
+        blocks.emplace_back(new Block);
+        return blocks.back().get();
+    }
+    Block *block = freeBlocks.back();
+    freeBlocks.pop_back();
+    return block;
+}
+
+void
+InstColTrace::Writer::submit(Block *block)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stopping) {
+        // Nothing is written once the file is closed
+        block->clear();
+        freeBlocks.push_back(block);
+        return;
+    }
+    doneCond.wait(lock, [this]() { return pending.size() < MaxPending; });
+    pending.push_back(block);
+    pendingCond.notify_one();
+}
+
+void
+InstColTrace::Writer::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        pendingCond.wait(lock, [this]() {
+                return stopping || !pending.empty(); });
+        if (pending.empty())
+            break;
+
+        Block *block = pending.front();
+        lock.unlock();
+
+        writeBlock(*block);
+        block->clear();
+
+        lock.lock();
+        pending.pop_front();
+        freeBlocks.push_back(block);
+        doneCond.notify_all();
+    }
+}
+
+void
+InstColTrace::Writer::writeBlock(const Block &block)
+{
+    uint32_t header[1 + 2 * NumColumns];
+    header[0] = htole(block.records);
+
+    size_t bound = 0;
+    for (const auto &column : block.columns)
+        bound += compressBound(column.size());
+    compressed.resize(bound);
+
+    size_t offset = 0;
+    for (int col = 0; col < NumColumns; col++) {
+        const std::vector<uint8_t> &column = block.columns[col];
+        const uint8_t *data = column.data();
+        size_t size = column.size();
+
+        // Transpose the bytes of wider values, so that the mostly
+        // zero upper bytes of the deltas end up next to each other
+        const unsigned width = columnWidth[col];
+        if (width > 1 && size) {
+            const size_t count = size / width;
+            shuffled.resize(size);
+            for (size_t i = 0; i < count; i++) {
+                for (unsigned b = 0; b < width; b++)
+                    shuffled[b * count + i] = data[i * width + b];
+            }
+            data = shuffled.data();
+        }
+
+        uLongf compressed_size = 0;
+        if (size) {
+            compressed_size = bound - offset;
+            int ret = compress2(compressed.data() + offset, &compressed_size,
+                                data, size, 1);
+            panic_if(ret != Z_OK, "Failed to compress instruction trace.");
+        }
+        header[1 + 2 * col] = htole((uint32_t)size);
+        header[2 + 2 * col] = htole((uint32_t)compressed_size);
+        offset += compressed_size;
+    }
+
+    std::ostream &os = *output->stream();
+    os.write(reinterpret_cast<const char *>(header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(compressed.data()), offset);
+}
+
+void
+InstColTrace::Writer::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    // Called once simulation is over, so no tracer is adding records
+    for (auto *tracer : tracers)
+        tracer->flush();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    pendingCond.notify_one();
+    thread.join();
+    simout.close(output);
+    output = nullptr;
+}
+
+InstColTrace::InstColTrace(const InstColTraceParams *p)
+    : InstTracer(p), blockSize(p->block_size), buf(nullptr), bufSize(0),
+      block(nullptr), lastTick(0), lastPc(0), lastAddr(0), lastData(0),
+      prevData(0)
+{
+    fatal_if(blockSize == 0, "%s: block_size must be positive.", name());
+
+    // Since there is only one output file for all tracers check if it
+    // exists
+    if (!writer)
+        writer = new Writer(p->file_name);
+    writer->add(this);
+}
+
+InstColTrace::~InstColTrace()
+{
+    if (writer)
+        writer->remove(this);
+}
+
+InstColTraceRecord *
+InstColTrace::getInstRecord(Tick when, ThreadContext *tc,
+                            const StaticInstPtr si, TheISA::PCState pc,
+                            const StaticInstPtr mi)
+{
+    // Only record the trace if Exec debugging is enabled
+    if (!Debug::ExecEnable)
+        return NULL;
+
+    return new InstColTraceRecord(*this, when, tc, si, pc, mi);
+}
+
+void
+InstColTrace::flush()
+{
+    if (block && block->records)
+        writer->submit(block);
+    else if (block)
+        block->clear();
+    block = nullptr;
+}
+
+void
+InstColTrace::traceInst(ThreadContext *tc, StaticInstPtr si,
+                        TheISA::PCState pc)
+{
+    // Only move on to a new block once the previous instruction can't get
+    // any more memory accesses or results
+    if (block && block->records >= blockSize)
+        flush();
+    if (!block) {
+        block = writer->getBlock();
+        lastTick = 0;
+        lastPc = 0;
+        lastAddr = 0;
+        lastData = 0;
+    }
+
+    size_t inst_size = si->asBytes(buf.get(), bufSize);
+    if (inst_size > bufSize) {
+        bufSize = inst_size;
+        buf.reset(new uint8_t[bufSize]);
+        inst_size = si->asBytes(buf.get(), bufSize);
+    }
+
+    const Tick tick = curTick();
+    block->put<int64_t>(TickCol, tick - lastTick);
+    lastTick = tick;
+    block->put<uint32_t>(CpuCol, tc->cpuId());
+    block->put<int64_t>(PcCol, pc.pc() - lastPc);
+    lastPc = pc.pc();
+
+    uint32_t inst = 0;
+    if (inst_size == sizeof(uint32_t)) {
+        std::memcpy(&inst, buf.get(), sizeof(inst));
+        inst = letoh(inst);
+    } else {
+        std::vector<uint8_t> &bytes = block->columns[InstBytesCol];
+        bytes.insert(bytes.end(), buf.get(), buf.get() + inst_size);
+    }
+    block->put<uint32_t>(InstCol, inst);
+    block->put<uint8_t>(InstSizeCol, inst_size);
+    block->put<uint8_t>(OpClassCol, si->opClass());
+    block->put<uint8_t>(MemCountCol, 0);
+    block->put<uint8_t>(DataKindCol, 0);
+    block->records++;
+
+    prevData = lastData;
+}
+
+void
+InstColTrace::traceMem(StaticInstPtr si, Addr a, Addr s, unsigned f)
+{
+    panic_if(!block || !block->records, "Memory access w/o instruction?!");
+    const size_t cur = block->records - 1;
+
+    // We do a poor job identifying macro-ops that are load/stores
+    block->set<uint8_t>(OpClassCol, cur, si->opClass());
+
+    uint8_t &count = block->columns[MemCountCol][cur];
+    if (count == UINT8_MAX) {
+        warn_once("%s: Dropping memory accesses of an instruction with "
+                  "more than %d of them.\n", name(), UINT8_MAX);
+        return;
+    }
+    count++;
+
+    block->put<int64_t>(MemAddrCol, a - lastAddr);
+    lastAddr = a;
+    block->put<uint32_t>(MemSizeCol, s);
+    block->put<uint32_t>(MemFlagsCol, f);
+}
+
+void
+InstColTrace::traceData(int status, uint64_t value)
+{
+    if (!block || !block->records)
+        return;
+    const size_t cur = block->records - 1;
+
+    // An instruction made of micro-ops keeps the last value written
+    uint8_t &kind = block->columns[DataKindCol][cur];
+    if (kind) {
+        std::vector<uint8_t> &data = block->columns[DataCol];
+        block->set<int64_t>(DataCol, data.size() / sizeof(int64_t) - 1,
+                            value - prevData);
+    } else {
+        block->put<int64_t>(DataCol, value - prevData);
+    }
+    kind = status;
+    lastData = value;
+}
+
+} // namespace Trace
+
+Trace::InstColTrace *
+InstColTraceParams::create()
+{
+    return new Trace::InstColTrace(this);
+}
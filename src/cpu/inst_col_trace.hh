@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_INST_COL_TRACE_HH__
+#define __CPU_INST_COL_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "cpu/static_inst_fwd.hh"
+#include "params/InstColTrace.hh"
+#include "sim/byteswap.hh"
+#include "sim/insttracer.hh"
+
+class OutputStream;
+class ThreadContext;
+
+namespace Trace {
+
+class InstColTrace;
+
+/**
+ * Instruction tracer that records the same information as InstPBTrace
+ * (tick, cpu, pc, instruction, op class and memory accesses) plus the
+ * last value written by each instruction, in a block compressed,
+ * columnar file that util/decode_inst_col_trace.py reads back.
+ *
+ * Each tracer fills its own block of records, one column per field, and
+ * hands full blocks to a background thread that compresses and writes
+ * them.  Ticks, PCs, memory addresses and results are stored as deltas
+ * from the previous entry of the block, and multi-byte columns have
+ * their bytes transposed (all first bytes, then all second bytes, ...)
+ * before being deflated, which makes them compress much better than
+ * the values would on their own.
+ *
+ * All tracers share one file:
+ *
+ *   char[8]   magic "gem5ict\0"
+ *   uint32    version
+ *   uint32    number of columns
+ *   uint64    ticks per second
+ *   uint32    number of op classes, then for each (uint32 size, name)
+ *   blocks:
+ *     uint32  number of records
+ *     (uint32 raw size, uint32 compressed size) for each column
+ *     the zlib compressed columns, in order
+ *
+ * All integers are little endian.  The columns, with one entry per
+ * record unless noted otherwise, are:
+ *
+ *   Tick      int64   tick, delta from the previous record
+ *   Cpu       uint32  cpu id
+ *   Pc        int64   pc, delta from the previous record
+ *   Inst      uint32  the instruction if it is four bytes long
+ *   InstSize  uint8   size of the instruction
+ *   InstBytes uint8   the instruction if it isn't four bytes long, one
+ *                     entry per byte
+ *   OpClass   uint8   op class
+ *   MemCount  uint8   number of memory accesses
+ *   DataKind  uint8   InstRecord::DataStatus of the result, or 0
+ *   Data      int64   one per record with a result, delta from the
+ *                     previous result
+ *   MemAddr   int64   one per access, delta from the previous access
+ *   MemSize   uint32  one per access
+ *   MemFlags  uint32  one per access
+ *
+ * The first record and access of a block are deltas from zero, so
+ * blocks can be decoded independently.  Blocks of different tracers are
+ * interleaved in the file, so records are only in tick order per cpu.
+ */
+class InstColTraceRecord : public InstRecord
+{
+  public:
+    InstColTraceRecord(InstColTrace &_tracer, Tick when, ThreadContext *tc,
+                       const StaticInstPtr si, TheISA::PCState pc,
+                       const StaticInstPtr mi = NULL)
+        : InstRecord(when, tc, si, pc, mi), tracer(_tracer)
+    {}
+
+    void dump() override;
+
+  protected:
+    InstColTrace &tracer;
+};
+
+class InstColTrace : public InstTracer
+{
+  public:
+    enum Column {
+        TickCol,
+        CpuCol,
+        PcCol,
+        InstCol,
+        InstSizeCol,
+        InstBytesCol,
+        OpClassCol,
+        MemCountCol,
+        DataKindCol,
+        DataCol,
+        MemAddrCol,
+        MemSizeCol,
+        MemFlagsCol,
+        NumColumns
+    };
+
+    /** Size of the entries of each column */
+    static const unsigned columnWidth[NumColumns];
+
+    static const uint32_t Version = 1;
+
+    InstColTrace(const InstColTraceParams *p);
+    ~InstColTrace();
+
+    InstColTraceRecord *getInstRecord(Tick when, ThreadContext *tc,
+                                      const StaticInstPtr si,
+                                      TheISA::PCState pc,
+                                      const StaticInstPtr mi = NULL) override;
+
+  protected:
+    /** A block of records, one buffer per column */
+    struct Block
+    {
+        uint32_t records = 0;
+        std::vector<uint8_t> columns[NumColumns];
+
+        template <typename T>
+        void
+        put(Column col, T value)
+        {
+            std::vector<uint8_t> &data = columns[col];
+            value = htole(value);
+            size_t offset = data.size();
+            data.resize(offset + sizeof(value));
+            std::memcpy(data.data() + offset, &value, sizeof(value));
+        }
+
+        template <typename T>
+        void
+        set(Column col, size_t index, T value)
+        {
+            value = htole(value);
+            std::memcpy(columns[col].data() + index * sizeof(value), &value,
+                        sizeof(value));
+        }
+
+        void clear();
+    };
+
+    /**
+     * The trace file shared by all tracers and the thread that
+     * compresses and writes the blocks they fill.
+     */
+    class Writer
+    {
+      public:
+        Writer(const std::string &filename);
+        ~Writer();
+
+        void add(InstColTrace *tracer) { tracers.push_back(tracer); }
+        void remove(InstColTrace *tracer);
+
+        /** Get an empty block to fill */
+        Block *getBlock();
+
+        /** Queue a full block, waiting if the writer is far behind */
+        void submit(Block *block);
+
+        /** Write the partial blocks of all tracers and close the file */
+        void close();
+
+      private:
+        /** Blocks queued before submit() starts waiting for the writer */
+        static const size_t MaxPending = 4;
+
+        void writeHeader();
+        void writeLoop();
+        void writeBlock(const Block &block);
+
+        OutputStream *output;
+        std::vector<InstColTrace *> tracers;
+
+        std::mutex mutex;
+        std::condition_variable pendingCond;
+        std::condition_variable doneCond;
+        std::deque<Block *> pending;
+        std::vector<std::unique_ptr<Block>> blocks;
+        std::vector<Block *> freeBlocks;
+        bool stopping = false;
+        bool closed = false;
+        std::thread thread;
+
+        /** Scratch buffers of the writer thread */
+        std::vector<uint8_t> shuffled;
+        std::vector<uint8_t> compressed;
+    };
+
+    static Writer *writer;
+
+    /** Records per block */
+    const unsigned blockSize;
+
+    std::unique_ptr<uint8_t []> buf;
+    size_t bufSize;
+
+    /** Block being filled, the last record is the current instruction */
+    Block *block;
+
+    /** @{ Previous values of the delta encoded columns */
+    Tick lastTick;
+    Addr lastPc;
+    Addr lastAddr;
+    uint64_t lastData;
+    /** @} */
+    /** Result before the one of the current instruction */
+    uint64_t prevData;
+
+    /** Submit the current block to the writer */
+    void flush();
+
+    /** Start a new record for an instruction */
+    void traceInst(ThreadContext *tc, StaticInstPtr si, TheISA::PCState pc);
+
+    /** Add a memory access to the current instruction */
+    void traceMem(StaticInstPtr si, Addr a, Addr s, unsigned f);
+
+    /** Set the result of the current instruction */
+    void traceData(int status, uint64_t value);
+
+    friend class InstColTraceRecord;
+};
+
+} // namespace Trace
+
+#endif // __CPU_INST_COL_TRACE_HH__
@@ -45,8 +45,8 @@
 #define __CPU_MINOR_BUFFERS_HH__
 
 #include <iostream>
-#include <queue>
 #include <sstream>
+#include <vector>
 
 #include "base/logging.hh"
 #include "cpu/activity.hh"
@@ -387,6 +387,10 @@ class Reservable
  *  Handles capacity management, bubble value suppression and provides
  *  reporting.
  *
+ *  Elements are held in a ring of slots allocated when the queue is
+ *  constructed, so pushes and pops don't allocate.  The ring is only
+ *  grown if the queue is pushed beyond its capacity.
+ *
  *  In an ideal world, ElemType would be derived from ReportIF and BubbleIF,
  *  but here we use traits and allow the Adaptors ReportTraitsAdaptor and
  *  BubbleTraitsAdaptor to work on data which *does* directly implement
@@ -397,7 +401,14 @@ template <typename ElemType,
 class Queue : public Named, public Reservable
 {
   private:
-      std::deque<ElemType> queue;
+    /** Element storage.  Occupied slots run (circularly) from head */
+    std::vector<ElemType> slots;
+
+    /** Index in slots of the head element */
+    unsigned int head;
+
+    /** Number of occupied slots */
+    unsigned int numElems;
 
     /** Number of slots currently reserved for future (reservation
      *  respecting) pushes */
@@ -409,10 +420,35 @@ class Queue : public Named, public Reservable
     /** Name to use for the data in MinorTrace */
     std::string dataName;
 
+    /** Index in slots of the n-th element from the head */
+    unsigned int
+    slotIndex(unsigned int n) const
+    {
+        unsigned int index = head + n;
+
+        return (index >= slots.size() ? index - slots.size() : index);
+    }
+
+    /** Double the number of slots, keeping the elements in order */
+    void
+    grow()
+    {
+        std::vector<ElemType> new_slots(slots.size() * 2);
+
+        for (unsigned int i = 0; i < numElems; i++)
+            new_slots[i] = slots[slotIndex(i)];
+
+        slots.swap(new_slots);
+        head = 0;
+    }
+
   public:
     Queue(const std::string &name, const std::string &data_name,
         unsigned int capacity_) :
         Named(name),
+        slots(capacity_ == 0 ? 1 : capacity_),
+        head(0),
+        numElems(0),
         numReservedSlots(0),
         capacity(capacity_),
         dataName(data_name)
@@ -427,9 +463,12 @@ class Queue : public Named, public Reservable
     {
         if (!BubbleTraits::isBubble(data)) {
             freeReservation();
-            queue.push_back(data);
+            if (numElems == slots.size())
+                grow();
+            slots[slotIndex(numElems)] = data;
+            numElems++;
 
-            if (queue.size() > capacity) {
+            if (numElems > capacity) {
                 warn("%s: No space to push data into queue of capacity"
                     " %u, pushing anyway\n", name(), capacity);
             }
@@ -466,7 +505,7 @@ class Queue : public Named, public Reservable
     unsigned int totalSpace() const { return capacity; }
 
     /** Number of slots already occupied in this buffer */
-    unsigned int occupiedSpace() const { return queue.size(); }
+    unsigned int occupiedSpace() const { return numElems; }
 
     /** Number of slots which are reserved. */
     unsigned int reservedSpace() const { return numReservedSlots; }
@@ -476,7 +515,7 @@ class Queue : public Named, public Reservable
     unsigned int
     remainingSpace() const
     {
-        int ret = capacity - queue.size();
+        int ret = capacity - numElems;
 
         return (ret < 0 ? 0 : ret);
     }
@@ -485,21 +524,29 @@ class Queue : public Named, public Reservable
     unsigned int
     unreservedRemainingSpace() const
     {
-        int ret = capacity - (queue.size() + numReservedSlots);
+        int ret = capacity - (numElems + numReservedSlots);
 
         return (ret < 0 ? 0 : ret);
     }
 
     /** Head value.  Like std::queue::front */
-    ElemType &front() { return queue.front(); }
+    ElemType &front() { return slots[head]; }
 
-    const ElemType &front() const { return queue.front(); }
+    const ElemType &front() const { return slots[head]; }
 
-    /** Pop the head item.  Like std::queue::pop */
-    void pop() { queue.pop_front(); }
+    /** Pop the head item.  Like std::queue::pop.  The vacated slot is
+     *  reset so that it doesn't hold on to (reference counted) data */
+    void
+    pop()
+    {
+        assert(numElems != 0);
+        slots[head] = ElemType();
+        head = slotIndex(1);
+        numElems--;
+    }
 
     /** Is the queue empty? */
-    bool empty() const { return queue.empty(); }
+    bool empty() const { return numElems == 0; }
 
     void
     minorTrace() const
@@ -516,7 +563,8 @@ class Queue : public Named, public Reservable
         int num_printed = 1;
         /* Bodge to rotate queue to report elements */
         while (num_printed <= num_occupied) {
-            ReportTraits::reportData(data, queue[num_printed - 1]);
+            ReportTraits::reportData(data,
+                slots[slotIndex(num_printed - 1)]);
             num_printed++;
 
             if (num_printed <= num_total)
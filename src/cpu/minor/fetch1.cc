@@ -88,6 +88,8 @@ Fetch1::Fetch1(const std::string &name_,
             maxLineWidth);
     }
 
+    linePool.setLineWidth(maxLineWidth);
+
     /* These assertions should be copied to the Python config. as well */
     if ((lineSnap % sizeof(TheISA::MachInst)) != 0) {
         fatal("%s: fetch1LineSnapWidth must be a multiple "
@@ -219,7 +221,7 @@ Fetch1::FetchRequest::makePacket()
 {
     /* Make the necessary packet for a memory transaction */
     packet = new Packet(request, MemCmd::ReadReq);
-    packet->allocate();
+    packet->dataStatic(fetch.linePool.allocate());
 
     /* This FetchRequest becomes SenderState to allow the response to be
      *  identified */
@@ -265,8 +267,10 @@ Fetch1::handleTLBResponse(FetchRequestPtr response)
 
 Fetch1::FetchRequest::~FetchRequest()
 {
-    if (packet)
+    if (packet) {
+        fetch.linePool.release(packet->getPtr<uint8_t>());
         delete packet;
+    }
 }
 
 void
@@ -552,7 +556,7 @@ Fetch1::processResponse(Fetch1::FetchRequestPtr response,
             response->fault->name());
         thread.state = Fetch1::FetchWaitingForPC;
     } else {
-        line.adoptPacketData(packet);
+        line.adoptPacketData(packet, &linePool);
         /* Null the response's packet to prevent the response from trying to
          *  deallocate the packet */
         response->packet = NULL;
@@ -299,6 +299,10 @@ class Fetch1 : public Named
     /** Queue of in-memory system requests and responses */
     FetchQueue transfers;
 
+    /** Line data buffers for fetch packets.  Buffers are maxLineWidth
+     *  bytes and are returned by Fetch2 when it frees the line */
+    LineDataPool linePool;
+
     /** Retry state of icache_port */
     IcacheState icacheState;
 
@@ -45,6 +45,8 @@
 #ifndef __CPU_MINOR_NEW_LSQ_HH__
 #define __CPU_MINOR_NEW_LSQ_HH__
 
+#include <deque>
+
 #include "cpu/minor/buffers.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/minor/pipe_data.hh"
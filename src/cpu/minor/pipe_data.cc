@@ -159,6 +159,38 @@ operator <<(std::ostream &os, const BranchData &branch)
     return os;
 }
 
+LineDataPool::~LineDataPool()
+{
+    for (auto line : freeLines)
+        delete [] line;
+}
+
+void
+LineDataPool::setLineWidth(unsigned int line_width)
+{
+    assert(freeLines.empty());
+    lineWidth = line_width;
+}
+
+uint8_t *
+LineDataPool::allocate()
+{
+    assert(lineWidth != 0);
+
+    if (freeLines.empty())
+        return new uint8_t[lineWidth];
+
+    uint8_t *line = freeLines.back();
+    freeLines.pop_back();
+    return line;
+}
+
+void
+LineDataPool::release(uint8_t *line)
+{
+    freeLines.push_back(line);
+}
+
 void
 ForwardLineData::setFault(Fault fault_)
 {
@@ -180,9 +212,10 @@ ForwardLineData::allocateLine(unsigned int width_)
 }
 
 void
-ForwardLineData::adoptPacketData(Packet *packet)
+ForwardLineData::adoptPacketData(Packet *packet, LineDataPool *line_pool)
 {
     this->packet = packet;
+    linePool = line_pool;
     lineWidth = packet->req->getSize();
     bubbleFlag = false;
 
@@ -201,11 +234,14 @@ ForwardLineData::freeLine()
         /* If packet is not NULL then the line must belong to the packet so
          *  we don't need to separately deallocate the line */
         if (packet) {
+            if (linePool)
+                linePool->release(line);
             delete packet;
         } else {
             delete [] line;
         }
         line = NULL;
+        linePool = NULL;
         bubbleFlag = true;
     }
 }
@@ -50,6 +50,8 @@
 #ifndef __CPU_MINOR_PIPE_DATA_HH__
 #define __CPU_MINOR_PIPE_DATA_HH__
 
+#include <vector>
+
 #include "cpu/minor/buffers.hh"
 #include "cpu/minor/dyn_inst.hh"
 #include "cpu/base.hh"
@@ -164,6 +166,33 @@ std::ostream &operator <<(std::ostream &os, BranchData::Reason reason);
  *  for MinorTrace */
 std::ostream &operator <<(std::ostream &os, const BranchData &branch);
 
+/** Free list of fixed-size line data buffers.  Fetch1 reads lines into
+ *  buffers from here and they are given back when Fetch2 frees the line,
+ *  so, once the pool is warm, fetching a line doesn't allocate */
+class LineDataPool
+{
+  protected:
+    /** Size of each buffer in bytes */
+    unsigned int lineWidth;
+
+    /** Buffers not currently in use */
+    std::vector<uint8_t *> freeLines;
+
+  public:
+    LineDataPool() : lineWidth(0) { }
+
+    ~LineDataPool();
+
+    /** Set the buffer size.  Must be called before the first allocate */
+    void setLineWidth(unsigned int line_width);
+
+    /** Get a buffer of lineWidth bytes */
+    uint8_t *allocate();
+
+    /** Return a buffer from allocate */
+    void release(uint8_t *line);
+};
+
 /** Line fetch data in the forward direction.  Contains a single cache line
  *  (or fragment of a line), its address, a sequence number assigned when
  *  that line was fetched and a bubbleFlag that can allow ForwardLineData to
@@ -201,6 +230,9 @@ class ForwardLineData /* : public ReportIF, public BubbleIF */
     /** Packet from which the line is taken */
     Packet *packet;
 
+    /** Pool owning the packet's data, or NULL if the packet owns it */
+    LineDataPool *linePool;
+
   public:
     ForwardLineData() :
         bubbleFlag(true),
@@ -208,7 +240,8 @@ class ForwardLineData /* : public ReportIF, public BubbleIF */
         lineWidth(0),
         fault(NoFault),
         line(NULL),
-        packet(NULL)
+        packet(NULL),
+        linePool(NULL)
     {
         /* Make lines bubbles by default */
     }
@@ -227,8 +260,10 @@ class ForwardLineData /* : public ReportIF, public BubbleIF */
     void allocateLine(unsigned int width_);
 
     /** Use the data from a packet as line instead of allocating new
-     *  space.  On destruction of this object, the packet will be destroyed */
-    void adoptPacketData(Packet *packet);
+     *  space.  On destruction of this object, the packet will be destroyed.
+     *  If line_pool is given, the packet's data was allocated from it and
+     *  will be returned to it */
+    void adoptPacketData(Packet *packet, LineDataPool *line_pool = NULL);
 
     /** Free this ForwardLineData line.  Note that these are shared between
      *  line objects and so you must be careful when deallocating them.
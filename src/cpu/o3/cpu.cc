@@ -359,6 +359,7 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 template <class Impl>
 FullO3CPU<Impl>::~FullO3CPU()
 {
+    Impl::DynInst::releasePool();
 }
 
 template <class Impl>
@@ -43,6 +43,8 @@
 #define __CPU_O3_DYN_INST_HH__
 
 #include <array>
+#include <cstddef>
+#include <vector>
 
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
@@ -85,6 +87,23 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /**
+     * Dynamic instructions are created and destroyed at a very high
+     * rate. Rather than going through the general purpose allocator for
+     * each of them, they are carved out of large contiguous chunks and
+     * recycled through a free list. The pool grows to the largest number
+     * of instructions that were ever in flight at once, and its chunks
+     * are freed when the CPUs using it go away.
+     */
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
+    /**
+     * Free the pool of the calling thread once none of its instructions
+     * are in use anymore. Called when a CPU is destroyed.
+     */
+    static void releasePool();
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -98,6 +117,37 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     /** Initializes variables. */
     void initVars();
 
+    /** Number of instructions allocated together when the pool is empty. */
+    static constexpr size_t InstsPerChunk = 256;
+
+    /** Link stored in the storage of an instruction that is free. */
+    struct FreeInst
+    {
+        FreeInst *next;
+    };
+
+    /**
+     * Instructions of a host thread. The pool is per host thread so
+     * CPUs simulated by different threads never contend for it.
+     */
+    struct Pool
+    {
+        /** Instructions that can be reused */
+        FreeInst *freeInsts = nullptr;
+        std::vector<char *> chunks;
+        /** Instructions handed out and not deleted yet */
+        long live = 0;
+        /** Free the chunks as soon as no instruction is live */
+        bool release = false;
+
+        ~Pool() { freeChunks(); }
+
+        /** Free the chunks if none of their instructions is in use */
+        void freeChunks();
+    };
+
+    static thread_local Pool pool;
+
   protected:
     /** Explicitation of dependent names. */
     using BaseDynInst<Impl>::cpu;
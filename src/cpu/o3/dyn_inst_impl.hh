@@ -44,6 +44,85 @@
 #include "cpu/o3/dyn_inst.hh"
 #include "debug/O3PipeView.hh"
 
+template <class Impl>
+thread_local typename BaseO3DynInst<Impl>::Pool BaseO3DynInst<Impl>::pool;
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::Pool::freeChunks()
+{
+    // Instructions deleted by another thread than the one that created
+    // them throw the count off, in which case the chunks are leaked
+    // rather than freed under a live instruction.
+    if (live != 0)
+        return;
+
+    for (char *chunk : chunks)
+        ::operator delete(chunk);
+    chunks.clear();
+    freeInsts = nullptr;
+    release = false;
+}
+
+template <class Impl>
+void *
+BaseO3DynInst<Impl>::operator new(size_t size)
+{
+    // Classes deriving from this one are not pooled.
+    if (size != sizeof(BaseO3DynInst<Impl>))
+        return ::operator new(size);
+
+    static_assert(alignof(BaseO3DynInst<Impl>) <= alignof(std::max_align_t),
+                  "Pooled instructions need at most fundamental alignment");
+
+    Pool &p = pool;
+    if (!p.freeInsts) {
+        char *chunk = static_cast<char *>(::operator new(
+            sizeof(BaseO3DynInst<Impl>) * InstsPerChunk));
+        p.chunks.push_back(chunk);
+        // Thread the new instructions in address order so that
+        // consecutive allocations are adjacent in memory.
+        for (size_t i = InstsPerChunk; i-- > 0; ) {
+            FreeInst *inst = reinterpret_cast<FreeInst *>(
+                chunk + i * sizeof(BaseO3DynInst<Impl>));
+            inst->next = p.freeInsts;
+            p.freeInsts = inst;
+        }
+    }
+
+    FreeInst *inst = p.freeInsts;
+    p.freeInsts = inst->next;
+    p.live++;
+    return inst;
+}
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::operator delete(void *ptr, size_t size)
+{
+    if (size != sizeof(BaseO3DynInst<Impl>)) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    Pool &p = pool;
+    FreeInst *inst = static_cast<FreeInst *>(ptr);
+    inst->next = p.freeInsts;
+    p.freeInsts = inst;
+    if (--p.live == 0 && p.release)
+        p.freeChunks();
+}
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::releasePool()
+{
+    // Instructions still referenced by the CPU's stages are deleted after
+    // this, the last one frees the chunks.
+    pool.release = true;
+    pool.freeChunks();
+}
+
 template <class Impl>
 BaseO3DynInst<Impl>::BaseO3DynInst(const StaticInstPtr &staticInst,
                                    const StaticInstPtr &macroop,
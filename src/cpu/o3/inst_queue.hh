@@ -359,39 +359,31 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
+    static_assert(Num_OpClasses <= 64,
+                  "The ready op classes must fit in a 64-bit mask");
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Bitmask of the op classes that have ready instructions. */
+    uint64_t readyOpClasses;
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
-
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
+    /** Sequence number of the oldest ready instruction of each op class.
+     *  Only valid for the op classes set in readyOpClasses.
      */
-    ListOrderIt readyIt[Num_OpClasses];
+    InstSeqNum oldestReady[Num_OpClasses];
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Update the ready mask and oldest instruction of an op class after
+     *  its ready queue has changed.
+     */
+    void updateReadyOpClass(OpClass op_class);
 
     /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+     * Select the op class whose oldest ready instruction is the oldest
+     * among those younger than the given sequence number. Walking the
+     * op classes this way visits them in age order, one ready queue at
+     * a time.
+     * @param after Sequence number of the last instruction looked at.
+     * @return The selected op class or Num_OpClasses if there is none.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    OpClass nextReadyOpClass(InstSeqNum after) const;
 
     DependencyGraph<DynInstPtr> dependGraph;
 
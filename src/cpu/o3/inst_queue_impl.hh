@@ -45,6 +45,7 @@
 #include <limits>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "cpu/o3/fu_pool.hh"
 #include "cpu/o3/inst_queue.hh"
@@ -418,11 +419,9 @@ InstructionQueue<Impl>::resetState()
     for (int i = 0; i < Num_OpClasses; ++i) {
         while (!readyInsts[i].empty())
             readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
     }
+    readyOpClasses = 0;
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -559,7 +558,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
+    if (readyOpClasses) {
         return true;
     }
 
@@ -693,55 +692,32 @@ InstructionQueue<Impl>::getInstToExecute()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+InstructionQueue<Impl>::updateReadyOpClass(OpClass op_class)
 {
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
-
-    queue_entry.queueType = op_class;
-
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
+    if (readyInsts[op_class].empty()) {
+        readyOpClasses &= ~(1ULL << op_class);
+    } else {
+        readyOpClasses |= 1ULL << op_class;
+        oldestReady[op_class] = readyInsts[op_class].top()->seqNum;
     }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
 }
 
 template <class Impl>
-void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+OpClass
+InstructionQueue<Impl>::nextReadyOpClass(InstSeqNum after) const
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
+    OpClass next = Num_OpClasses;
+
+    for (uint64_t mask = readyOpClasses; mask; mask &= mask - 1) {
+        OpClass op_class = static_cast<OpClass>(ctz64(mask));
+        InstSeqNum oldest = oldestReady[op_class];
+        if (oldest > after &&
+            (next == Num_OpClasses || oldest < oldestReady[next])) {
+            next = op_class;
+        }
     }
 
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    return next;
 }
 
 template <class Impl>
@@ -796,15 +772,17 @@ InstructionQueue<Impl>::scheduleReadyInsts()
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    InstSeqNum last_seen = 0;
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    while (total_issued < totalWidth) {
+        OpClass op_class = nextReadyOpClass(last_seen);
+        if (op_class == Num_OpClasses)
+            break;
 
         assert(!readyInsts[op_class].empty());
 
         DynInstPtr issuing_inst = readyInsts[op_class].top();
+        last_seen = issuing_inst->seqNum;
 
         if (issuing_inst->isFloating()) {
             fpInstQueueReads++;
@@ -814,19 +792,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
+        assert(issuing_inst->seqNum == oldestReady[op_class]);
 
         if (issuing_inst->isSquashed()) {
             readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            updateReadyOpClass(op_class);
 
             ++iqSquashedInstsIssued;
 
@@ -888,13 +858,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     issuing_inst->seqNum);
 
             readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            updateReadyOpClass(op_class);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -913,23 +877,20 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
         }
     }
 
     numIssuedDist.sample(total_issued);
     iqInstsIssued+= total_issued;
 
-    // If we issued any instructions, tell the CPU we had activity.
-    // @todo If the way deferred memory instructions are handeled due to
-    // translation changes then the deferredMemInsts condition should be removed
-    // from the code below.
-    if (total_issued || !retryMemInsts.empty() || !deferredMemInsts.empty()) {
+    // If we issued any instructions, tell the CPU we had activity. Deferred
+    // memory instructions do not keep the CPU awake; the LSQ wakes it up
+    // when their delayed translation finishes.
+    if (total_issued || !retryMemInsts.empty()) {
         cpu->activityThisCycle();
     } else {
         DPRINTF(IQ, "Not able to schedule any instructions.\n");
@@ -1089,16 +1050,7 @@ InstructionQueue<Impl>::addReadyMemInst(const DynInstPtr &ready_inst)
     OpClass op_class = ready_inst->opClass();
 
     readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    updateReadyOpClass(op_class);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1459,16 +1411,7 @@ InstructionQueue<Impl>::addIfReady(const DynInstPtr &inst)
                 inst->pcState(), op_class, inst->seqNum);
 
         readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        updateReadyOpClass(op_class);
     }
 }
 
@@ -1504,17 +1447,14 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
     int i = 1;
 
     cprintf("List order: ");
 
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
+    for (OpClass op_class = nextReadyOpClass(0); op_class != Num_OpClasses;
+         op_class = nextReadyOpClass(oldestReady[op_class])) {
+        cprintf("%i OpClass:%i [sn:%llu] ", i, op_class,
+                oldestReady[op_class]);
         ++i;
     }
 
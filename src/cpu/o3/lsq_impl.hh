@@ -793,6 +793,11 @@ LSQ<Impl>::SingleDataRequest::finish(const Fault &fault, const RequestPtr &req,
 
         LSQRequest::_inst->fault = fault;
         LSQRequest::_inst->translationCompleted(true);
+
+        // The instruction waiting for this translation may have been
+        // deferred by the IQ while the CPU went to sleep.
+        if (this->isDelayed())
+            _port.wakeCPU();
     }
 }
 
@@ -820,6 +825,9 @@ LSQ<Impl>::SplitDataRequest::finish(const Fault &fault, const RequestPtr &req,
             flags.set(Flag::TranslationFinished);
             _inst->translationCompleted(true);
 
+            if (this->isDelayed())
+                _port.wakeCPU();
+
             for (i = 0; i < _fault.size() && _fault[i] == NoFault; i++);
             if (i > 0) {
                 _inst->physEffAddr = request(0)->getPaddr();
@@ -403,6 +403,9 @@ class LSQUnit
 
     BaseTLB* dTLB() { return cpu->dtb; }
 
+    /** Wake the CPU up, e.g. when a delayed translation finishes. */
+    void wakeCPU() { iewStage->wakeCPU(); }
+
   private:
     /** Pointer to the CPU. */
     O3CPU *cpu;
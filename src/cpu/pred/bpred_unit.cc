@@ -101,6 +101,9 @@ BPredUnit::regProbePoints()
 {
     ppBranches = pmuProbePoint("Branches");
     ppMisses = pmuProbePoint("Misses");
+
+    ppCommit = new ProbePointArg<CommittedBranch>(getProbeManager(),
+                                                  "Commit");
 }
 
 void
@@ -155,8 +158,9 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
             "Creating prediction history "
             "for PC %s\n", tid, seqNum, pc);
 
-    PredictorHistory predict_record(seqNum, pc.instAddr(), pred_taken,
-                                    bp_history, indirect_history, tid, inst);
+    PredictorHistory predict_record(seqNum, pc.instAddr(), pc.npc(),
+                                    pred_taken, bp_history, indirect_history,
+                                    tid, inst);
 
     // Now lookup in the BTB or RAS.
     if (pred_taken) {
@@ -295,6 +299,13 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
 
     while (!predHist[tid].empty() &&
            predHist[tid].back().seqNum <= done_sn) {
+        if (ppCommit->hasListeners()) {
+            const PredictorHistory &hist = predHist[tid].back();
+            ppCommit->notify(CommittedBranch{tid, hist.pc, hist.fallthrough,
+                                             hist.target, hist.predTaken,
+                                             hist.inst});
+        }
+
         // Update the branch predictor with the correct results.
         update(tid, predHist[tid].back().pc,
                     predHist[tid].back().predTaken,
@@ -68,6 +68,26 @@ class BPredUnit : public SimObject
      */
     BPredUnit(const Params *p);
 
+    /**
+     * A committed branch and its resolved outcome. This is the
+     * argument of the Commit probe point.
+     */
+    struct CommittedBranch
+    {
+        /** The thread the branch belongs to. */
+        ThreadID tid;
+        /** The PC of the branch. */
+        Addr pc;
+        /** The address of the next sequential instruction. */
+        Addr fallthrough;
+        /** The address of the instruction executed after the branch. */
+        Addr target;
+        /** Whether or not the branch was taken. */
+        bool taken;
+        /** The branch instruction. */
+        StaticInstPtr inst;
+    };
+
     void regProbePoints() override;
 
     /** Perform sanity checks after a drain. */
@@ -191,10 +211,12 @@ class BPredUnit : public SimObject
          * information needed to update the predictor, BTB, and RAS.
          */
         PredictorHistory(const InstSeqNum &seq_num, Addr instPC,
+                         Addr fallthrough_pc,
                          bool pred_taken, void *bp_history,
                          void *indirect_history, ThreadID _tid,
                          const StaticInstPtr & inst)
-            : seqNum(seq_num), pc(instPC), bpHistory(bp_history),
+            : seqNum(seq_num), pc(instPC), fallthrough(fallthrough_pc),
+              bpHistory(bp_history),
               indirectHistory(indirect_history), RASTarget(0), RASIndex(0),
               tid(_tid), predTaken(pred_taken), usedRAS(0), pushedRAS(0),
               wasCall(0), wasReturn(0), wasIndirect(0), target(MaxAddr),
@@ -211,6 +233,9 @@ class BPredUnit : public SimObject
         /** The PC associated with the sequence number. */
         Addr pc;
 
+        /** The address of the next sequential instruction. */
+        Addr fallthrough;
+
         /** Pointer to the history object passed back from the branch
          * predictor.  It is used to update or restore state of the
          * branch predictor.
@@ -336,6 +361,9 @@ class BPredUnit : public SimObject
     /** Miss-predicted branches */
     ProbePoints::PMUUPtr ppMisses;
 
+    /** Committed branches along with their outcome */
+    ProbePointArg<CommittedBranch> *ppCommit;
+
     /** @} */
 };
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_info_pool.hh"
+
+#include <new>
+
+thread_local PooledBranchInfo::Pool PooledBranchInfo::pool;
+
+PooledBranchInfo::Pool::~Pool()
+{
+    for (auto &list : freeInfos) {
+        while (list) {
+            FreeInfo *info = list;
+            list = info->next;
+            ::operator delete(info);
+        }
+    }
+    released = true;
+}
+
+void *
+PooledBranchInfo::operator new(size_t size)
+{
+    const size_t idx = (size + Granularity - 1) / Granularity - 1;
+    if (idx >= NumSizes)
+        return ::operator new(size);
+
+    Pool &p = pool;
+    FreeInfo *info = p.freeInfos[idx];
+    if (!info)
+        return ::operator new((idx + 1) * Granularity);
+
+    p.freeInfos[idx] = info->next;
+    return info;
+}
+
+void
+PooledBranchInfo::operator delete(void *ptr, size_t size)
+{
+    const size_t idx = (size + Granularity - 1) / Granularity - 1;
+    Pool &p = pool;
+    // Records deleted after the pool of the thread went away, e.g., by
+    // predictors destroyed late during exit, are not kept.
+    if (idx >= NumSizes || p.released) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeInfo *info = static_cast<FreeInfo *>(ptr);
+    info->next = p.freeInfos[idx];
+    p.freeInfos[idx] = info;
+}
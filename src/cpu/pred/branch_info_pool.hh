@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_BRANCH_INFO_POOL_HH__
+#define __CPU_PRED_BRANCH_INFO_POOL_HH__
+
+#include <cstddef>
+
+/**
+ * Base class for the per-branch history records of the branch
+ * predictors. Predictors like TAGE-SC-L create several of these for
+ * every predicted branch and delete them again when the branch is
+ * committed or squashed. Rather than going through the general
+ * purpose allocator each time, deleted records are kept on per-size
+ * free lists of the host thread and handed out again. The lists grow
+ * to the largest number of records that were ever in flight at once.
+ *
+ * Classes deriving from this one must have a virtual destructor if
+ * they are deleted through a pointer to a base class, so that the
+ * record is returned to the list of its actual size.
+ */
+class PooledBranchInfo
+{
+  public:
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
+  private:
+    /** Sizes are rounded up to a multiple of this. */
+    static constexpr size_t Granularity = alignof(std::max_align_t);
+    /** Number of free lists, larger records are not pooled. */
+    static constexpr size_t NumSizes = 32;
+
+    /** Link stored in the storage of a record that is free. */
+    struct FreeInfo
+    {
+        FreeInfo *next;
+    };
+
+    struct Pool
+    {
+        /** Free records, indexed by size class */
+        FreeInfo *freeInfos[NumSizes] = {};
+        /** Set once the lists have been freed at thread exit */
+        bool released = false;
+
+        ~Pool();
+    };
+
+    static thread_local Pool pool;
+};
+
+#endif // __CPU_PRED_BRANCH_INFO_POOL_HH__
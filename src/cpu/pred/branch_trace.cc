@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace.hh"
+
+#include "arch/types.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "config/the_isa.hh"
+#include "cpu/base.hh"
+#include "params/BranchTraceRecorder.hh"
+#include "params/BranchTraceReplayer.hh"
+#include "proto/branch.pb.h"
+#include "sim/sim_exit.hh"
+
+namespace
+{
+
+/**
+ * Control instruction standing in for a traced branch. It only
+ * carries the flags the branch predictors look at.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint32_t branch_flags)
+        : StaticInst("trace branch", nullMachInst, No_OpClass)
+    {
+        typedef ProtoMessage::Branch Branch;
+
+        flags[IsControl] = true;
+        flags[IsCondControl] = branch_flags & Branch::Cond;
+        flags[IsUncondControl] = !(branch_flags & Branch::Cond);
+        flags[IsIndirectControl] = branch_flags & Branch::Indirect;
+        flags[IsDirectControl] = !(branch_flags & Branch::Indirect);
+        flags[IsCall] = branch_flags & Branch::Call;
+        flags[IsReturn] = branch_flags & Branch::Return;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Trace branches can't be executed.\n");
+    }
+
+    void
+    advancePC(TheISA::PCState &pcState) const override
+    {
+        pcState.advance();
+    }
+
+    std::string
+    generateDisassembly(Addr pc,
+            const Loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+
+  private:
+    static TheISA::ExtMachInst nullMachInst;
+};
+
+TheISA::ExtMachInst TraceBranchInst::nullMachInst;
+
+} // anonymous namespace
+
+BranchTraceRecorder::BranchTraceRecorder(
+        const BranchTraceRecorderParams *p)
+    : ProbeListenerObject(p),
+      traceStream(nullptr),
+      cpu(p->cpu),
+      lastInsts(0)
+{
+    std::string filename;
+    if (p->trace_file != "") {
+        // If the trace file is not specified as an absolute path,
+        // append the current simulation output directory
+        filename = simout.resolve(p->trace_file);
+
+        const std::string suffix = ".gz";
+        // If trace_compress has been set, check the suffix. Append
+        // accordingly.
+        if (p->trace_compress &&
+            filename.compare(filename.size() - suffix.size(), suffix.size(),
+                             suffix) != 0)
+            filename = filename + suffix;
+    } else {
+        // Generate a filename from the name of the SimObject. Append .trc
+        // and .gz if we want compression enabled.
+        filename = simout.resolve(name() + ".trc" +
+                                  (p->trace_compress ? ".gz" : ""));
+    }
+
+    traceStream = new ProtoOutputStream(filename);
+
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback([this]() { closeStreams(); });
+}
+
+void
+BranchTraceRecorder::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTraceRecorder,
+                             BPredUnit::CommittedBranch> BranchListener;
+    listeners.push_back(new BranchListener(this, "Commit",
+                &BranchTraceRecorder::recordBranch));
+}
+
+void
+BranchTraceRecorder::startup()
+{
+    ProtoMessage::BranchHeader header_msg;
+    header_msg.set_obj_id(name());
+    traceStream->write(header_msg);
+
+    lastInsts = cpu->totalInsts();
+}
+
+void
+BranchTraceRecorder::closeStreams()
+{
+    if (traceStream != NULL)
+        delete traceStream;
+    traceStream = NULL;
+}
+
+void
+BranchTraceRecorder::recordBranch(const BPredUnit::CommittedBranch &branch)
+{
+    typedef ProtoMessage::Branch Branch;
+
+    uint32_t flags = Branch::None;
+    if (branch.inst->isCondCtrl())
+        flags |= Branch::Cond;
+    if (branch.inst->isIndirectCtrl())
+        flags |= Branch::Indirect;
+    if (branch.inst->isCall())
+        flags |= Branch::Call;
+    if (branch.inst->isReturn())
+        flags |= Branch::Return;
+
+    const Counter insts = cpu->totalInsts();
+
+    Branch branch_msg;
+    branch_msg.set_pc(branch.pc);
+    branch_msg.set_target(branch.target);
+    branch_msg.set_fallthrough(branch.fallthrough);
+    branch_msg.set_taken(branch.taken);
+    if (flags != Branch::None)
+        branch_msg.set_flags(flags);
+    if (insts - lastInsts != 1)
+        branch_msg.set_inst_delta(insts - lastInsts);
+
+    lastInsts = insts;
+
+    traceStream->write(branch_msg);
+}
+
+BranchTraceReplayer::BranchTraceReplayerStats::BranchTraceReplayerStats(
+        Stats::Group *parent)
+    : Stats::Group(parent),
+      ADD_STAT(branches, "Number of replayed branches"),
+      ADD_STAT(condBranches, "Number of replayed conditional branches"),
+      ADD_STAT(mispredicted, "Number of mispredicted branches"),
+      ADD_STAT(condMispredicted,
+               "Number of mispredicted conditional branches"),
+      ADD_STAT(insts, "Number of instructions covered by the trace"),
+      ADD_STAT(mpki, "Mispredictions per thousand instructions",
+               mispredicted / insts * 1000),
+      ADD_STAT(accuracy, "Fraction of correctly predicted branches",
+               (branches - mispredicted) / branches)
+{
+    mpki.precision(4);
+    accuracy.precision(6);
+}
+
+BranchTraceReplayer::BranchTraceReplayer(
+        const BranchTraceReplayerParams *p)
+    : SimObject(p),
+      branchPred(p->branch_pred),
+      trace(p->trace_file),
+      replayEvent([this]{ replay(); }, name()),
+      seqNum(0),
+      stats(this)
+{
+}
+
+void
+BranchTraceReplayer::startup()
+{
+    ProtoMessage::BranchHeader header_msg;
+    if (!trace.read(header_msg))
+        fatal("Failed to read the header of branch trace %s.\n", name());
+
+    schedule(replayEvent, curTick());
+}
+
+const StaticInstPtr &
+BranchTraceReplayer::branchInst(uint32_t flags)
+{
+    StaticInstPtr &inst = branchInsts[flags & (branchInsts.size() - 1)];
+    if (!inst)
+        inst = new TraceBranchInst(flags);
+    return inst;
+}
+
+void
+BranchTraceReplayer::replay()
+{
+    const ThreadID tid = 0;
+
+    ProtoMessage::Branch msg;
+    while (trace.read(msg)) {
+        const StaticInstPtr &inst = branchInst(msg.flags());
+        const InstSeqNum seq_num = ++seqNum;
+
+        // Fetch would have set up the next PC as the next sequential
+        // instruction, which is what the return address of a call is
+        // derived from.
+        TheISA::PCState pc(msg.pc());
+        pc.npc(msg.fallthrough());
+
+        branchPred->predict(inst, seq_num, pc, tid);
+
+        if (pc.instAddr() != msg.target()) {
+            ++stats.mispredicted;
+            if (inst->isCondCtrl())
+                ++stats.condMispredicted;
+
+            branchPred->squash(seq_num, TheISA::PCState(msg.target()),
+                               msg.taken(), tid);
+        }
+
+        branchPred->update(seq_num, tid);
+
+        ++stats.branches;
+        if (inst->isCondCtrl())
+            ++stats.condBranches;
+        stats.insts += msg.inst_delta();
+    }
+
+    exitSimLoop("end of branch trace reached");
+}
+
+BranchTraceRecorder *
+BranchTraceRecorderParams::create()
+{
+    return new BranchTraceRecorder(this);
+}
+
+BranchTraceReplayer *
+BranchTraceReplayerParams::create()
+{
+    return new BranchTraceReplayer(this);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Recording and replaying of committed branch traces. The recorder
+ * listens to the Commit probe of a branch predictor in any CPU model
+ * and writes the resolved branches to a protobuf trace. The replayer
+ * feeds such a trace straight through a branch predictor without
+ * simulating a CPU, which makes it cheap to sweep predictor
+ * configurations.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_HH__
+#define __CPU_PRED_BRANCH_TRACE_HH__
+
+#include <array>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/static_inst.hh"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+class BaseCPU;
+struct BranchTraceRecorderParams;
+struct BranchTraceReplayerParams;
+
+class BranchTraceRecorder : public ProbeListenerObject
+{
+  public:
+    BranchTraceRecorder(const BranchTraceRecorderParams *params);
+
+    /** Register the probe listeners. */
+    void regProbeListeners() override;
+
+    void startup() override;
+
+  protected:
+    /** Write a committed branch to the trace. */
+    void recordBranch(const BPredUnit::CommittedBranch &branch);
+
+    /**
+     * Callback to flush and close the output stream on exit. If we
+     * were calling the destructor it could be done there.
+     */
+    void closeStreams();
+
+    /** Trace output stream */
+    ProtoOutputStream *traceStream;
+
+    /** CPU whose instruction count is recorded along the branches. */
+    BaseCPU *cpu;
+
+    /** Instruction count of the CPU at the last recorded branch. */
+    Counter lastInsts;
+};
+
+class BranchTraceReplayer : public SimObject
+{
+  public:
+    BranchTraceReplayer(const BranchTraceReplayerParams *params);
+
+    void startup() override;
+
+  protected:
+    /** Replay the whole trace through the branch predictor. */
+    void replay();
+
+    /**
+     * Get a synthetic control instruction with the properties given
+     * by a mask of ProtoMessage::Branch::BranchFlags.
+     */
+    const StaticInstPtr &branchInst(uint32_t flags);
+
+    /** The branch predictor under test. */
+    BPredUnit *branchPred;
+
+    /** Trace input stream */
+    ProtoInputStream trace;
+
+    /** Event that replays the trace. */
+    EventFunctionWrapper replayEvent;
+
+    /** Sequence number of the last replayed branch. */
+    InstSeqNum seqNum;
+
+    /** Synthetic instructions, one per combination of branch flags. */
+    std::array<StaticInstPtr, 16> branchInsts;
+
+    struct BranchTraceReplayerStats : public Stats::Group
+    {
+        BranchTraceReplayerStats(Stats::Group *parent);
+
+        /** Number of replayed branches. */
+        Stats::Scalar branches;
+        /** Number of replayed conditional branches. */
+        Stats::Scalar condBranches;
+        /** Number of branches that were mispredicted. */
+        Stats::Scalar mispredicted;
+        /** Number of conditional branches that were mispredicted. */
+        Stats::Scalar condMispredicted;
+        /** Number of instructions covered by the trace. */
+        Stats::Scalar insts;
+        /** Mispredictions per thousand instructions. */
+        Stats::Formula mpki;
+        /** Fraction of branches that were predicted correctly. */
+        Stats::Formula accuracy;
+    } stats;
+};
+
+#endif // __CPU_PRED_BRANCH_TRACE_HH__
@@ -36,6 +36,7 @@
 
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "cpu/pred/branch_info_pool.hh"
 #include "sim/sim_object.hh"
 
 struct LoopPredictorParams;
@@ -119,7 +120,7 @@ class LoopPredictor : public SimObject
     }
   public:
     // Primary branch history entry
-    struct BranchInfo
+    struct BranchInfo : public PooledBranchInfo
     {
         uint16_t loopTag;
         uint16_t currentIter;
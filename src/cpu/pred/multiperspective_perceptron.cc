@@ -38,6 +38,8 @@
 
 #include "cpu/pred/multiperspective_perceptron.hh"
 
+#include <algorithm>
+
 #include "base/random.hh"
 #include "debug/Branch.hh"
 
@@ -100,6 +102,8 @@ MultiperspectivePerceptron::ThreadData::ThreadData(int num_filters,
 
     for (int i = 0; i < table_sizes.size(); i += 1) {
         mpreds.push_back(0);
+        bestPairs.push_back(BestPair());
+        isBest.push_back(false);
         tables.push_back(std::vector<short int>(table_sizes[i]));
         sign_bits.push_back(std::vector<std::array<bool, 2>>(table_sizes[i]));
         for (int j = 0; j < table_sizes[i]; j += 1) {
@@ -243,28 +247,21 @@ MultiperspectivePerceptron::computeBits(int num_filter_entries,
 }
 
 void
-MultiperspectivePerceptron::findBest(ThreadID tid,
-                                     std::vector<int> &best_preds) const
+MultiperspectivePerceptron::findBest(ThreadID tid) const
 {
+    ThreadData &td = *threadData[tid];
+    std::fill(td.isBest.begin(), td.isBest.end(), false);
     if (threshold < 0) {
         return;
     }
-    struct BestPair {
-        int index;
-        int mpreds;
-        bool operator<(BestPair const &bp) const
-        {
-            return mpreds < bp.mpreds;
-        }
-    };
-    std::vector<BestPair> pairs(best_preds.size());
-    for (int i = 0; i < best_preds.size(); i += 1) {
+    std::vector<ThreadData::BestPair> &pairs = td.bestPairs;
+    for (int i = 0; i < pairs.size(); i += 1) {
         pairs[i].index = i;
-        pairs[i].mpreds = threadData[tid]->mpreds[i];
+        pairs[i].mpreds = td.mpreds[i];
     }
     std::sort(pairs.begin(), pairs.end());
-    for (int i = 0; i < (std::min(nbest, (int) best_preds.size())); i += 1) {
-        best_preds[i] = pairs[i].index;
+    for (int i = 0; i < (std::min(nbest, (int) pairs.size())); i += 1) {
+        td.isBest[pairs[i].index] = true;
     }
 }
 
@@ -302,9 +299,6 @@ MultiperspectivePerceptron::getIndex(ThreadID tid, const MPPBranchInfo &bi,
 int
 MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
 {
-    // list of best predictors
-    std::vector<int> best_preds(specs.size(), -1);
-
     // initialize sum
     bi.yout = 0;
 
@@ -323,7 +317,8 @@ MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
     }
     // find the best subset of features to use in case of a low-confidence
     // branch
-    findBest(tid, best_preds);
+    findBest(tid);
+    const std::vector<bool> &is_best = threadData[tid]->isBest;
 
     // begin computation of the sum for low-confidence branch
     int bestval = 0;
@@ -345,16 +340,8 @@ MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
         // add the value
         bi.yout += val;
         // if this is one of those good features, add the value to bestval
-        if (threshold >= 0) {
-            for (int j = 0;
-                 j < std::min(nbest, (int) best_preds.size());
-                 j += 1)
-            {
-                if (best_preds[j] == i) {
-                    bestval += val;
-                    break;
-                }
-            }
+        if (is_best[i]) {
+            bestval += val;
         }
     }
     // apply a fudge factor to affect when training is triggered
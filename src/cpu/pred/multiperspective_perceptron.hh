@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/branch_info_pool.hh"
 #include "params/MultiperspectivePerceptron.hh"
 
 class MultiperspectivePerceptron : public BPredUnit
@@ -51,7 +52,7 @@ class MultiperspectivePerceptron : public BPredUnit
     /**
      * Branch information data
      */
-    class MPPBranchInfo {
+    class MPPBranchInfo : public PooledBranchInfo {
         /** pc of the branch */
         const unsigned int pc;
         /** pc of the branch, shifted 2 bits to the right */
@@ -115,6 +116,9 @@ class MultiperspectivePerceptron : public BPredUnit
         filtered(false), prediction(false), yout(0)
         { }
 
+        virtual ~MPPBranchInfo()
+        { }
+
         unsigned int getPC() const
         {
             return pc;
@@ -342,6 +346,20 @@ class MultiperspectivePerceptron : public BPredUnit
         int occupancy;
 
         std::vector<int> mpreds;
+
+        /** Scratch space for findBest, sized once at construction */
+        struct BestPair {
+            int index;
+            int mpreds;
+            bool operator<(BestPair const &bp) const
+            {
+                return mpreds < bp.mpreds;
+            }
+        };
+        std::vector<BestPair> bestPairs;
+        /** Per-table flag set by findBest for the selected tables */
+        std::vector<bool> isBest;
+
         std::vector<std::vector<short int>> tables;
         std::vector<std::vector<std::array<bool, 2>>> sign_bits;
     };
@@ -438,12 +456,10 @@ class MultiperspectivePerceptron : public BPredUnit
             const HistorySpec &spec, int index) const;
     /**
      * Finds the best subset of features to use in case of a low-confidence
-     * branch, returns the result as an ordered vector of the indices to the
-     * predictor tables
+     * branch, the result is left in the per-thread isBest flags
      * @param tid Thread ID of the branch
-     * @param vector to write the ordered list of indices of the best tables
      */
-    void findBest(ThreadID tid, std::vector<int> &best_preds) const;
+    void findBest(ThreadID tid) const;
 
     /**
      * Computes the output of the predictor for a given branch and the
@@ -44,6 +44,7 @@
 
 #include "base/statistics.hh"
 #include "base/types.hh"
+#include "cpu/pred/branch_info_pool.hh"
 #include "cpu/static_inst.hh"
 #include "sim/sim_object.hh"
 
@@ -189,13 +190,16 @@ class StatisticalCorrector : public SimObject
     } stats;
 
   public:
-    struct BranchInfo
+    struct BranchInfo : public PooledBranchInfo
     {
         BranchInfo() : lowConf(false), highConf(false), altConf(false),
               medConf(false), scPred(false), lsum(0), thres(0),
               predBeforeSC(false), usedScPred(false)
         {}
 
+        virtual ~BranchInfo()
+        {}
+
         // confidences calculated on tage and used on the statistical
         // correction
         bool lowConf;
@@ -52,6 +52,7 @@
 
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/branch_info_pool.hh"
 #include "cpu/pred/tage_base.hh"
 #include "params/TAGE.hh"
 
@@ -60,7 +61,7 @@ class TAGE: public BPredUnit
   protected:
     TAGEBase *tage;
 
-    struct TageBranchInfo {
+    struct TageBranchInfo : public PooledBranchInfo {
         TAGEBase::BranchInfo *tageBranchInfo;
 
         TageBranchInfo(TAGEBase &tage) : tageBranchInfo(tage.makeBranchInfo())
@@ -72,11 +72,34 @@ TAGEBase::TAGEBase(const TAGEBaseParams *p)
     }
 }
 
+TAGEBase::~TAGEBase()
+{
+    for (int *storage : infoStoragePool)
+        delete[] storage;
+}
+
 TAGEBase::BranchInfo*
 TAGEBase::makeBranchInfo() {
     return new BranchInfo(*this);
 }
 
+int *
+TAGEBase::allocInfoStorage()
+{
+    if (infoStoragePool.empty()) {
+        return new int [(nHistoryTables + 1) * 5];
+    }
+    int *storage = infoStoragePool.back();
+    infoStoragePool.pop_back();
+    return storage;
+}
+
+void
+TAGEBase::releaseInfoStorage(int *storage)
+{
+    infoStoragePool.push_back(storage);
+}
+
 void
 TAGEBase::init()
 {
@@ -51,6 +51,7 @@
 #include <vector>
 
 #include "base/statistics.hh"
+#include "cpu/pred/branch_info_pool.hh"
 #include "cpu/static_inst.hh"
 #include "params/TAGEBase.hh"
 #include "sim/sim_object.hh"
@@ -59,6 +60,7 @@ class TAGEBase : public SimObject
 {
   public:
     TAGEBase(const TAGEBaseParams *p);
+    ~TAGEBase();
     void init() override;
 
   protected:
@@ -117,7 +119,7 @@ class TAGEBase : public SimObject
     };
 
     // Primary branch history entry
-    struct BranchInfo
+    struct BranchInfo : public PooledBranchInfo
     {
         int pathHist;
         int ptGhist;
@@ -134,9 +136,10 @@ class TAGEBase : public SimObject
         bool pseudoNewAlloc;
         Addr branchPC;
 
-        // Pointer to dynamically allocated storage
-        // to save table indices and folded histories.
-        // To do one call to new instead of five.
+        // Pointer to storage to save table indices and folded
+        // histories. Blocks are recycled through the owning
+        // TAGEBase so that in steady state no allocation is done
+        // per predicted branch.
         int *storage;
 
         // Pointers to actual saved array within the dynamically
@@ -150,7 +153,10 @@ class TAGEBase : public SimObject
         // for stats purposes
         unsigned provider;
 
-        BranchInfo(const TAGEBase &tage)
+        // Owner of the storage block
+        TAGEBase &tage;
+
+        BranchInfo(TAGEBase &tage)
             : pathHist(0), ptGhist(0),
               hitBank(0), hitBankIndex(0),
               altBank(0), altBankIndex(0),
@@ -158,10 +164,10 @@ class TAGEBase : public SimObject
               tagePred(false), altTaken(false),
               condBranch(false), longestMatchPred(false),
               pseudoNewAlloc(false), branchPC(0),
-              provider(-1)
+              provider(-1), tage(tage)
         {
             int sz = tage.nHistoryTables + 1;
-            storage = new int [sz * 5];
+            storage = tage.allocInfoStorage();
             tableIndices = storage;
             tableTags = storage + sz;
             ci = tableTags + sz;
@@ -171,7 +177,7 @@ class TAGEBase : public SimObject
 
         virtual ~BranchInfo()
         {
-            delete[] storage;
+            tage.releaseInfoStorage(storage);
         }
     };
 
@@ -482,6 +488,19 @@ class TAGEBase : public SimObject
 
     bool initialized;
 
+    /**
+     * Free list of BranchInfo storage blocks. Each block holds
+     * 5 * (nHistoryTables + 1) ints.
+     */
+    std::vector<int *> infoStoragePool;
+
+    /** Get a storage block for a BranchInfo, reusing a freed one
+     * if possible. */
+    int *allocInfoStorage();
+
+    /** Return a BranchInfo storage block to the free list. */
+    void releaseInfoStorage(int *storage);
+
     struct TAGEBaseStats : public Stats::Group {
         TAGEBaseStats(Stats::Group *parent, unsigned nHistoryTables);
         // stats
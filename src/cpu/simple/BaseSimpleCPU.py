@@ -50,3 +50,7 @@ class BaseSimpleCPU(BaseCPU):
             exit(1)
 
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
+
+    decoded_block_cache_entries = Param.Unsigned(8192, "Entries in the "
+        "cache of decoded instructions, only used by ISAs with stateless "
+        "decoders (0 to disable it)")
@@ -48,6 +48,12 @@ class NonCachingSimpleCPU(AtomicSimpleCPU):
     type = 'NonCachingSimpleCPU'
     cxx_header = "cpu/simple/noncaching.hh"
 
+    backdoor_access = Param.Bool(False, "Make instruction fetches and "
+        "data accesses to memory, including LL/SC and atomics, straight "
+        "on the backing store. This is faster and lets CPUs on different "
+        "event queues access memory in parallel, but these accesses are "
+        "no longer counted in the memories' statistics")
+
     @classmethod
     def memory_mode(cls):
         return 'atomic_noncaching'
@@ -277,6 +277,21 @@ AtomicSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
     return port.sendAtomic(pkt);
 }
 
+Tick
+AtomicSimpleCPU::fetchInstMem()
+{
+    Packet pkt = Packet(ifetch_req, MemCmd::ReadReq);
+
+    // ifetch_req is initialized to read the instruction
+    // directly into the CPU object's inst field.
+    pkt.dataStatic(&inst);
+
+    Tick latency = sendPacket(icachePort, &pkt);
+    assert(!pkt.isError());
+
+    return latency;
+}
+
 Tick
 AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
 {
@@ -365,6 +380,13 @@ AtomicSimpleCPU::genMemFragmentRequest(const RequestPtr& req, Addr frag_addr,
     return predicate;
 }
 
+Tick
+AtomicSimpleCPU::localAccess(const RequestPtr &req, PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(deviceEventQueue());
+    return req->localAccessor(threadInfo[curThread]->thread->getTC(), pkt);
+}
+
 Fault
 AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
                          Request::Flags flags,
@@ -406,7 +428,7 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
             pkt.dataStatic(data);
 
             if (req->isLocalAccess()) {
-                dcache_latency += req->localAccessor(thread->getTC(), &pkt);
+                dcache_latency += localAccess(req, &pkt);
             } else {
                 dcache_latency += sendPacket(dcachePort, &pkt);
             }
@@ -511,8 +533,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                 pkt.dataStatic(data);
 
                 if (req->isLocalAccess()) {
-                    dcache_latency +=
-                        req->localAccessor(thread->getTC(), &pkt);
+                    dcache_latency += localAccess(req, &pkt);
                 } else {
                     dcache_latency += sendPacket(dcachePort, &pkt);
 
@@ -607,7 +628,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
         pkt.dataStatic(data);
 
         if (req->isLocalAccess())
-            dcache_latency += req->localAccessor(thread->getTC(), &pkt);
+            dcache_latency += localAccess(req, &pkt);
         else {
             dcache_latency += sendPacket(dcachePort, &pkt);
         }
@@ -691,15 +712,7 @@ AtomicSimpleCPU::tick()
                 //if (decoder.needMoreBytes())
                 //{
                     icache_access = true;
-                    Packet ifetch_pkt = Packet(ifetch_req, MemCmd::ReadReq);
-                    ifetch_pkt.dataStatic(&inst);
-
-                    icache_latency = sendPacket(icachePort, &ifetch_pkt);
-
-                    assert(!ifetch_pkt.isError());
-
-                    // ifetch_req is initialized to read the instruction directly
-                    // into the CPU object's inst field.
+                    icache_latency = fetchInstMem();
                 //}
             }
 
@@ -68,6 +68,22 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     // main simulation loop (one cycle)
     void tick();
 
+    /**
+     * Get a pointer to the event queue owning devices.
+     *
+     * CPUs that are fast-forwarded in parallel run on event queues of
+     * their own, while devices, interrupt controllers and the memory
+     * system stay on the system's queue. We need to temporarily
+     * migrate to this queue when accessing them.
+     */
+    EventQueue *deviceEventQueue() const { return system->eventQueue(); }
+
+    /**
+     * Perform an access that the request handles locally, e.g., one to
+     * the interrupt controller.
+     */
+    Tick localAccess(const RequestPtr &req, PacketPtr pkt);
+
     /**
      * Check if a system is in a drained state.
      *
@@ -103,6 +119,15 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     virtual Tick sendPacket(RequestPort &port, const PacketPtr &pkt);
 
+    /**
+     * Fetch the instruction described by ifetch_req into the inst
+     * member. CPU models which can reach the backing store directly
+     * may override this to avoid building a packet for every fetch.
+     *
+     * @return The latency of the instruction fetch.
+     */
+    virtual Tick fetchInstMem();
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
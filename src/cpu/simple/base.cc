@@ -41,9 +41,11 @@
 
 #include "cpu/simple/base.hh"
 
+#include "arch/isa_traits.hh"
 #include "arch/utility.hh"
 #include "base/cprintf.hh"
 #include "base/inifile.hh"
+#include "base/intmath.hh"
 #include "base/loader/symtab.hh"
 #include "base/logging.hh"
 #include "base/pollevent.hh"
@@ -88,6 +90,8 @@ BaseSimpleCPU::BaseSimpleCPU(BaseSimpleCPUParams *p)
       inst(),
       _status(Idle)
 {
+    setCustomReset();
+
     SimpleThread *thread;
 
     for (unsigned i = 0; i < numThreads; i++) {
@@ -103,6 +107,14 @@ BaseSimpleCPU::BaseSimpleCPU(BaseSimpleCPUParams *p)
         threadContexts.push_back(tc);
     }
 
+    if (TheISA::StatelessDecoder && p->decoded_block_cache_entries) {
+        fatal_if(!isPowerOf2(p->decoded_block_cache_entries),
+                 "%s: decoded_block_cache_entries must be a power of 2\n",
+                 name());
+        blockCache.reset(new DecodedBlockCache<TheISA::MachInst>(
+                    p->decoded_block_cache_entries));
+    }
+
     if (p->checker) {
         if (numThreads != 1)
             fatal("Checker currently does not support SMT");
@@ -424,6 +436,10 @@ change_thread_state(ThreadID tid, int activate, int priority)
 void
 BaseSimpleCPU::wakeup(ThreadID tid)
 {
+    // Devices wake up the CPU from their own event queue, which may be
+    // served by another host thread.
+    EventQueue::ScopedMigration migrate(eventQueue());
+
     getCpuAddrMonitor(tid)->gotWakeup = true;
 
     if (threadInfo[tid]->thread->status() == ThreadContext::Suspended) {
@@ -451,7 +467,17 @@ BaseSimpleCPU::checkForInterrupts()
     ThreadContext* tc = thread->getTC();
 
     if (checkInterrupts(curThread)) {
-        Fault interrupt = interrupts[curThread]->getInterrupt();
+        Fault interrupt;
+        {
+            // Devices post interrupts from the event queue of the
+            // interrupt controller, which needn't be the CPU's.
+            EventQueue::ScopedMigration migrate(
+                interrupts[curThread]->eventQueue());
+
+            interrupt = interrupts[curThread]->getInterrupt();
+            if (interrupt != NoFault && !t_info.inHtmTransactionalState())
+                interrupts[curThread]->updateIntrInfo();
+        }
 
         if (interrupt != NoFault) {
             // hardware transactional memory
@@ -466,7 +492,6 @@ BaseSimpleCPU::checkForInterrupts()
             }
 
             t_info.fetchOffset = 0;
-            interrupts[curThread]->updateIntrInfo();
             interrupt->invoke(tc);
             thread->decoder.reset();
         }
@@ -520,17 +545,25 @@ BaseSimpleCPU::preExecute()
 
         TheISA::Decoder *decoder = &(thread->decoder);
 
-        //Predecode, ie bundle up an ExtMachInst
-        //If more fetch data is needed, pass it in.
-        Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
-        //if (decoder->needMoreBytes())
-            decoder->moreBytes(pcState, fetchPC, inst);
-        //else
-        //    decoder->process();
-
-        //Decode an instruction if one is ready. Otherwise, we'll have to
-        //fetch beyond the MachInst at the current pc.
-        instPtr = decoder->decode(pcState);
+        //Look for the instruction in the decoded block cache first
+        if (blockCache)
+            instPtr = blockCache->lookup(pcState.instAddr(), inst);
+
+        if (!instPtr) {
+            //Predecode, ie bundle up an ExtMachInst
+            //If more fetch data is needed, pass it in.
+            Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
+            //if (decoder->needMoreBytes())
+                decoder->moreBytes(pcState, fetchPC, inst);
+            //else
+            //    decoder->process();
+
+            //Decode an instruction if one is ready. Otherwise, we'll
+            //have to fetch beyond the MachInst at the current pc.
+            instPtr = decoder->decode(pcState);
+            if (blockCache)
+                blockCache->fill(instPtr);
+        }
         if (instPtr) {
             t_info.stayAtPC = false;
             thread->pcState(pcState);
@@ -42,12 +42,15 @@
 #ifndef __CPU_SIMPLE_BASE_HH__
 #define __CPU_SIMPLE_BASE_HH__
 
+#include <memory>
+
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/exec_context.hh"
 #include "cpu/pc_event.hh"
+#include "cpu/simple/decoded_block_cache.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/static_inst.hh"
 #include "mem/packet.hh"
@@ -103,6 +106,9 @@ class BaseSimpleCPU : public BaseCPU
     StaticInstPtr curStaticInst;
     StaticInstPtr curMacroStaticInst;
 
+    /** Decoded instructions, if the ISA's decoder allows caching them */
+    std::unique_ptr<DecodedBlockCache<TheISA::MachInst>> blockCache;
+
   protected:
     enum Status {
         Idle,
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
+
+#include <cassert>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+#include "cpu/static_inst_fwd.hh"
+
+/**
+ * A per-CPU cache of decoded instructions for the simple CPUs, keyed by
+ * PC and instruction word.
+ *
+ * The instructions are kept in a direct-mapped table. Each entry is
+ * linked to the entry that executed after it the last time, so
+ * straight-line code, loops and other repeated paths go from one
+ * instruction to the next by following a pointer, and only index the
+ * table when the path changes. A hit skips the decoder and its shared
+ * decode cache.
+ *
+ * The CPU still fetches every instruction, and an entry only hits if its
+ * instruction word matches the one just fetched. Writes to cached code,
+ * and pages that are remapped to other code, therefore replace the stale
+ * entries the next time their PC executes.
+ *
+ * This is only correct if the decoder builds each instruction from its
+ * instruction word alone, see TheISA::StatelessDecoder.
+ */
+template <class MachInst>
+class DecodedBlockCache
+{
+  private:
+    struct Entry
+    {
+        Addr pc = MaxAddr;
+        MachInst machInst = 0;
+        StaticInstPtr inst;
+        /** The entry that executed after this one the last time */
+        Entry *next = nullptr;
+    };
+
+    std::vector<Entry> table;
+    /** The entry of the last lookup */
+    Entry *last = nullptr;
+
+  public:
+    /** @param entries Number of entries, a power of 2 */
+    explicit DecodedBlockCache(size_t entries) : table(entries)
+    {
+        assert(isPowerOf2(entries));
+    }
+
+    /**
+     * Look up the instruction at a PC.
+     *
+     * @param pc Address of the instruction.
+     * @param mach_inst Instruction word fetched from pc.
+     * @return The decoded instruction, or null if it has to be decoded
+     * and passed to fill().
+     */
+    const StaticInstPtr &
+    lookup(Addr pc, MachInst mach_inst)
+    {
+        Entry *entry = last ? last->next : nullptr;
+        if (!entry || entry->pc != pc) {
+            entry = &table[(pc / sizeof(MachInst)) & (table.size() - 1)];
+            if (last)
+                last->next = entry;
+        }
+        last = entry;
+
+        if (entry->pc != pc || entry->machInst != mach_inst) {
+            entry->pc = pc;
+            entry->machInst = mach_inst;
+            entry->inst = nullptr;
+        }
+        return entry->inst;
+    }
+
+    /** Store the instruction decoded after a lookup that missed */
+    void fill(const StaticInstPtr &inst) { last->inst = inst; }
+};
+
+#endif // __CPU_SIMPLE_DECODED_BLOCK_CACHE_HH__
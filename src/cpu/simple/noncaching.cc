@@ -37,9 +37,35 @@
 
 #include "cpu/simple/noncaching.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "arch/locked_mem.hh"
+#include "arch/registers.hh"
+#include "base/logging.hh"
+#include "cpu/thread_context.hh"
+#include "mem/host_atomic.hh"
+#include "sim/faults.hh"
+#include "sim/system.hh"
+
 NonCachingSimpleCPU::NonCachingSimpleCPU(NonCachingSimpleCPUParams *p)
-    : AtomicSimpleCPU(p)
+    : AtomicSimpleCPU(p), useBackdoor(p->backdoor_access),
+      lastBackingStore(nullptr), reservations(numThreads)
+{
+    lockedRMW.intRegs.resize(TheISA::NumIntRegs);
+    lockedRMW.ccRegs.resize(TheISA::NumCCRegs);
+}
+
+void
+NonCachingSimpleCPU::init()
 {
+    AtomicSimpleCPU::init();
+
+    for (const auto &entry : system->getPhysMem().getBackingStore()) {
+        if (entry.inAddrMap)
+            backingStore.push_back(entry);
+    }
 }
 
 void
@@ -51,9 +77,62 @@ NonCachingSimpleCPU::verifyMemoryMode() const
     }
 }
 
+Fault
+NonCachingSimpleCPU::readMem(Addr addr, uint8_t *data, unsigned size,
+                             Request::Flags flags,
+                             const std::vector<bool> &byte_enable)
+{
+    if (useBackdoor && flags.isSet(Request::LOCKED_RMW)) {
+        // Remember where to restart the sequence if it fails.
+        SimpleThread *thread = threadInfo[curThread]->thread;
+        lockedRMW.numFrags = 0;
+        lockedRMW.failed = false;
+        lockedRMW.pc = thread->pcState();
+        for (int i = 0; i < TheISA::NumIntRegs; i++)
+            lockedRMW.intRegs[i] = thread->readIntRegFlat(i);
+        for (int i = 0; i < TheISA::NumCCRegs; i++)
+            lockedRMW.ccRegs[i] = thread->readCCRegFlat(i);
+    }
+
+    return AtomicSimpleCPU::readMem(addr, data, size, flags, byte_enable);
+}
+
+Fault
+NonCachingSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
+                              Request::Flags flags, uint64_t *res,
+                              const std::vector<bool> &byte_enable)
+{
+    Fault fault = AtomicSimpleCPU::writeMem(data, size, addr, flags, res,
+                                            byte_enable);
+
+    if (useBackdoor && flags.isSet(Request::LOCKED_RMW)) {
+        if (fault == NoFault && lockedRMW.failed) {
+            // Another CPU wrote the data after we read it. Roll back
+            // to the read and execute the sequence again.
+            SimpleThread *thread = threadInfo[curThread]->thread;
+            for (int i = 0; i < TheISA::NumIntRegs; i++)
+                thread->setIntRegFlat(i, lockedRMW.intRegs[i]);
+            for (int i = 0; i < TheISA::NumCCRegs; i++)
+                thread->setCCRegFlat(i, lockedRMW.ccRegs[i]);
+            thread->pcState(lockedRMW.pc);
+            fault = std::make_shared<ReExec>();
+        }
+        lockedRMW.numFrags = 0;
+        lockedRMW.failed = false;
+    }
+
+    return fault;
+}
+
 Tick
 NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
+    if (useBackdoor && backdoorAccess(pkt))
+        return 0;
+
+    // Neither PhysicalMemory::access() nor the devices are thread
+    // safe.
+    EventQueue::ScopedMigration migrate(deviceEventQueue());
     if (system->isMemAddr(pkt->getAddr())) {
         system->getPhysMem().access(pkt);
         return 0;
@@ -62,6 +141,141 @@ NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
     }
 }
 
+uint8_t *
+NonCachingSimpleCPU::toHostAddr(Addr addr, unsigned size)
+{
+    const Addr last = addr + size - 1;
+
+    // Instruction fetches are almost always served by the same
+    // memory as the previous one, so try that first.
+    if (lastBackingStore && lastBackingStore->range.contains(addr) &&
+            lastBackingStore->range.contains(last)) {
+        return lastBackingStore->pmem +
+            (addr - lastBackingStore->range.start());
+    }
+
+    for (const auto &entry : backingStore) {
+        if (entry.range.contains(addr) && entry.range.contains(last)) {
+            lastBackingStore = &entry;
+            return entry.pmem + (addr - entry.range.start());
+        }
+    }
+
+    return nullptr;
+}
+
+bool
+NonCachingSimpleCPU::backdoorAccess(const PacketPtr &pkt)
+{
+    PhysicalMemory &physmem = system->getPhysMem();
+
+    // While the memories track LL/SC reservations, e.g., of CPUs that
+    // don't use the backdoor, they have to see every access.
+    if (physmem.hasLockedAddrs())
+        return false;
+
+    uint8_t *host_addr = toHostAddr(pkt->getAddr(), pkt->getSize());
+    if (!host_addr)
+        return false;
+
+    if (pkt->req->isLockedRMW()) {
+        lockedAccess(pkt, host_addr);
+        return true;
+    }
+
+    if (!physmem.backdoorAccess(pkt, host_addr, reservations[curThread],
+                                clearedContexts)) {
+        return false;
+    }
+    clearExclusive();
+    return true;
+}
+
+void
+NonCachingSimpleCPU::lockedAccess(const PacketPtr &pkt, uint8_t *host_addr)
+{
+    LLSCMonitor &monitor = system->getPhysMem().llscMonitor();
+    const Addr addr = pkt->getAddr();
+    const unsigned size = pkt->getSize();
+    panic_if(size > LLSCMonitor::MaxSize,
+             "Locked RMW access of %d bytes is too wide.\n", size);
+
+    if (pkt->isRead()) {
+        assert(lockedRMW.numFrags < 2);
+        auto &frag = lockedRMW.frags[lockedRMW.numFrags++];
+        frag.addr = addr;
+        frag.size = size;
+        HostAtomic::load(host_addr, frag.value, size);
+        std::memcpy(pkt->getPtr<uint8_t>(), frag.value, size);
+    } else {
+        auto *frag = std::find_if(
+            lockedRMW.frags, lockedRMW.frags + lockedRMW.numFrags,
+            [addr, size](const LockedRMW::Fragment &f) {
+                return f.addr == addr && f.size == size; });
+        panic_if(frag == lockedRMW.frags + lockedRMW.numFrags,
+                 "Locked RMW write to %#x doesn't match its read.\n", addr);
+
+        // A sequence that spans two cache lines writes them one after
+        // the other, so it is only atomic as long as nobody writes
+        // the second line in between. Check it before the first write
+        // to make that window as short as possible.
+        if (frag == lockedRMW.frags && lockedRMW.numFrags > 1) {
+            const auto &next = lockedRMW.frags[1];
+            uint8_t cur[LLSCMonitor::MaxSize];
+            HostAtomic::load(toHostAddr(next.addr, next.size), cur,
+                             next.size);
+            lockedRMW.failed = std::memcmp(cur, next.value, next.size);
+        }
+
+        if (!lockedRMW.failed) {
+            uint8_t expected[LLSCMonitor::MaxSize];
+            std::memcpy(expected, frag->value, size);
+            if (monitor.compareAndSwap(addr, host_addr, expected,
+                                       pkt->getConstPtr<uint8_t>(), size)) {
+                monitor.written(addr, size, pkt->req->contextId(),
+                                clearedContexts);
+                clearExclusive();
+            } else {
+                lockedRMW.failed = true;
+            }
+        }
+    }
+
+    pkt->makeResponse();
+}
+
+void
+NonCachingSimpleCPU::clearExclusive()
+{
+    for (ContextID cid : clearedContexts) {
+        ThreadContext *tc = system->threads[cid];
+        // The context may run on the event queue and host thread of
+        // another CPU.
+        EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue());
+        TheISA::globalClearExclusive(tc);
+    }
+    clearedContexts.clear();
+}
+
+Tick
+NonCachingSimpleCPU::fetchInstMem()
+{
+    if (!useBackdoor)
+        return AtomicSimpleCPU::fetchInstMem();
+
+    // Instruction fetches don't interact with LL/SC, so anything that
+    // is backed by host memory can be copied straight into the
+    // instruction buffer without building a packet. Everything else,
+    // e.g., fetches from devices, takes the normal path.
+    uint8_t *host_addr = toHostAddr(ifetch_req->getPaddr(),
+                                    ifetch_req->getSize());
+    if (!host_addr)
+        return AtomicSimpleCPU::fetchInstMem();
+
+    std::memcpy(&inst, host_addr, ifetch_req->getSize());
+    return 0;
+}
+
 NonCachingSimpleCPU *
 NonCachingSimpleCPUParams::create()
 {
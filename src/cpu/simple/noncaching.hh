@@ -38,22 +38,124 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/types.hh"
 #include "cpu/simple/atomic.hh"
+#include "mem/llsc_monitor.hh"
+#include "mem/physical.hh"
 #include "params/NonCachingSimpleCPU.hh"
 
 /**
  * The NonCachingSimpleCPU is an AtomicSimpleCPU using the
  * 'atomic_noncaching' memory mode instead of just 'atomic'.
+ *
+ * With backdoor_access, accesses to memory go straight to the backing
+ * store through PhysicalMemory::backdoorAccess(), which is safe to use
+ * from several host threads at once. This lets CPUs run on event
+ * queues of their own (see setParallelFastForward() in the configs)
+ * without serializing their memory accesses. Anything else, e.g.,
+ * device accesses, migrates to the event queue of the devices.
  */
 class NonCachingSimpleCPU : public AtomicSimpleCPU
 {
   public:
     NonCachingSimpleCPU(NonCachingSimpleCPUParams *p);
 
+    void init() override;
     void verifyMemoryMode() const override;
 
+    Fault readMem(Addr addr, uint8_t *data, unsigned size,
+                  Request::Flags flags,
+                  const std::vector<bool> &byte_enable =
+                      std::vector<bool>()) override;
+
+    Fault writeMem(uint8_t *data, unsigned size, Addr addr,
+                   Request::Flags flags, uint64_t *res,
+                   const std::vector<bool> &byte_enable =
+                       std::vector<bool>()) override;
+
   protected:
     Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
+    Tick fetchInstMem() override;
+
+  private:
+    /**
+     * Translate a physical address range into a pointer into the
+     * backing store of the simulated memory.
+     *
+     * @param addr Physical start address.
+     * @param size Size of the access in bytes.
+     * @return Host pointer or nullptr if the range isn't backed by a
+     *         single backing store entry.
+     */
+    uint8_t *toHostAddr(Addr addr, unsigned size);
+
+    /**
+     * Try to service a packet straight from the backing store,
+     * bypassing PhysicalMemory::access().
+     *
+     * @param pkt Packet to service.
+     * @return true if the packet was serviced
+     */
+    bool backdoorAccess(const PacketPtr &pkt);
+
+    /**
+     * Service a fragment of a locked RMW sequence from the backing
+     * store. The read records the data, and the write only updates
+     * memory if it still holds that data, see lockedRMW.
+     */
+    void lockedAccess(const PacketPtr &pkt, uint8_t *host_addr);
+
+    /**
+     * Tell contexts that lost their LL/SC reservation to one of our
+     * writes, e.g., to wake up an Arm core waiting in WFE.
+     */
+    void clearExclusive();
+
+    /** Service fetches and data accesses from the backing store. */
+    const bool useBackdoor;
+
+    /** Backing store of all memories that are in the address map. */
+    std::vector<BackingStoreEntry> backingStore;
+
+    /** The backing store entry that served the last lookup. */
+    const BackingStoreEntry *lastBackingStore;
+
+    /** LL/SC reservation of each thread. */
+    std::vector<LLSCMonitor::Reservation> reservations;
+
+    /** Contexts whose reservation was cleared by the current access. */
+    LLSCMonitor::ContextList clearedContexts;
+
+    /**
+     * State of the locked RMW sequence in progress.
+     *
+     * Other CPUs may write memory between the read and the write of
+     * the sequence. The write therefore compares and swaps the data
+     * recorded by the read. If that fails, the architectural state is
+     * rolled back to the read and the sequence is restarted.
+     */
+    struct LockedRMW
+    {
+        /** Fragments read, one for each cache line accessed. */
+        struct Fragment
+        {
+            Addr addr;
+            unsigned size;
+            uint8_t value[LLSCMonitor::MaxSize];
+        };
+        Fragment frags[2];
+        unsigned numFrags = 0;
+        /** Memory changed since the read. */
+        bool failed = false;
+
+        /** State before the read, restored to restart the sequence. */
+        TheISA::PCState pc;
+        std::vector<RegVal> intRegs;
+        std::vector<RegVal> ccRegs;
+    } lockedRMW;
 };
 
 #endif // __CPU_SIMPLE_NONCACHING_HH__
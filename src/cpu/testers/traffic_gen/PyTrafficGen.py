@@ -33,7 +33,6 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-from m5.defines import buildEnv
 from m5.SimObject import *
 
 from m5.objects.BaseTrafficGen import *
@@ -64,9 +63,6 @@ class PyTrafficGen(BaseTrafficGen):
 
     @cxxMethod(override=True)
     def createTrace(self, duration, trace_file, addr_offset=0):
-        if buildEnv['HAVE_PROTOBUF']:
-            return self.getCCObject().createTrace(duration, trace_file,
-                                                  addr_offset=addr_offset)
-        else:
-            raise NotImplementedError("Trace playback requires that gem5 "
-                                      "was built with protobuf support.")
+        # Block traces can be replayed without protobuf support
+        return self.getCCObject().createTrace(duration, trace_file,
+                                              addr_offset=addr_offset)
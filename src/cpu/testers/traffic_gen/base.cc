@@ -40,7 +40,6 @@
 
 #include "base/intmath.hh"
 #include "base/random.hh"
-#include "config/have_protobuf.hh"
 #include "cpu/testers/traffic_gen/base_gen.hh"
 #include "cpu/testers/traffic_gen/dram_gen.hh"
 #include "cpu/testers/traffic_gen/dram_rot_gen.hh"
@@ -51,6 +50,7 @@
 #include "cpu/testers/traffic_gen/nvm_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
 #include "cpu/testers/traffic_gen/stream_gen.hh"
+#include "cpu/testers/traffic_gen/trace_gen.hh"
 #include "debug/Checkpoint.hh"
 #include "debug/TrafficGen.hh"
 #include "enums/AddrMap.hh"
@@ -59,11 +59,6 @@
 #include "sim/stats.hh"
 #include "sim/system.hh"
 
-#if HAVE_PROTOBUF
-#include "cpu/testers/traffic_gen/trace_gen.hh"
-#endif
-
-
 using namespace std;
 
 BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams* p)
@@ -519,12 +514,8 @@ std::shared_ptr<BaseGen>
 BaseTrafficGen::createTrace(Tick duration,
                             const std::string& trace_file, Addr addr_offset)
 {
-#if HAVE_PROTOBUF
     return std::shared_ptr<BaseGen>(
         new TraceGen(*this, requestorId, duration, trace_file, addr_offset));
-#else
-    panic("Can't instantiate trace generation without Protobuf support!\n");
-#endif
 }
 
 bool
@@ -42,39 +42,82 @@
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/TrafficGen.hh"
+
+#if HAVE_PROTOBUF
 #include "proto/packet.pb.h"
+#endif
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
 {
+    if (BlockTrace::isBlockTrace(filename)) {
+        blockTrace.reset(new BlockTraceReader(filename));
+    } else {
+#if HAVE_PROTOBUF
+        protoTrace.reset(new ProtoInputStream(filename));
+#else
+        fatal("Replaying the protobuf trace %s requires protobuf support.\n",
+              filename);
+#endif
+    }
     init();
 }
 
 void
 TraceGen::InputStream::init()
 {
+    if (blockTrace) {
+        if (blockTrace->tickFreq() != SimClock::Frequency) {
+            panic("Trace was recorded with a different tick frequency %d\n",
+                  blockTrace->tickFreq());
+        }
+        return;
+    }
+
+#if HAVE_PROTOBUF
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!protoTrace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != SimClock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
               header_msg.tick_freq());
     }
+#endif
 }
 
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    if (blockTrace) {
+        blockTrace->reset();
+        return;
+    }
+
+#if HAVE_PROTOBUF
+    protoTrace->reset();
     init();
+#endif
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (blockTrace) {
+        BlockTraceRecord record;
+        if (!blockTrace->read(record))
+            return false;
+
+        element.cmd = record.cmd;
+        element.addr = record.addr;
+        element.blocksize = record.size;
+        element.tick = record.tick;
+        element.flags = record.flags;
+        return true;
+    }
+
+#if HAVE_PROTOBUF
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (protoTrace->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
@@ -82,6 +125,7 @@ TraceGen::InputStream::read(TraceElement& element)
         element.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
         return true;
     }
+#endif
 
     // We have reached the end of the file
     return false;
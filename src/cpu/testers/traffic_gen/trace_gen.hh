@@ -44,11 +44,18 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
+#include "config/have_protobuf.hh"
+#include "mem/block_trace.hh"
 #include "mem/packet.hh"
+
+#if HAVE_PROTOBUF
 #include "proto/protoio.hh"
+#endif
 
 /**
  * The trace replay generator reads a trace file and plays
@@ -100,15 +107,21 @@ class TraceGen : public BaseGen
     /**
      * The InputStream encapsulates a trace file and the
      * internal buffers and populates TraceElements based on
-     * the input.
+     * the input. It reads both protobuf packet traces and block
+     * traces (see mem/block_trace.hh).
      */
     class InputStream
     {
 
       private:
 
-        /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+#if HAVE_PROTOBUF
+        /// Input file stream for a protobuf trace
+        std::unique_ptr<ProtoInputStream> protoTrace;
+#endif
+
+        /// Reader of a block trace, which decodes blocks ahead of time
+        std::unique_ptr<BlockTraceReader> blockTrace;
 
       public:
 
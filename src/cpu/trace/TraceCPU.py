@@ -83,3 +83,11 @@ class TraceCPU(BaseCPU):
     progressMsgInterval = Param.Unsigned(0, "Interval of committed "\
                                          "instructions at which to print a"\
                                          " progress msg")
+
+    # If set to a non-zero value, a helper thread decompresses and parses
+    # this many elastic trace records ahead of the replay. This takes the
+    # trace decoding off the simulation thread, but should not be used
+    # together with m5.fork() as the helper thread is not forked.
+    traceReadAhead = Param.Unsigned(0, "Number of elastic trace records "\
+                                    "decoded ahead by a helper thread, 0 "\
+                                    "to decode on demand")
@@ -238,6 +238,14 @@ ElasticDataGenStatGroup::ElasticDataGenStatGroup(Stats::Group *parent,
 {
 }
 
+TraceCPU::ElasticDataGen::~ElasticDataGen()
+{
+    for (auto &graph_entry : depGraph)
+        delete graph_entry.second;
+    for (GraphNode *node : freeNodes)
+        delete node;
+}
+
 Tick
 TraceCPU::ElasticDataGen::init()
 {
@@ -301,13 +309,14 @@ TraceCPU::ElasticDataGen::readNextWindow()
     while (num_read != windowSize) {
 
         // Create a new graph node
-        GraphNode* new_node = new GraphNode;
+        GraphNode* new_node = allocNode();
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
         // to returning false.
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
+            freeNode(new_node);
             traceComplete = true;
             return false;
         }
@@ -334,6 +343,25 @@ TraceCPU::ElasticDataGen::readNextWindow()
     return true;
 }
 
+TraceCPU::ElasticDataGen::GraphNode *
+TraceCPU::ElasticDataGen::allocNode()
+{
+    if (freeNodes.empty())
+        return new GraphNode;
+
+    GraphNode *node = freeNodes.back();
+    freeNodes.pop_back();
+    return node;
+}
+
+void
+TraceCPU::ElasticDataGen::freeNode(GraphNode *node)
+{
+    // The dependents list keeps its capacity for the next user
+    assert(node->dependents.empty());
+    freeNodes.push_back(node);
+}
+
 template<typename T> void
 TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node,
                                             T& dep_array, uint8_t& num_dep)
@@ -501,8 +529,8 @@ TraceCPU::ElasticDataGen::execute()
             (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
-            // delete node
-            delete node_ptr;
+            // recycle node
+            freeNode(node_ptr);
             // remove from graph
             depGraph.erase(graph_itr);
         }
@@ -710,8 +738,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
-        // delete node
-        delete node_ptr;
+        // recycle node
+        freeNode(node_ptr);
         // remove from graph
         depGraph.erase(graph_itr);
     }
@@ -1179,8 +1207,15 @@ TraceCPU::DcachePort::recvReqRetry()
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
     const std::string& filename,
-    const double time_multiplier)
+    const double time_multiplier,
+    unsigned read_ahead)
     : trace(filename),
+      readAhead(read_ahead),
+      records(read_ahead),
+      recordHead(0),
+      numRecords(0),
+      traceEnd(false),
+      stopThread(false),
       timeMultiplier(time_multiplier),
       microOpCount(0)
 {
@@ -1198,19 +1233,109 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    startReadAhead();
+}
+
+TraceCPU::ElasticDataGen::InputStream::~InputStream()
+{
+    stopReadAhead();
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
+    stopReadAhead();
     trace.reset();
+    startReadAhead();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::startReadAhead()
+{
+    if (readAhead == 0)
+        return;
+
+    recordHead = 0;
+    numRecords = 0;
+    traceEnd = false;
+    stopThread = false;
+    readAheadThread = std::thread(&InputStream::readAheadLoop, this);
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::stopReadAhead()
+{
+    if (!readAheadThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(recordLock);
+        stopThread = true;
+    }
+    recordRemoved.notify_one();
+    readAheadThread.join();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::readAheadLoop()
+{
+    std::unique_lock<std::mutex> lock(recordLock);
+    while (true) {
+        recordRemoved.wait(lock, [this] {
+            return stopThread || numRecords < records.size();
+        });
+        if (stopThread)
+            return;
+
+        // The slot past the tail is not visible to the replay, so it can
+        // be filled without holding the lock
+        auto &slot = records[(recordHead + numRecords) % records.size()];
+        lock.unlock();
+        bool valid = trace.read(slot);
+        lock.lock();
+
+        if (!valid) {
+            traceEnd = true;
+            recordAdded.notify_one();
+            return;
+        }
+        numRecords++;
+        recordAdded.notify_one();
+    }
+}
+
+const ProtoMessage::InstDepRecord *
+TraceCPU::ElasticDataGen::InputStream::nextRecord()
+{
+    if (readAhead == 0)
+        return trace.read(record) ? &record : nullptr;
+
+    std::unique_lock<std::mutex> lock(recordLock);
+    recordAdded.wait(lock, [this] { return numRecords != 0 || traceEnd; });
+    return numRecords != 0 ? &records[recordHead] : nullptr;
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::popRecord()
+{
+    if (readAhead == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(recordLock);
+        recordHead = (recordHead + 1) % records.size();
+        numRecords--;
+    }
+    recordRemoved.notify_one();
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
-    ProtoMessage::InstDepRecord pkt_msg;
-    if (trace.read(pkt_msg)) {
+    const ProtoMessage::InstDepRecord *next_msg = nextRecord();
+    if (next_msg) {
+        const ProtoMessage::InstDepRecord &pkt_msg = *next_msg;
         // Required fields
         element->seqNum = pkt_msg.seq_num();
         element->type = pkt_msg.type();
@@ -1274,6 +1399,7 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
             microOpCount += pkt_msg.weight();
         }
         element->robNum = microOpCount;
+        popRecord();
         return true;
     }
 
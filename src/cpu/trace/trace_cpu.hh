@@ -39,10 +39,14 @@
 #define __CPU_TRACE_TRACE_CPU_HH__
 
 #include <array>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "arch/registers.hh"
 #include "base/statistics.hh"
@@ -789,6 +793,11 @@ class TraceCPU : public BaseCPU
          * The InputStream encapsulates a trace file and the
          * internal buffers and populates GraphNodes based on
          * the input.
+         *
+         * Decompressing and parsing the trace records can optionally be
+         * done by a helper thread which keeps a ring of decoded records
+         * ahead of the replay. The helper thread only touches the input
+         * file and the ring, so the replay itself is unaffected.
          */
         class InputStream
         {
@@ -798,6 +807,62 @@ class TraceCPU : public BaseCPU
             /** Input file stream for the protobuf trace */
             ProtoInputStream trace;
 
+            /**
+             * Number of records decoded ahead by the helper thread, or 0
+             * to decode each record when it is read.
+             */
+            const unsigned readAhead;
+
+            /** Record used when decoding on demand */
+            ProtoMessage::InstDepRecord record;
+
+            /** Ring of records decoded ahead of the replay */
+            std::vector<ProtoMessage::InstDepRecord> records;
+
+            /** Index of the oldest decoded record in the ring */
+            size_t recordHead;
+
+            /** Number of decoded records in the ring */
+            size_t numRecords;
+
+            /** Set by the helper thread when the end of file is reached */
+            bool traceEnd;
+
+            /** Set to ask the helper thread to stop */
+            bool stopThread;
+
+            /** Protects the ring and flags shared with the helper thread */
+            std::mutex recordLock;
+
+            /** Signalled when a record is added to the ring */
+            std::condition_variable recordAdded;
+
+            /** Signalled when a record is removed from the ring */
+            std::condition_variable recordRemoved;
+
+            /** Helper thread decoding records into the ring */
+            std::thread readAheadThread;
+
+            /** Start the helper thread if read-ahead is enabled */
+            void startReadAhead();
+
+            /** Stop the helper thread and drop any decoded records */
+            void stopReadAhead();
+
+            /** Body of the helper thread */
+            void readAheadLoop();
+
+            /**
+             * Get the next record, waiting for the helper thread if need
+             * be. The record stays valid until popRecord() is called.
+             *
+             * @return The next record or nullptr at the end of the trace
+             */
+            const ProtoMessage::InstDepRecord *nextRecord();
+
+            /** Release the record returned by nextRecord() */
+            void popRecord();
+
             /**
              * A multiplier for the compute delays in the trace to modulate
              * the Trace CPU frequency either up or down. The Trace CPU's
@@ -821,9 +886,13 @@ class TraceCPU : public BaseCPU
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param read_ahead records to decode ahead in a helper thread
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier,
+                        unsigned read_ahead = 0);
+
+            ~InputStream();
 
             /**
              * Reset the stream such that it can be played once
@@ -857,7 +926,8 @@ class TraceCPU : public BaseCPU
             : owner(_owner),
               port(_port),
               requestorId(requestor_id),
-              trace(trace_file, 1.0 / params->freqMultiplier),
+              trace(trace_file, 1.0 / params->freqMultiplier,
+                    params->traceReadAhead),
               genName(owner.name() + ".elastic." + _name),
               retryPkt(nullptr),
               traceComplete(false),
@@ -871,6 +941,9 @@ class TraceCPU : public BaseCPU
                     windowSize);
         }
 
+        /** Free the nodes left in the dependency graph and free list */
+        ~ElasticDataGen();
+
         /**
          * Called from TraceCPU init(). Reads the first message from the
          * input trace file and returns the send tick.
@@ -1031,6 +1104,18 @@ class TraceCPU : public BaseCPU
         /** Store the depGraph of GraphNodes */
         std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
 
+        /**
+         * GraphNodes which have been removed from depGraph and can be
+         * reused for new records, avoiding an allocation per record.
+         */
+        std::vector<GraphNode*> freeNodes;
+
+        /** Get a GraphNode, reusing a free one if possible */
+        GraphNode *allocNode();
+
+        /** Return a completed GraphNode for reuse */
+        void freeNode(GraphNode *node);
+
         /**
          * Queue of dependency-free nodes that are pending issue because
          * resources are not available. This is chosen to be FIFO so that
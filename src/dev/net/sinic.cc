@@ -89,6 +89,8 @@ Device::Device(const Params *p)
       dmaReadDelay(p->dma_read_delay), dmaReadFactor(p->dma_read_factor),
       dmaWriteDelay(p->dma_write_delay), dmaWriteFactor(p->dma_write_factor)
 {
+    setCustomReset();
+
     interface = new Interface(name() + ".int0", this);
     reset();
 
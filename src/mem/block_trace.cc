@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/block_trace.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+
+namespace BlockTrace
+{
+
+static const char Magic[8] = { 'g', 'e', 'm', '5', 'p', 'b', 't', '\0' };
+static const char IndexMagic[8] = { 'g', 'e', 'm', '5', 'i', 'd', 'x', '\0' };
+
+/** Size of the trailer after the index */
+static const size_t TrailerSize = 2 * sizeof(uint64_t) + sizeof(IndexMagic);
+
+/** Convert a record between host and little endian byte order */
+static void
+swapRecord(BlockTraceRecord &record)
+{
+    record.tick = htole(record.tick);
+    record.addr = htole(record.addr);
+    record.pc = htole(record.pc);
+    record.flags = htole(record.flags);
+    record.size = htole(record.size);
+    record.cmd = htole(record.cmd);
+    record.requestorId = htole(record.requestorId);
+}
+
+template <typename T>
+static void
+put(std::ostream &os, T value)
+{
+    value = htole(value);
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void
+putString(std::ostream &os, const std::string &str)
+{
+    put<uint32_t>(os, str.size());
+    os.write(str.data(), str.size());
+}
+
+template <typename T>
+static T
+get(std::istream &is)
+{
+    T value = 0;
+    is.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return letoh(value);
+}
+
+static std::string
+getString(std::istream &is)
+{
+    std::string str(get<uint32_t>(is), '\0');
+    is.read(&str[0], str.size());
+    return str;
+}
+
+bool
+isBlockTrace(const std::string &filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    char magic[sizeof(Magic)];
+    return is.read(magic, sizeof(magic)) &&
+        std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+} // namespace BlockTrace
+
+using namespace BlockTrace;
+
+BlockTraceWriter::BlockTraceWriter(const std::string &filename,
+                                   size_t block_size, bool _compress)
+    : stream(filename, std::ios::out | std::ios::binary | std::ios::trunc),
+      blockSize(block_size), compress(_compress), current(nullptr),
+      stopping(false), closed(false), offset(0), records(0)
+{
+    fatal_if(!stream, "Failed to open block trace %s.", filename);
+    fatal_if(!block_size, "Block traces need at least one record per block.");
+
+    thread = std::thread([this]() { writeLoop(); });
+}
+
+BlockTraceWriter::~BlockTraceWriter()
+{
+    close();
+}
+
+void
+BlockTraceWriter::writeHeader(const std::string &obj_id, Tick tick_freq,
+                              const std::vector<std::string> &requestors)
+{
+    panic_if(offset, "Block trace header written twice.");
+
+    stream.write(Magic, sizeof(Magic));
+    put<uint32_t>(stream, Version);
+    put<uint32_t>(stream, sizeof(BlockTraceRecord));
+    put<uint64_t>(stream, tick_freq);
+    putString(stream, obj_id);
+    put<uint32_t>(stream, requestors.size());
+    for (const auto &name : requestors)
+        putString(stream, name);
+
+    // The writer thread only touches the stream once blocks come in
+    offset = stream.tellp();
+}
+
+void
+BlockTraceWriter::nextBlock()
+{
+    panic_if(!offset, "Block trace record written before the header.");
+
+    if (current)
+        submit(current);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeBlocks.empty()) {
+        blocks.emplace_back(new Block);
+        blocks.back()->reserve(blockSize);
+        current = blocks.back().get();
+    } else {
+        current = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+}
+
+void
+BlockTraceWriter::submit(Block *block)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCond.wait(lock, [this]() { return pending.size() < MaxPending; });
+    pending.push_back(block);
+    pendingCond.notify_one();
+}
+
+void
+BlockTraceWriter::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        pendingCond.wait(lock, [this]() {
+                return stopping || !pending.empty(); });
+        if (pending.empty())
+            break;
+
+        Block *block = pending.front();
+        lock.unlock();
+
+        writeBlock(*block);
+        block->clear();
+
+        lock.lock();
+        pending.pop_front();
+        freeBlocks.push_back(block);
+        doneCond.notify_all();
+    }
+}
+
+void
+BlockTraceWriter::writeBlock(const Block &block)
+{
+    const BlockTraceRecord *records_le = block.data();
+    if (HostByteOrder != ByteOrder::little) {
+        encoded = block;
+        for (auto &record : encoded)
+            swapRecord(record);
+        records_le = encoded.data();
+    }
+
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(records_le);
+    uLongf size = block.size() * sizeof(BlockTraceRecord);
+    uint32_t flags = 0;
+    if (compress) {
+        uLongf compressed_size = compressBound(size);
+        compressed.resize(compressed_size);
+        int ret = compress2(compressed.data(), &compressed_size, data, size,
+                            Z_BEST_SPEED);
+        panic_if(ret != Z_OK, "Failed to compress block trace.");
+        data = compressed.data();
+        size = compressed_size;
+        flags |= BlockCompressed;
+    }
+
+    put<uint64_t>(stream, block.front().tick);
+    put<uint32_t>(stream, block.size());
+    put<uint32_t>(stream, flags);
+    put<uint64_t>(stream, size);
+    stream.write(reinterpret_cast<const char *>(data), size);
+
+    index.push_back({ offset, block.front().tick, records });
+    offset += sizeof(BlockHeader) + size;
+    records += block.size();
+}
+
+void
+BlockTraceWriter::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    if (current && !current->empty())
+        submit(current);
+    current = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    pendingCond.notify_one();
+    thread.join();
+
+    // A trace without a header has nowhere to put the index
+    if (offset) {
+        const uint64_t index_offset = offset;
+        for (const auto &entry : index) {
+            put<uint64_t>(stream, entry.offset);
+            put<uint64_t>(stream, entry.firstTick);
+            put<uint64_t>(stream, entry.firstRecord);
+        }
+        put<uint64_t>(stream, index_offset);
+        put<uint64_t>(stream, index.size());
+        stream.write(IndexMagic, sizeof(IndexMagic));
+    }
+    stream.close();
+}
+
+BlockTraceReader::BlockTraceReader(const std::string &_filename,
+                                   unsigned read_ahead)
+    : filename(_filename), stream(filename, std::ios::in | std::ios::binary),
+      readAhead(std::max(read_ahead, 1U)), _tickFreq(0), dataOffset(0),
+      indexOffset(0), current(nullptr), pos(0), stopping(false)
+{
+    fatal_if(!stream, "Failed to open block trace %s.", filename);
+
+    readHeader();
+    readIndex();
+    restart(dataOffset);
+}
+
+BlockTraceReader::~BlockTraceReader()
+{
+    stop();
+}
+
+void
+BlockTraceReader::readHeader()
+{
+    char magic[sizeof(Magic)];
+    stream.read(magic, sizeof(magic));
+    fatal_if(!stream || std::memcmp(magic, Magic, sizeof(Magic)) != 0,
+             "%s is not a block packet trace.", filename);
+
+    const uint32_t version = get<uint32_t>(stream);
+    const uint32_t record_size = get<uint32_t>(stream);
+    fatal_if(version != Version || record_size != sizeof(BlockTraceRecord),
+             "Block trace %s has unsupported version %d.", filename, version);
+
+    _tickFreq = get<uint64_t>(stream);
+    _objId = getString(stream);
+    const uint32_t num_requestors = get<uint32_t>(stream);
+    for (uint32_t i = 0; i < num_requestors && stream; i++)
+        _requestors.push_back(getString(stream));
+    fatal_if(!stream, "Block trace %s has a truncated header.", filename);
+
+    dataOffset = stream.tellg();
+}
+
+void
+BlockTraceReader::readIndex()
+{
+    stream.seekg(0, std::ios::end);
+    const uint64_t file_size = stream.tellg();
+    if (file_size < dataOffset + TrailerSize)
+        return;
+
+    stream.seekg(file_size - TrailerSize);
+    const uint64_t index_offset = get<uint64_t>(stream);
+    const uint64_t num_blocks = get<uint64_t>(stream);
+    char magic[sizeof(IndexMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::memcmp(magic, IndexMagic, sizeof(magic)) != 0 ||
+        index_offset < dataOffset ||
+        index_offset + num_blocks * sizeof(IndexEntry) + TrailerSize !=
+        file_size) {
+        stream.clear();
+        return;
+    }
+
+    stream.seekg(index_offset);
+    index.resize(num_blocks);
+    for (auto &entry : index) {
+        entry.offset = get<uint64_t>(stream);
+        entry.firstTick = get<uint64_t>(stream);
+        entry.firstRecord = get<uint64_t>(stream);
+    }
+    indexOffset = index_offset;
+}
+
+void
+BlockTraceReader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    freeCond.notify_all();
+    if (thread.joinable())
+        thread.join();
+
+    if (current)
+        freeBlocks.push_back(current);
+    for (auto *block : ready) {
+        if (block)
+            freeBlocks.push_back(block);
+    }
+    ready.clear();
+    current = nullptr;
+    pos = 0;
+    stopping = false;
+}
+
+void
+BlockTraceReader::restart(uint64_t offset)
+{
+    stop();
+    stream.clear();
+    stream.seekg(offset);
+    thread = std::thread([this, offset]() { readLoop(offset); });
+}
+
+void
+BlockTraceReader::seek(Tick tick)
+{
+    uint64_t offset = dataOffset;
+    // Start from the last block that begins before the tick, the
+    // records before it are skipped below
+    auto it = std::lower_bound(index.begin(), index.end(), tick,
+        [](const IndexEntry &entry, Tick t) { return entry.firstTick < t; });
+    if (it != index.begin())
+        offset = std::prev(it)->offset;
+    restart(offset);
+
+    while (true) {
+        if (!current || pos == current->size()) {
+            if (!nextBlock())
+                return;
+        } else if ((*current)[pos].tick >= tick) {
+            return;
+        } else {
+            pos++;
+        }
+    }
+}
+
+bool
+BlockTraceReader::nextBlock()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    do {
+        if (current) {
+            freeBlocks.push_back(current);
+            current = nullptr;
+            freeCond.notify_one();
+        }
+
+        readyCond.wait(lock, [this]() { return !ready.empty(); });
+        // The end marker stays in the queue for later calls
+        if (!ready.front())
+            return false;
+        current = ready.front();
+        ready.pop_front();
+        pos = 0;
+    } while (current->empty());
+    return true;
+}
+
+void
+BlockTraceReader::readLoop(uint64_t offset)
+{
+    const uint64_t end = indexOffset ? indexOffset : UINT64_MAX;
+    std::vector<uint8_t> data;
+
+    while (true) {
+        Block *block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            freeCond.wait(lock, [this]() {
+                return stopping || !freeBlocks.empty() ||
+                    blocks.size() <= readAhead;
+            });
+            if (stopping)
+                return;
+            if (freeBlocks.empty()) {
+                blocks.emplace_back(new Block);
+                block = blocks.back().get();
+            } else {
+                block = freeBlocks.back();
+                freeBlocks.pop_back();
+            }
+        }
+
+        bool valid = false;
+        if (offset < end &&
+            stream.peek() != std::char_traits<char>::eof()) {
+            BlockHeader header;
+            header.firstTick = get<uint64_t>(stream);
+            header.records = get<uint32_t>(stream);
+            header.flags = get<uint32_t>(stream);
+            header.size = get<uint64_t>(stream);
+
+            const uLongf raw_size = header.records * sizeof(BlockTraceRecord);
+            block->resize(header.records);
+            if (stream && (header.flags & BlockCompressed)) {
+                data.resize(header.size);
+                stream.read(reinterpret_cast<char *>(data.data()),
+                            data.size());
+                uLongf size = raw_size;
+                valid = stream && uncompress(
+                    reinterpret_cast<uint8_t *>(block->data()), &size,
+                    data.data(), data.size()) == Z_OK && size == raw_size;
+            } else if (stream) {
+                stream.read(reinterpret_cast<char *>(block->data()),
+                            raw_size);
+                valid = stream && header.size == raw_size;
+            }
+
+            // A trace that wasn't closed may end with a partial block
+            warn_if(!valid, "Block trace %s ends with a truncated block.",
+                    filename);
+            offset += sizeof(BlockHeader) + header.size;
+        }
+
+        if (valid && HostByteOrder != ByteOrder::little) {
+            for (auto &record : *block)
+                swapRecord(record);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!valid) {
+            freeBlocks.push_back(block);
+            ready.push_back(nullptr);
+            readyCond.notify_one();
+            return;
+        }
+        ready.push_back(block);
+        readyCond.notify_one();
+    }
+}
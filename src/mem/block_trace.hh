@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Block based binary packet traces, a faster alternative to the
+ * protobuf packet traces of MemTraceProbe.
+ *
+ * A trace holds fixed size packet records, BlockTraceRecord, grouped in
+ * blocks that are compressed on their own, followed by an index of the
+ * blocks so that readers can seek by tick without decompressing the
+ * blocks in between:
+ *
+ *   char[8]   magic "gem5pbt\0"
+ *   uint32    version
+ *   uint32    record size
+ *   uint64    ticks per second
+ *   uint32    size of the id of the object that captured the trace,
+ *             then the id
+ *   uint32    number of requestors, then for each (uint32 size, name)
+ *   blocks:
+ *     uint64  tick of the first record
+ *     uint32  number of records
+ *     uint32  flags, BlockCompressed if the data is zlib compressed
+ *     uint64  size of the data
+ *     the records
+ *   index, one entry per block:
+ *     uint64  offset of the block in the file
+ *     uint64  tick of the first record
+ *     uint64  number of records before the block
+ *   trailer:
+ *     uint64  offset of the index
+ *     uint64  number of blocks
+ *     char[8] magic "gem5idx\0"
+ *
+ * All integers are little endian. A trace without an index, for example
+ * because the simulation crashed, can still be read from start to end.
+ * util/packet_block_trace.py decodes these traces and converts them from
+ * and to protobuf packet traces.
+ */
+
+#ifndef __MEM_BLOCK_TRACE_HH__
+#define __MEM_BLOCK_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/types.hh"
+
+struct BlockTraceRecord
+{
+    uint64_t tick;
+    uint64_t addr;
+    /** PC of the instruction that made the request, or 0 */
+    uint64_t pc;
+    uint64_t flags;
+    uint32_t size;
+    uint16_t cmd;
+    uint16_t requestorId;
+};
+
+static_assert(sizeof(BlockTraceRecord) == 40,
+              "Block trace records must not have padding");
+
+namespace BlockTrace
+{
+
+const uint32_t Version = 1;
+
+enum BlockFlags : uint32_t {
+    BlockCompressed = 0x1,
+};
+
+/** Header of a block of records */
+struct BlockHeader
+{
+    uint64_t firstTick;
+    uint32_t records;
+    uint32_t flags;
+    uint64_t size;
+};
+
+/** Index entry of a block */
+struct IndexEntry
+{
+    uint64_t offset;
+    uint64_t firstTick;
+    uint64_t firstRecord;
+};
+
+/** Check if a file starts like a block trace */
+bool isBlockTrace(const std::string &filename);
+
+} // namespace BlockTrace
+
+/**
+ * Writes a block trace. Records are collected in blocks, and full
+ * blocks are compressed and written by a background thread so that
+ * the simulation only pays for copying the record.
+ */
+class BlockTraceWriter
+{
+  public:
+    /**
+     * @param filename Path of the trace to create
+     * @param block_size Number of records per block
+     * @param compress Compress the blocks
+     */
+    BlockTraceWriter(const std::string &filename, size_t block_size,
+                     bool compress);
+    ~BlockTraceWriter();
+
+    /**
+     * Write the header of the trace, which has to come before any
+     * record.
+     */
+    void writeHeader(const std::string &obj_id, Tick tick_freq,
+                     const std::vector<std::string> &requestors);
+
+    void
+    write(const BlockTraceRecord &record)
+    {
+        if (!current || current->size() == blockSize)
+            nextBlock();
+        current->push_back(record);
+    }
+
+    /** Write the remaining records and the index and close the file */
+    void close();
+
+  private:
+    typedef std::vector<BlockTraceRecord> Block;
+
+    /** Blocks queued before write() starts waiting for the writer */
+    static const size_t MaxPending = 4;
+
+    void nextBlock();
+    void submit(Block *block);
+    void writeLoop();
+    void writeBlock(const Block &block);
+
+    std::ofstream stream;
+    const size_t blockSize;
+    const bool compress;
+
+    /** Block being filled */
+    Block *current;
+
+    std::mutex mutex;
+    std::condition_variable pendingCond;
+    std::condition_variable doneCond;
+    std::deque<Block *> pending;
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Block *> freeBlocks;
+    bool stopping;
+    bool closed;
+    std::thread thread;
+
+    /** @{ State of the writer thread */
+    uint64_t offset;
+    uint64_t records;
+    std::vector<BlockTrace::IndexEntry> index;
+    std::vector<BlockTraceRecord> encoded;
+    std::vector<uint8_t> compressed;
+    /** @} */
+};
+
+/**
+ * Reads a block trace. A background thread reads and decompresses up to
+ * a given number of blocks ahead of the one being consumed.
+ */
+class BlockTraceReader
+{
+  public:
+    /**
+     * @param filename Path of the trace to read
+     * @param read_ahead Number of blocks decoded ahead of time
+     */
+    BlockTraceReader(const std::string &filename, unsigned read_ahead = 4);
+    ~BlockTraceReader();
+
+    const std::string &objId() const { return _objId; }
+    Tick tickFreq() const { return _tickFreq; }
+    const std::vector<std::string> &requestors() const { return _requestors; }
+
+    /** Does the trace have an index to seek with? */
+    bool hasIndex() const { return indexOffset != 0; }
+
+    /**
+     * Get the next record.
+     *
+     * @return false at the end of the trace
+     */
+    bool
+    read(BlockTraceRecord &record)
+    {
+        if (!current || pos == current->size()) {
+            if (!nextBlock())
+                return false;
+        }
+        record = (*current)[pos++];
+        return true;
+    }
+
+    /** Go back to the first record */
+    void reset() { restart(dataOffset); }
+
+    /**
+     * Move to the first record at or after a tick. Uses the index to
+     * skip to the right block if there is one.
+     */
+    void seek(Tick tick);
+
+  private:
+    typedef std::vector<BlockTraceRecord> Block;
+
+    void readHeader();
+    void readIndex();
+
+    /** Stop the read ahead thread and start it again at an offset */
+    void restart(uint64_t offset);
+    void stop();
+    bool nextBlock();
+    void readLoop(uint64_t offset);
+
+    const std::string filename;
+    std::ifstream stream;
+    const unsigned readAhead;
+
+    std::string _objId;
+    Tick _tickFreq;
+    std::vector<std::string> _requestors;
+
+    /** Offset of the first block */
+    uint64_t dataOffset;
+    /** Offset of the index, or 0 if the trace has none */
+    uint64_t indexOffset;
+    std::vector<BlockTrace::IndexEntry> index;
+
+    /** Block being consumed and the position in it */
+    Block *current;
+    size_t pos;
+
+    std::mutex mutex;
+    std::condition_variable readyCond;
+    std::condition_variable freeCond;
+    /** Decoded blocks, nullptr marks the end of the trace */
+    std::deque<Block *> ready;
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Block *> freeBlocks;
+    bool stopping;
+    std::thread thread;
+};
+
+#endif // __MEM_BLOCK_TRACE_HH__
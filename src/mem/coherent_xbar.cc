@@ -732,6 +732,10 @@ Tick
 CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
                                  MemBackdoorPtr *backdoor)
 {
+    // Requestors such as the table walkers of CPUs that are
+    // fast-forwarded in parallel call us from their own event queue.
+    EventQueue::ScopedMigration migrate(eventQueue());
+
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             cpuSidePorts[cpu_side_port_id]->name(), pkt->print());
 
@@ -995,6 +999,9 @@ CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_cpu_side_port_id,
 void
 CoherentXBar::recvFunctional(PacketPtr pkt, PortID cpu_side_port_id)
 {
+    // See recvAtomicBackdoor().
+    EventQueue::ScopedMigration migrate(eventQueue());
+
     if (!pkt->isPrint()) {
         // don't do DPRINTFs on PrintReq as it clutters up the output
         DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
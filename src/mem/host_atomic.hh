@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Atomic accesses to the host memory that backs the simulated
+ * memory. CPUs that access the backing store directly from several
+ * host threads at once use these so that naturally aligned accesses
+ * of up to eight bytes are single-copy atomic, as they are on most
+ * simulated ISAs. Data is copied as raw bytes in the guest's byte
+ * order.
+ */
+
+#ifndef __MEM_HOST_ATOMIC_HH__
+#define __MEM_HOST_ATOMIC_HH__
+
+#include <cstdint>
+#include <cstring>
+
+namespace HostAtomic
+{
+
+/**
+ * Check if an access can use the host's lock-free atomic
+ * instructions, i.e., if it is naturally aligned and one, two, four
+ * or eight bytes wide.
+ */
+inline bool
+lockFree(const uint8_t *host, unsigned size)
+{
+    return (size == 1 || size == 2 || size == 4 || size == 8) &&
+        (reinterpret_cast<uintptr_t>(host) & (size - 1)) == 0;
+}
+
+template <class T>
+inline void
+loadAs(const uint8_t *host, uint8_t *data)
+{
+    T val = __atomic_load_n(reinterpret_cast<const T *>(host),
+                            __ATOMIC_RELAXED);
+    std::memcpy(data, &val, sizeof(T));
+}
+
+template <class T>
+inline void
+storeAs(uint8_t *host, const uint8_t *data)
+{
+    T val;
+    std::memcpy(&val, data, sizeof(T));
+    __atomic_store_n(reinterpret_cast<T *>(host), val, __ATOMIC_RELAXED);
+}
+
+template <class T>
+inline bool
+compareAndSwapAs(uint8_t *host, uint8_t *expected, const uint8_t *desired)
+{
+    T exp, des;
+    std::memcpy(&exp, expected, sizeof(T));
+    std::memcpy(&des, desired, sizeof(T));
+    if (__atomic_compare_exchange_n(reinterpret_cast<T *>(host), &exp, des,
+                                    false, __ATOMIC_SEQ_CST,
+                                    __ATOMIC_SEQ_CST)) {
+        return true;
+    }
+    std::memcpy(expected, &exp, sizeof(T));
+    return false;
+}
+
+/**
+ * Read from host memory. The read is atomic if lockFree() holds and
+ * a plain copy otherwise.
+ */
+inline void
+load(const uint8_t *host, uint8_t *data, unsigned size)
+{
+    if (!lockFree(host, size)) {
+        std::memcpy(data, host, size);
+        return;
+    }
+    switch (size) {
+      case 1: loadAs<uint8_t>(host, data); break;
+      case 2: loadAs<uint16_t>(host, data); break;
+      case 4: loadAs<uint32_t>(host, data); break;
+      default: loadAs<uint64_t>(host, data); break;
+    }
+}
+
+/**
+ * Write to host memory. The write is atomic if lockFree() holds and
+ * a plain copy otherwise.
+ */
+inline void
+store(uint8_t *host, const uint8_t *data, unsigned size)
+{
+    if (!lockFree(host, size)) {
+        std::memcpy(host, data, size);
+        return;
+    }
+    switch (size) {
+      case 1: storeAs<uint8_t>(host, data); break;
+      case 2: storeAs<uint16_t>(host, data); break;
+      case 4: storeAs<uint32_t>(host, data); break;
+      default: storeAs<uint64_t>(host, data); break;
+    }
+}
+
+/**
+ * Atomically replace the contents of host memory with desired if
+ * they are equal to expected. Only valid if lockFree() holds.
+ *
+ * @param expected Expected contents, updated with the actual contents
+ *                 if they differ
+ * @return true if the memory was updated
+ */
+inline bool
+compareAndSwap(uint8_t *host, uint8_t *expected, const uint8_t *desired,
+               unsigned size)
+{
+    switch (size) {
+      case 1: return compareAndSwapAs<uint8_t>(host, expected, desired);
+      case 2: return compareAndSwapAs<uint16_t>(host, expected, desired);
+      case 4: return compareAndSwapAs<uint32_t>(host, expected, desired);
+      default: return compareAndSwapAs<uint64_t>(host, expected, desired);
+    }
+}
+
+} // namespace HostAtomic
+
+#endif // __MEM_HOST_ATOMIC_HH__
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/llsc_monitor.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "mem/host_atomic.hh"
+
+void
+LLSCMonitor::release(Shard &s, Addr block, ContextID cid)
+{
+    std::lock_guard<std::mutex> guard(s.lock);
+    auto it = std::find(s.records.begin(), s.records.end(),
+                        std::make_pair(block, cid));
+    if (it != s.records.end()) {
+        s.records.erase(it);
+        s.reservations.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void
+LLSCMonitor::clearBlock(Shard &s, Addr block, ContextID cid,
+                        ContextList &cleared)
+{
+    auto it = s.records.begin();
+    while (it != s.records.end()) {
+        if (it->first == block) {
+            if (it->second != cid)
+                cleared.push_back(it->second);
+            it = s.records.erase(it);
+            s.reservations.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+LLSCMonitor::loadLocked(ContextID cid, Reservation &res, Addr addr,
+                        const uint8_t *host, unsigned size, uint8_t *data)
+{
+    assert(size <= MaxSize);
+    const Addr block = blockAlign(addr);
+
+    if (res.addr != MaxAddr && blockAlign(res.addr) != block)
+        release(shard(blockAlign(res.addr)), blockAlign(res.addr), cid);
+
+    Shard &s = shard(block);
+    {
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto record = std::make_pair(block, cid);
+        if (std::find(s.records.begin(), s.records.end(), record) ==
+                s.records.end()) {
+            s.records.push_back(record);
+            s.reservations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Publish the reservation before reading memory. A writer either
+    // sees the reservation in written() and clears it, or its write
+    // happened before this read and the value we read includes it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    HostAtomic::load(host, data, size);
+
+    std::memcpy(res.value, data, size);
+    res.addr = addr;
+    res.size = size;
+}
+
+bool
+LLSCMonitor::storeConditional(ContextID cid, Reservation &res, Addr addr,
+                              uint8_t *host, unsigned size,
+                              const uint8_t *data, ContextList &cleared)
+{
+    const Addr block = blockAlign(addr);
+    Shard &s = shard(block);
+    bool success = false;
+
+    {
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto it = std::find(s.records.begin(), s.records.end(),
+                            std::make_pair(block, cid));
+        if (it != s.records.end() && res.addr == addr && res.size == size) {
+            uint8_t expected[MaxSize];
+            std::memcpy(expected, res.value, size);
+            if (HostAtomic::lockFree(host, size)) {
+                success = HostAtomic::compareAndSwap(host, expected, data,
+                                                     size);
+            } else if (std::memcmp(host, expected, size) == 0) {
+                std::memcpy(host, data, size);
+                success = true;
+            }
+        }
+
+        if (success) {
+            clearBlock(s, block, cid, cleared);
+        } else if (it != s.records.end()) {
+            s.records.erase(it);
+            s.reservations.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    res.addr = MaxAddr;
+    return success;
+}
+
+bool
+LLSCMonitor::compareAndSwap(Addr addr, uint8_t *host, uint8_t *expected,
+                            const uint8_t *desired, unsigned size)
+{
+    if (HostAtomic::lockFree(host, size))
+        return HostAtomic::compareAndSwap(host, expected, desired, size);
+
+    std::lock_guard<std::mutex> guard(shard(blockAlign(addr)).lock);
+    if (std::memcmp(host, expected, size) != 0) {
+        std::memcpy(expected, host, size);
+        return false;
+    }
+    std::memcpy(host, desired, size);
+    return true;
+}
+
+void
+LLSCMonitor::written(Addr addr, unsigned size, ContextID cid,
+                     ContextList &cleared)
+{
+    // Pairs with the fence in loadLocked().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const Addr last = blockAlign(addr + size - 1);
+    for (Addr block = blockAlign(addr); ; block += BlockSize) {
+        Shard &s = shard(block);
+        if (s.reservations.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> guard(s.lock);
+            clearBlock(s, block, cid, cleared);
+        }
+        if (block == last)
+            break;
+    }
+}
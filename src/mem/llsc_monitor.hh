@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_LLSC_MONITOR_HH__
+#define __MEM_LLSC_MONITOR_HH__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * A load-locked/store-conditional monitor for accesses that go
+ * straight to the backing store, possibly from several host threads at
+ * once (see PhysicalMemory::backdoorAccess()). It replaces the locked
+ * address tracking of AbstractMemory for such accesses.
+ *
+ * Reservations are kept per cache block in shards selected by the
+ * block address. Each shard has a lock of its own, so threads only
+ * contend when they use reserved blocks in the same shard, and writes
+ * to blocks in a shard without reservations don't take the lock at
+ * all. A store-conditional succeeds if the context still holds its
+ * reservation and memory still contains the value that the
+ * load-locked read. The value is checked and updated with a single
+ * compare-and-swap, which also catches writes that bypass the
+ * monitor, e.g., DMA.
+ */
+class LLSCMonitor
+{
+  public:
+    /** Widest load-locked access, e.g., an Arm LDXP of two doublewords. */
+    static const unsigned MaxSize = 16;
+
+    /** Granularity of the reservations. */
+    static const Addr BlockSize = 64;
+
+    /**
+     * Reservation of a single hardware context. It belongs to the
+     * thread that simulates the context and is only ever used by it.
+     */
+    struct Reservation
+    {
+        /** Address of the load-locked, MaxAddr if none. */
+        Addr addr = MaxAddr;
+        unsigned size = 0;
+        /** Value read by the load-locked. */
+        uint8_t value[MaxSize];
+    };
+
+    /** Contexts whose reservation was cleared by an access. */
+    typedef std::vector<ContextID> ContextList;
+
+    /**
+     * Read memory and reserve its block for a context. This replaces
+     * any previous reservation of the context.
+     *
+     * @param data Buffer for the data read
+     */
+    void loadLocked(ContextID cid, Reservation &res, Addr addr,
+                    const uint8_t *host, unsigned size, uint8_t *data);
+
+    /**
+     * Write memory if the context still holds a reservation for the
+     * address and memory still holds the value read by the
+     * load-locked. A successful store clears all reservations of the
+     * block. Either way, the context's reservation is gone afterwards.
+     *
+     * @param cleared Other contexts that lost their reservation
+     * @return true if memory was written
+     */
+    bool storeConditional(ContextID cid, Reservation &res, Addr addr,
+                          uint8_t *host, unsigned size,
+                          const uint8_t *data, ContextList &cleared);
+
+    /**
+     * Atomically replace memory with desired if it is equal to
+     * expected. Accesses that HostAtomic can't handle lock-free are
+     * done under the lock of the block's shard, which makes them
+     * atomic with respect to each other, but not with respect to plain
+     * writes of the same bytes.
+     *
+     * @param expected Expected value, updated with the actual value if
+     *                 the swap fails
+     * @return true if memory was written
+     */
+    bool compareAndSwap(Addr addr, uint8_t *host, uint8_t *expected,
+                        const uint8_t *desired, unsigned size);
+
+    /**
+     * Clear the reservations of the blocks written by a context. This
+     * must be called after anything but a store-conditional has
+     * updated memory.
+     *
+     * @param cleared Other contexts that lost their reservation
+     */
+    void written(Addr addr, unsigned size, ContextID cid,
+                 ContextList &cleared);
+
+  private:
+    static const unsigned NumShards = 256;
+
+    struct alignas(64) Shard
+    {
+        std::mutex lock;
+        /** Number of reservations, read without holding the lock. */
+        std::atomic<unsigned> reservations{0};
+        /** Reserved block address and context of each reservation. */
+        std::vector<std::pair<Addr, ContextID>> records;
+    };
+
+    static Addr blockAlign(Addr addr) { return addr & ~(BlockSize - 1); }
+
+    Shard &
+    shard(Addr block)
+    {
+        return shards[(block / BlockSize) % NumShards];
+    }
+
+    /** Remove the reservation of a context for a block, if any. */
+    void release(Shard &s, Addr block, ContextID cid);
+
+    /** Remove all reservations for a block. The shard must be locked. */
+    void clearBlock(Shard &s, Addr block, ContextID cid,
+                    ContextList &cleared);
+
+    std::array<Shard, NumShards> shards;
+};
+
+#endif // __MEM_LLSC_MONITOR_HH__
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "mem/host_atomic.hh"
+#include "mem/llsc_monitor.hh"
+
+namespace
+{
+
+const Addr BaseAddr = 0x80000000;
+
+/** Host memory standing in for a backing store at BaseAddr. */
+struct Memory
+{
+    alignas(64) uint8_t bytes[4096] = {};
+
+    uint8_t *host(Addr addr) { return bytes + (addr - BaseAddr); }
+
+    uint64_t
+    read64(Addr addr)
+    {
+        uint64_t val;
+        std::memcpy(&val, host(addr), sizeof(val));
+        return val;
+    }
+};
+
+} // anonymous namespace
+
+TEST(LLSCMonitorTest, StoreConditionalSucceeds)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr addr = BaseAddr + 8;
+
+    uint64_t val = 42;
+    std::memcpy(mem.host(addr), &val, sizeof(val));
+
+    uint64_t data = 0;
+    monitor.loadLocked(0, res, addr, mem.host(addr), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+    EXPECT_EQ(42U, data);
+
+    data = 43;
+    EXPECT_TRUE(monitor.storeConditional(
+        0, res, addr, mem.host(addr), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+    EXPECT_EQ(43U, mem.read64(addr));
+    EXPECT_TRUE(cleared.empty());
+
+    // The reservation is used up.
+    data = 44;
+    EXPECT_FALSE(monitor.storeConditional(
+        0, res, addr, mem.host(addr), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+    EXPECT_EQ(43U, mem.read64(addr));
+}
+
+TEST(LLSCMonitorTest, WriteClearsReservations)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res0, res1;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr addr = BaseAddr + 64;
+
+    uint64_t data;
+    monitor.loadLocked(0, res0, addr, mem.host(addr), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+    monitor.loadLocked(1, res1, addr + 8, mem.host(addr + 8), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+
+    // A write by context 2 to the same block, but not the same bytes.
+    uint32_t val = 7;
+    HostAtomic::store(mem.host(addr + 32),
+                      reinterpret_cast<uint8_t *>(&val), sizeof(val));
+    monitor.written(addr + 32, sizeof(val), 2, cleared);
+    EXPECT_EQ((LLSCMonitor::ContextList{0, 1}), cleared);
+
+    data = 1;
+    cleared.clear();
+    EXPECT_FALSE(monitor.storeConditional(
+        0, res0, addr, mem.host(addr), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+    EXPECT_EQ(0U, mem.read64(addr));
+}
+
+TEST(LLSCMonitorTest, WriteToOtherBlockKeepsReservation)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr addr = BaseAddr;
+
+    uint64_t data;
+    monitor.loadLocked(0, res, addr, mem.host(addr), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+    monitor.written(addr + LLSCMonitor::BlockSize, 8, 1, cleared);
+    EXPECT_TRUE(cleared.empty());
+
+    data = 5;
+    EXPECT_TRUE(monitor.storeConditional(
+        0, res, addr, mem.host(addr), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+}
+
+TEST(LLSCMonitorTest, UntrackedWriteFailsStoreConditional)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr addr = BaseAddr + 128;
+
+    uint64_t data;
+    monitor.loadLocked(0, res, addr, mem.host(addr), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+
+    // E.g., DMA, which doesn't tell the monitor.
+    mem.host(addr)[0] = 1;
+
+    data = 2;
+    EXPECT_FALSE(monitor.storeConditional(
+        0, res, addr, mem.host(addr), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+    EXPECT_EQ(1U, mem.read64(addr));
+}
+
+TEST(LLSCMonitorTest, LoadLockedReplacesReservation)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr first = BaseAddr;
+    const Addr second = BaseAddr + 1024;
+
+    uint64_t data;
+    monitor.loadLocked(0, res, first, mem.host(first), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+    monitor.loadLocked(0, res, second, mem.host(second), sizeof(data),
+                       reinterpret_cast<uint8_t *>(&data));
+
+    // The first reservation is gone, so nobody is told about writes
+    // to it.
+    monitor.written(first, sizeof(data), 1, cleared);
+    EXPECT_TRUE(cleared.empty());
+
+    data = 3;
+    EXPECT_FALSE(monitor.storeConditional(
+        0, res, first, mem.host(first), sizeof(data),
+        reinterpret_cast<uint8_t *>(&data), cleared));
+}
+
+TEST(LLSCMonitorTest, WideStoreConditional)
+{
+    LLSCMonitor monitor;
+    LLSCMonitor::Reservation res;
+    LLSCMonitor::ContextList cleared;
+    Memory mem;
+    const Addr addr = BaseAddr + 16;
+
+    uint8_t data[16];
+    monitor.loadLocked(0, res, addr, mem.host(addr), sizeof(data), data);
+    std::memset(data, 0xab, sizeof(data));
+    EXPECT_TRUE(monitor.storeConditional(0, res, addr, mem.host(addr),
+                                         sizeof(data), data, cleared));
+    EXPECT_EQ(0, std::memcmp(mem.host(addr), data, sizeof(data)));
+}
+
+TEST(LLSCMonitorTest, CompareAndSwap)
+{
+    LLSCMonitor monitor;
+    Memory mem;
+
+    // Lock-free and unaligned accesses behave the same.
+    for (Addr addr : { BaseAddr + 4, BaseAddr + 61 }) {
+        uint32_t expected = 0, desired = 9;
+        EXPECT_TRUE(monitor.compareAndSwap(
+            addr, mem.host(addr), reinterpret_cast<uint8_t *>(&expected),
+            reinterpret_cast<uint8_t *>(&desired), sizeof(desired)));
+
+        desired = 10;
+        EXPECT_FALSE(monitor.compareAndSwap(
+            addr, mem.host(addr), reinterpret_cast<uint8_t *>(&expected),
+            reinterpret_cast<uint8_t *>(&desired), sizeof(desired)));
+        EXPECT_EQ(9U, expected);
+    }
+}
+
+TEST(LLSCMonitorTest, ConcurrentIncrements)
+{
+    LLSCMonitor monitor;
+    Memory mem;
+    const Addr llsc_addr = BaseAddr;
+    const Addr cas_addr = BaseAddr + 8;
+    const unsigned num_threads = 4;
+    const unsigned iterations = 20000;
+
+    auto worker = [&](ContextID cid) {
+        LLSCMonitor::Reservation res;
+        LLSCMonitor::ContextList cleared;
+        for (unsigned i = 0; i < iterations; i++) {
+            uint64_t val;
+            do {
+                monitor.loadLocked(cid, res, llsc_addr,
+                                   mem.host(llsc_addr), sizeof(val),
+                                   reinterpret_cast<uint8_t *>(&val));
+                val++;
+            } while (!monitor.storeConditional(
+                         cid, res, llsc_addr, mem.host(llsc_addr),
+                         sizeof(val), reinterpret_cast<uint8_t *>(&val),
+                         cleared));
+
+            uint64_t old_val, new_val;
+            HostAtomic::load(mem.host(cas_addr),
+                             reinterpret_cast<uint8_t *>(&old_val),
+                             sizeof(old_val));
+            do {
+                new_val = old_val + 1;
+            } while (!monitor.compareAndSwap(
+                         cas_addr, mem.host(cas_addr),
+                         reinterpret_cast<uint8_t *>(&old_val),
+                         reinterpret_cast<uint8_t *>(&new_val),
+                         sizeof(new_val)));
+            monitor.written(cas_addr, sizeof(new_val), cid, cleared);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; i++)
+        threads.emplace_back(worker, i);
+    for (auto &t : threads)
+        t.join();
+
+    EXPECT_EQ(num_threads * iterations, mem.read64(llsc_addr));
+    EXPECT_EQ(num_threads * iterations, mem.read64(cas_addr));
+}
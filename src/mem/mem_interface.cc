@@ -1890,6 +1890,7 @@ DRAMInterface::DRAMStats::DRAMStats(DRAMInterface &_dram)
     ADD_STAT(pageHitRate, "Row buffer hit rate, read and write combined")
 
 {
+    setCustomReset();
 }
 
 void
@@ -1963,6 +1964,7 @@ DRAMInterface::RankStats::RankStats(DRAMInterface &_dram, Rank &_rank)
     ADD_STAT(totalIdleTime, "Total Idle time Per DRAM Rank"),
     ADD_STAT(pwrStateTime, "Time in different power states")
 {
+    setCustomReset();
 }
 
 void
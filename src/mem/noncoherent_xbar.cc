@@ -244,6 +244,10 @@ Tick
 NoncoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
                                     MemBackdoorPtr *backdoor)
 {
+    // Requestors such as the table walkers of CPUs that are
+    // fast-forwarded in parallel call us from their own event queue.
+    EventQueue::ScopedMigration migrate(eventQueue());
+
     DPRINTF(NoncoherentXBar, "recvAtomic: packet src %s addr 0x%x cmd %s\n",
             cpuSidePorts[cpu_side_port_id]->name(), pkt->getAddr(),
             pkt->cmdString());
@@ -284,6 +288,9 @@ NoncoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
 void
 NoncoherentXBar::recvFunctional(PacketPtr pkt, PortID cpu_side_port_id)
 {
+    // See recvAtomicBackdoor().
+    EventQueue::ScopedMigration migrate(eventQueue());
+
     if (!pkt->isPrint()) {
         // don't do DPRINTFs on PrintReq as it clutters up the output
         DPRINTF(NoncoherentXBar,
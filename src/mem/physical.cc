@@ -47,6 +47,7 @@
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -54,6 +55,7 @@
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/host_atomic.hh"
 
 /**
  * On Linux, MAP_NORESERVE allow us to simulate a very large memory
@@ -299,6 +301,86 @@ PhysicalMemory::access(PacketPtr pkt)
     m->second->access(pkt);
 }
 
+bool
+PhysicalMemory::hasLockedAddrs() const
+{
+    for (const auto& m : memories) {
+        if (!m->getLockedAddrList().empty())
+            return true;
+    }
+    return false;
+}
+
+bool
+PhysicalMemory::backdoorAccess(PacketPtr pkt, uint8_t *host_addr,
+                               LLSCMonitor::Reservation &res,
+                               LLSCMonitor::ContextList &cleared)
+{
+    const Addr addr = pkt->getAddr();
+    const unsigned size = pkt->getSize();
+    const ContextID cid = pkt->req->hasContextId() ?
+        pkt->req->contextId() : InvalidContextID;
+
+    if (pkt->cmd == MemCmd::ReadReq) {
+        HostAtomic::load(host_addr, pkt->getPtr<uint8_t>(), size);
+    } else if (pkt->cmd == MemCmd::WriteReq) {
+        if (pkt->isMaskedWrite())
+            return false;
+        HostAtomic::store(host_addr, pkt->getConstPtr<uint8_t>(), size);
+        _llscMonitor.written(addr, size, cid, cleared);
+    } else if (pkt->cmd == MemCmd::LoadLockedReq) {
+        _llscMonitor.loadLocked(cid, res, addr, host_addr, size,
+                                pkt->getPtr<uint8_t>());
+    } else if (pkt->cmd == MemCmd::StoreCondReq) {
+        const bool success = _llscMonitor.storeConditional(
+            cid, res, addr, host_addr, size, pkt->getConstPtr<uint8_t>(),
+            cleared);
+        pkt->req->setExtraData(success ? 1 : 0);
+    } else if (pkt->cmd == MemCmd::SwapReq) {
+        if (size > sizeof(uint64_t))
+            return false;
+
+        uint64_t old_val = 0, new_val = 0;
+        uint8_t *old_bytes = reinterpret_cast<uint8_t *>(&old_val);
+        uint8_t *new_bytes = reinterpret_cast<uint8_t *>(&new_val);
+        bool overwrite_mem = true;
+
+        // Retry until memory hasn't changed between reading the old
+        // value and writing the new one.
+        HostAtomic::load(host_addr, old_bytes, size);
+        do {
+            if (pkt->isAtomicOp()) {
+                new_val = old_val;
+                (*(pkt->getAtomicOp()))(new_bytes);
+            } else {
+                std::memcpy(new_bytes, pkt->getConstPtr<uint8_t>(), size);
+                if (pkt->req->isCondSwap()) {
+                    panic_if(size != sizeof(uint64_t) &&
+                             size != sizeof(uint32_t),
+                             "Invalid size for conditional read/write\n");
+                    uint64_t condition_val64 = pkt->req->getExtraData();
+                    uint32_t condition_val32 = condition_val64;
+                    overwrite_mem = size == sizeof(uint64_t) ?
+                        !std::memcmp(&condition_val64, old_bytes, size) :
+                        !std::memcmp(&condition_val32, old_bytes, size);
+                }
+            }
+        } while (overwrite_mem &&
+                 !_llscMonitor.compareAndSwap(addr, host_addr, old_bytes,
+                                              new_bytes, size));
+
+        std::memcpy(pkt->getPtr<uint8_t>(), old_bytes, size);
+        if (overwrite_mem)
+            _llscMonitor.written(addr, size, cid, cleared);
+    } else {
+        return false;
+    }
+
+    if (pkt->needsResponse())
+        pkt->makeResponse();
+    return true;
+}
+
 void
 PhysicalMemory::functionalAccess(PacketPtr pkt)
 {
@@ -39,6 +39,7 @@
 #define __MEM_PHYSICAL_HH__
 
 #include "base/addr_range_map.hh"
+#include "mem/llsc_monitor.hh"
 #include "mem/packet.hh"
 
 /**
@@ -133,6 +134,9 @@ class PhysicalMemory : public Serializable
     // system
     std::vector<BackingStoreEntry> backingStore;
 
+    // LL/SC tracking for accesses made through backdoorAccess()
+    LLSCMonitor _llscMonitor;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -215,6 +219,40 @@ class PhysicalMemory : public Serializable
     std::vector<BackingStoreEntry> getBackingStore() const
     { return backingStore; }
 
+    /**
+     * Check if any of the memories is tracking a load-locked
+     * address. Accesses that bypass access() must not be made while
+     * this is the case, since the memories wouldn't see them.
+     *
+     * @return true if there is at least one locked address
+     */
+    bool hasLockedAddrs() const;
+
+    /**
+     * Perform an untimed access straight on the backing store of a
+     * memory in the global address map. Unlike access(), this may be
+     * called from several host threads at once. Naturally aligned
+     * accesses of up to eight bytes are atomic, LL/SC is tracked by
+     * llscMonitor() rather than by the memories, and swaps and atomic
+     * memory operations use a host compare-and-swap. The statistics
+     * of the memories are not updated.
+     *
+     * @param pkt Packet performing the access
+     * @param host_addr Host address that backs the packet's address
+     * @param res LL/SC reservation of the requesting context
+     * @param cleared Other contexts whose reservation was cleared by
+     *                the access, the caller has to notify them
+     * @return false if the packet has to use access() instead
+     */
+    bool backdoorAccess(PacketPtr pkt, uint8_t *host_addr,
+                        LLSCMonitor::Reservation &res,
+                        LLSCMonitor::ContextList &cleared);
+
+    /**
+     * Get the LL/SC monitor used by backdoorAccess().
+     */
+    LLSCMonitor &llscMonitor() { return _llscMonitor; }
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/block_mem_trace.hh"
+
+#include "base/output.hh"
+#include "params/BlockMemTraceProbe.hh"
+#include "sim/core.hh"
+#include "sim/system.hh"
+
+BlockMemTraceProbe::BlockMemTraceProbe(BlockMemTraceProbeParams *p)
+    : BaseMemProbe(p),
+      system(p->system),
+      withPC(p->with_pc)
+{
+    // If the trace file is not specified as an absolute path, put it in
+    // the simulation output directory
+    const std::string filename = simout.resolve(
+        p->trace_file != "" ? p->trace_file : name() + ".pbt");
+
+    trace.reset(new BlockTraceWriter(filename, p->block_size,
+                                     p->trace_compress));
+
+    // The destructor isn't called, so write the rest of the trace and its
+    // index on exit
+    registerExitCallback([this]() { trace->close(); });
+}
+
+void
+BlockMemTraceProbe::startup()
+{
+    std::vector<std::string> requestors;
+    for (int i = 0; i < system->maxRequestors(); i++)
+        requestors.push_back(system->getRequestorName(i));
+
+    trace->writeHeader(name(), SimClock::Frequency, requestors);
+}
+
+void
+BlockMemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+{
+    BlockTraceRecord record;
+    record.tick = curTick();
+    record.addr = pkt_info.addr;
+    record.pc = withPC ? pkt_info.pc : 0;
+    record.flags = pkt_info.flags;
+    record.size = pkt_info.size;
+    record.cmd = pkt_info.cmd.toInt();
+    record.requestorId = pkt_info.id;
+
+    trace->write(record);
+}
+
+BlockMemTraceProbe *
+BlockMemTraceProbeParams::create()
+{
+    return new BlockMemTraceProbe(this);
+}
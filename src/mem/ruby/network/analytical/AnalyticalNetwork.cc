@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "base/cast.hh"
+#include "base/intmath.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/BasicLink.hh"
+#include "mem/ruby/network/BasicRouter.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/network/Topology.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+using namespace std;
+
+AnalyticalNetwork::AnalyticalNetwork(const Params *p)
+    : Network(p), m_window(p->utilization_window),
+      m_max_utilization(p->max_utilization)
+{
+    setCustomReset();
+
+    fatal_if(m_window == 0, "%s: utilization_window must be non-zero\n",
+             name());
+    fatal_if(m_max_utilization < 0 || m_max_utilization >= 1,
+             "%s: max_utilization must be in [0, 1)\n", name());
+
+    // record the routers
+    for (vector<BasicRouter*>::const_iterator i = p->routers.begin();
+         i != p->routers.end(); ++i) {
+        m_router_latency.push_back((*i)->params()->latency);
+    }
+    m_out_ports.resize(m_router_latency.size());
+
+    m_inj_link.resize(m_nodes, vector<int>(m_virtual_networks, -1));
+    m_inj_router.resize(m_nodes, vector<int>(m_virtual_networks, -1));
+    m_last_arrival.resize(m_nodes, vector<Tick>(m_virtual_networks, 0));
+    m_blocked.resize(m_nodes, vector<vector<InPort *>>(m_virtual_networks));
+    m_dequeue_callback.resize(m_nodes,
+                              vector<bool>(m_virtual_networks, false));
+}
+
+void
+AnalyticalNetwork::init()
+{
+    Network::init();
+
+    // The topology pointer should have already been initialized in
+    // the parent class network constructor.
+    assert(m_topology_ptr != NULL);
+    m_topology_ptr->createLinks(this);
+
+    // Resolve the routing table entries of every router into the output
+    // port it uses for each destination. As with the simple network, the
+    // first port that reaches a destination is always taken.
+    m_next_port.resize(m_out_ports.size(),
+        vector<vector<int>>(m_virtual_networks, vector<int>(m_nodes, -1)));
+    for (int router = 0; router < m_out_ports.size(); router++) {
+        for (int port = 0; port < m_out_ports[router].size(); port++) {
+            const OutPort &out = m_out_ports[router][port];
+            for (int vnet = 0; vnet < m_virtual_networks; vnet++) {
+                for (NodeID dest : out.reach[vnet].getAllDest()) {
+                    int &next = m_next_port[router][vnet][
+                        getLocalNodeID(dest)];
+                    if (next < 0)
+                        next = port;
+                }
+            }
+        }
+    }
+}
+
+int
+AnalyticalNetwork::addLink(LinkType type, BasicLink *link)
+{
+    fatal_if(link->m_bandwidth_factor <= 0,
+             "%s: link %s needs a positive bandwidth_factor\n",
+             name(), link->name());
+
+    Link l;
+    l.type = type;
+    l.latency = link->m_latency;
+    l.bandwidth = link->m_bandwidth_factor;
+    l.windowStart = Cycles(0);
+    l.windowBusy = 0;
+    l.utilization = 0;
+    l.totalBusy = 0;
+    m_links.push_back(l);
+
+    return m_links.size() - 1;
+}
+
+// From a switch to an endpoint node
+void
+AnalyticalNetwork::makeExtOutLink(SwitchID src, NodeID global_dest,
+                                  BasicLink* link,
+                                  std::vector<NetDest>& routing_table_entry)
+{
+    assert(getLocalNodeID(global_dest) < m_nodes);
+    assert(src < m_out_ports.size());
+
+    OutPort out;
+    out.link = addLink(EXT_OUT, link);
+    out.reach = routing_table_entry;
+    out.router = -1;
+    m_out_ports[src].push_back(out);
+}
+
+// From an endpoint node to a switch
+void
+AnalyticalNetwork::makeExtInLink(NodeID global_src, SwitchID dest,
+                                 BasicLink* link,
+                                 std::vector<NetDest>& routing_table_entry)
+{
+    NodeID local_src = getLocalNodeID(global_src);
+    assert(local_src < m_nodes);
+    assert(dest < m_out_ports.size());
+
+    int link_id = addLink(EXT_IN, link);
+    for (int vnet = 0; vnet < m_virtual_networks; vnet++) {
+        if (!link->mVnets.empty() &&
+            find(link->mVnets.begin(), link->mVnets.end(), vnet) ==
+            link->mVnets.end()) {
+            continue;
+        }
+        m_inj_link[local_src][vnet] = link_id;
+        m_inj_router[local_src][vnet] = dest;
+    }
+
+    // The network consumes the messages of the node directly
+    vector<MessageBuffer*> &in = m_toNetQueues[local_src];
+    for (int vnet = 0; vnet < in.size(); ++vnet) {
+        if (in[vnet] != nullptr) {
+            m_in_ports.emplace_back(
+                new InPort(this, local_src, vnet, in[vnet]));
+            in[vnet]->setConsumer(m_in_ports.back().get());
+            in[vnet]->setIncomingLink(local_src);
+            in[vnet]->setVnet(vnet);
+        }
+    }
+}
+
+// From a switch to a switch
+void
+AnalyticalNetwork::makeInternalLink(SwitchID src, SwitchID dest,
+                                    BasicLink* link,
+                                    std::vector<NetDest>& routing_table_entry,
+                                    PortDirection src_outport,
+                                    PortDirection dst_inport)
+{
+    assert(src < m_out_ports.size());
+    assert(dest < m_out_ports.size());
+
+    OutPort out;
+    out.link = addLink(INT, link);
+    out.reach = routing_table_entry;
+    out.router = dest;
+    m_out_ports[src].push_back(out);
+}
+
+Cycles
+AnalyticalNetwork::linkDelay(int link_id, int bytes, Cycles when,
+                             int &flits)
+{
+    Link &link = m_links[link_id];
+    flits = divCeil(bytes, link.bandwidth);
+
+    // Roll the measurement window forward. If a whole window passed
+    // without any message crossing the link, it is idle.
+    if (when >= link.windowStart + m_window) {
+        uint64_t elapsed = (when - link.windowStart) / m_window;
+        link.utilization = (elapsed == 1) ?
+            double(link.windowBusy) / m_window : 0.0;
+        link.windowStart += Cycles(elapsed * m_window);
+        link.windowBusy = 0;
+    }
+    link.windowBusy += flits;
+    link.totalBusy += flits;
+
+    // Mean waiting time of an M/D/1 queue whose deterministic service
+    // time is the serialization of the message onto the link.
+    double rho = min(link.utilization, m_max_utilization);
+    double wait = rho * flits / (2.0 * (1.0 - rho));
+
+    return Cycles(llround(wait));
+}
+
+Cycles
+AnalyticalNetwork::traverse(NodeID src, NodeID dst, int vnet, int bytes,
+                            int &hops, int &flits)
+{
+    int link = m_inj_link[src][vnet];
+    int router = m_inj_router[src][vnet];
+    panic_if(link < 0, "%s: node %d has no link for vnet %d\n",
+             name(), src, vnet);
+
+    Cycles now = curCycle();
+    Cycles latency = m_links[link].latency +
+        linkDelay(link, bytes, now, flits);
+
+    hops = 0;
+    while (true) {
+        latency += m_router_latency[router];
+
+        int port = m_next_port[router][vnet][dst];
+        panic_if(port < 0, "%s: no route from router %d to node %d "
+                 "on vnet %d\n", name(), router, dst, vnet);
+        const OutPort &out = m_out_ports[router][port];
+
+        int link_flits;
+        latency += m_links[out.link].latency +
+            linkDelay(out.link, bytes, now + latency, link_flits);
+        flits = max(flits, link_flits);
+
+        if (out.router < 0)
+            break;
+
+        router = out.router;
+        hops++;
+        panic_if(hops > m_out_ports.size(), "%s: routing loop towards "
+                 "node %d on vnet %d\n", name(), dst, vnet);
+    }
+
+    // The tail of the message trails its head by the number of flits
+    // it occupies on the narrowest link of the path.
+    return latency + Cycles(flits - 1);
+}
+
+bool
+AnalyticalNetwork::deliver(NodeID src, int vnet, MessageBuffer *buffer,
+                           Tick now, NodeID &blocked_dest)
+{
+    MsgPtr msg_ptr = buffer->peekMsgPtr();
+    Message *net_msg_ptr = msg_ptr.get();
+    DPRINTF(RubyNetwork, "Message: %s\n", *net_msg_ptr);
+
+    // gets all the destinations associated with this message.
+    vector<NodeID> dest_nodes = net_msg_ptr->getDestination().getAllDest();
+
+    // Check for resources - for all destination buffers. Messages in
+    // flight are already accounted for in the destination buffer, so
+    // this back-pressures the sender like the credits of a real network.
+    for (NodeID dest : dest_nodes) {
+        MessageBuffer *out = m_fromNetQueues[getLocalNodeID(dest)][vnet];
+        if (!out->areNSlotsAvailable(1, now)) {
+            DPRINTF(RubyNetwork, "Can't deliver message since node %d "
+                    "is blocked\n", dest);
+            blocked_dest = getLocalNodeID(dest);
+            return false;
+        }
+    }
+
+    int bytes = MessageSizeType_to_int(net_msg_ptr->getMessageSize());
+    Tick queueing_delay = now - net_msg_ptr->getTime();
+
+    // The enqueue below modifies the message, so keep an unmodified copy
+    // around to clone for the remaining destinations.
+    MsgPtr unmodified_msg_ptr;
+    if (dest_nodes.size() > 1)
+        unmodified_msg_ptr = msg_ptr->clone();
+
+    buffer->dequeue(now);
+
+    for (int i = 0; i < dest_nodes.size(); i++) {
+        NodeID global_dest = dest_nodes[i];
+        NodeID dest = getLocalNodeID(global_dest);
+
+        if (i > 0)
+            msg_ptr = unmodified_msg_ptr->clone();
+
+        if (dest_nodes.size() > 1) {
+            // Each copy of a multicast message is only responsible for
+            // the destination it is delivered to.
+            for (int m = 0; m < (int) MachineType_NUM; m++) {
+                if ((global_dest >=
+                     MachineType_base_number((MachineType) m)) &&
+                    global_dest <
+                    MachineType_base_number((MachineType) (m+1))) {
+                    NetDest personal_dest;
+                    personal_dest.add((MachineID) {(MachineType) m,
+                        (global_dest -
+                         MachineType_base_number((MachineType) m))});
+                    msg_ptr->getDestination() = personal_dest;
+                    break;
+                }
+            }
+        }
+
+        int hops, flits;
+        Cycles latency = traverse(src, dest, vnet, bytes, hops, flits);
+        Tick arrival = now + cyclesToTicks(max(latency, Cycles(1)));
+
+        // Paths of different lengths must not reorder the messages of an
+        // ordered virtual network.
+        if (m_ordered[vnet]) {
+            arrival = max(arrival, m_last_arrival[dest][vnet]);
+            m_last_arrival[dest][vnet] = arrival;
+        }
+
+        DPRINTF(RubyNetwork, "Delivering message from node %d to node %d "
+                "on vnet %d in %d cycles over %d hops\n",
+                src, dest, vnet, latency, hops);
+
+        m_fromNetQueues[dest][vnet]->enqueue(msg_ptr, now, arrival - now);
+
+        m_packets_injected[vnet]++;
+        m_packets_received[vnet]++;
+        m_flits_injected[vnet] += flits;
+        m_flits_received[vnet] += flits;
+        m_packet_network_latency[vnet] += arrival - now;
+        m_packet_queueing_latency[vnet] += queueing_delay;
+        m_total_hops += hops;
+    }
+
+    return true;
+}
+
+void
+AnalyticalNetwork::wakeup(InPort &port)
+{
+    // Still waiting for the destination buffer to make room
+    if (port.blocked)
+        return;
+
+    Tick now = clockEdge();
+    NodeID dest;
+    while (port.buffer->isReady(now)) {
+        if (!deliver(port.node, port.vnet, port.buffer, now, dest)) {
+            port.blocked = true;
+            m_blocked[dest][port.vnet].push_back(&port);
+            if (!m_dequeue_callback[dest][port.vnet]) {
+                // The callback stays registered, it does nothing when no
+                // port is blocked on the buffer.
+                int vnet = port.vnet;
+                m_fromNetQueues[dest][vnet]->registerDequeueCallback(
+                    [this, dest, vnet]() { unblock(dest, vnet); });
+                m_dequeue_callback[dest][vnet] = true;
+            }
+            return;
+        }
+    }
+}
+
+void
+AnalyticalNetwork::unblock(NodeID dest, int vnet)
+{
+    vector<InPort *> &blocked = m_blocked[dest][vnet];
+    // A message can't be enqueued in the cycle of the dequeue that made
+    // room for it, so retry in the next cycle.
+    for (InPort *port : blocked) {
+        port->blocked = false;
+        port->scheduleEventAbsolute(clockEdge(Cycles(1)));
+    }
+    blocked.clear();
+}
+
+void
+AnalyticalNetwork::InPort::print(ostream& out) const
+{
+    out << "[AnalyticalNetwork input " << node << " vnet " << vnet << "]";
+}
+
+void
+AnalyticalNetwork::regStats()
+{
+    Network::regStats();
+
+    // Packets
+    m_packets_received
+        .init(m_virtual_networks)
+        .name(name() + ".packets_received")
+        .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_packets_injected
+        .init(m_virtual_networks)
+        .name(name() + ".packets_injected")
+        .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_packet_network_latency
+        .init(m_virtual_networks)
+        .name(name() + ".packet_network_latency")
+        .flags(Stats::oneline)
+        ;
+
+    m_packet_queueing_latency
+        .init(m_virtual_networks)
+        .name(name() + ".packet_queueing_latency")
+        .flags(Stats::oneline)
+        ;
+
+    for (int i = 0; i < m_virtual_networks; i++) {
+        m_packets_received.subname(i, csprintf("vnet-%i", i));
+        m_packets_injected.subname(i, csprintf("vnet-%i", i));
+        m_packet_network_latency.subname(i, csprintf("vnet-%i", i));
+        m_packet_queueing_latency.subname(i, csprintf("vnet-%i", i));
+    }
+
+    m_avg_packet_vnet_latency
+        .name(name() + ".average_packet_vnet_latency")
+        .flags(Stats::oneline);
+    m_avg_packet_vnet_latency =
+        m_packet_network_latency / m_packets_received;
+
+    m_avg_packet_vqueue_latency
+        .name(name() + ".average_packet_vqueue_latency")
+        .flags(Stats::oneline);
+    m_avg_packet_vqueue_latency =
+        m_packet_queueing_latency / m_packets_received;
+
+    m_avg_packet_network_latency
+        .name(name() + ".average_packet_network_latency");
+    m_avg_packet_network_latency =
+        sum(m_packet_network_latency) / sum(m_packets_received);
+
+    m_avg_packet_queueing_latency
+        .name(name() + ".average_packet_queueing_latency");
+    m_avg_packet_queueing_latency
+        = sum(m_packet_queueing_latency) / sum(m_packets_received);
+
+    m_avg_packet_latency
+        .name(name() + ".average_packet_latency");
+    m_avg_packet_latency
+        = m_avg_packet_network_latency + m_avg_packet_queueing_latency;
+
+    // Flits
+    m_flits_received
+        .init(m_virtual_networks)
+        .name(name() + ".flits_received")
+        .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_flits_injected
+        .init(m_virtual_networks)
+        .name(name() + ".flits_injected")
+        .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    for (int i = 0; i < m_virtual_networks; i++) {
+        m_flits_received.subname(i, csprintf("vnet-%i", i));
+        m_flits_injected.subname(i, csprintf("vnet-%i", i));
+    }
+
+    // Hops
+    m_avg_hops.name(name() + ".average_hops");
+    m_avg_hops = m_total_hops / sum(m_packets_received);
+
+    // Links
+    m_total_ext_in_link_utilization
+        .name(name() + ".ext_in_link_utilization");
+    m_total_ext_out_link_utilization
+        .name(name() + ".ext_out_link_utilization");
+    m_total_int_link_utilization
+        .name(name() + ".int_link_utilization");
+    m_average_link_utilization
+        .name(name() + ".avg_link_utilization");
+}
+
+void
+AnalyticalNetwork::collateStats()
+{
+    RubySystem *rs = params()->ruby_system;
+    double time_delta = double(curCycle() - rs->getStartCycle());
+
+    for (const Link &link : m_links) {
+        if (link.type == EXT_IN)
+            m_total_ext_in_link_utilization += link.totalBusy;
+        else if (link.type == EXT_OUT)
+            m_total_ext_out_link_utilization += link.totalBusy;
+        else
+            m_total_int_link_utilization += link.totalBusy;
+
+        m_average_link_utilization += double(link.totalBusy) / time_delta;
+    }
+}
+
+void
+AnalyticalNetwork::resetStats()
+{
+    Network::resetStats();
+
+    for (Link &link : m_links) {
+        link.totalBusy = 0;
+    }
+}
+
+void
+AnalyticalNetwork::print(ostream& out) const
+{
+    out << "[AnalyticalNetwork]";
+}
+
+AnalyticalNetwork *
+AnalyticalNetworkParams::create()
+{
+    return new AnalyticalNetwork(this);
+}
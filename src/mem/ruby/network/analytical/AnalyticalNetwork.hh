@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+#define __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/Network.hh"
+#include "params/AnalyticalNetwork.hh"
+
+/**
+ * A fast, approximate alternative to the garnet and simple networks.
+ *
+ * The analytical network does not model routers, virtual channels or
+ * flits. When a controller enqueues a message, the network walks the
+ * shortest path that the topology computed for the destination, adds up
+ * the router and link latencies along it and estimates the time spent
+ * waiting for each link with an M/D/1 queue whose utilization is taken
+ * from that link's load in the previous measurement window. The message
+ * is then delivered straight to the destination buffer with that delay.
+ *
+ * Since messages never reside inside the network, the cost of a network
+ * traversal is independent of the number of hops and no events are
+ * scheduled for the routers. Each input buffer is woken up on its own
+ * when a message arrives, and a sender blocked by a full destination
+ * buffer is only woken up again when that buffer is dequeued.
+ *
+ * The latency error against garnet has not been characterized yet. It
+ * is expected to grow with the injection rate, since contention is only
+ * estimated per link and per window. To measure it, run
+ * configs/example/garnet_synth_traffic.py with --network=analytical and
+ * --network=garnet on the same topology, sweeping --injectionrate for
+ * the uniform_random, tornado and bit_complement synthetic patterns,
+ * and compare average_packet_latency.
+ */
+class AnalyticalNetwork : public Network
+{
+  public:
+    typedef AnalyticalNetworkParams Params;
+    AnalyticalNetwork(const Params *p);
+    ~AnalyticalNetwork() = default;
+
+    void init() override;
+
+    // Methods used by Topology to setup the network
+    void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                        std::vector<NetDest>& routing_table_entry) override;
+    void makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                       std::vector<NetDest>& routing_table_entry) override;
+    void makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
+                          std::vector<NetDest>& routing_table_entry,
+                          PortDirection src_outport,
+                          PortDirection dst_inport) override;
+
+    void regStats() override;
+    void collateStats() override;
+    void resetStats() override;
+    void print(std::ostream& out) const override;
+
+    // Messages only live in the controllers' buffers, which are accessed
+    // functionally by the controllers themselves.
+    bool functionalRead(Packet *pkt) override { return false; }
+    uint32_t functionalWrite(Packet *pkt) override { return 0; }
+
+  private:
+    enum LinkType { EXT_IN, EXT_OUT, INT };
+
+    struct Link
+    {
+        LinkType type;
+        Cycles latency;
+        int bandwidth;
+
+        // Start of the current measurement window and the number of
+        // busy cycles accumulated in it.
+        Cycles windowStart;
+        uint64_t windowBusy;
+        // Utilization measured over the previous window.
+        double utilization;
+
+        // Busy cycles since the start of the simulation.
+        uint64_t totalBusy;
+    };
+
+    struct OutPort
+    {
+        int link;
+        // Destinations reached through this port, per vnet.
+        std::vector<NetDest> reach;
+        // Router at the other end of the link or -1 for an endpoint.
+        int router;
+    };
+
+    /** Consumer of the messages a node sends on a vnet */
+    class InPort : public Consumer
+    {
+      public:
+        InPort(AnalyticalNetwork *_network, NodeID _node, int _vnet,
+               MessageBuffer *_buffer)
+            : Consumer(_network), network(_network), node(_node),
+              vnet(_vnet), buffer(_buffer), blocked(false)
+        {}
+
+        void wakeup() override { network->wakeup(*this); }
+        void print(std::ostream& out) const override;
+
+        AnalyticalNetwork *const network;
+        const NodeID node;
+        const int vnet;
+        MessageBuffer *const buffer;
+        // Waiting for a destination buffer to be dequeued
+        bool blocked;
+    };
+
+    /** Deliver the ready messages of an input buffer */
+    void wakeup(InPort &port);
+
+    /** Wake up the ports blocked on a destination buffer */
+    void unblock(NodeID dest, int vnet);
+
+    int addLink(LinkType type, BasicLink *link);
+
+    /**
+     * Account for a message of the given size crossing a link at the
+     * given cycle and return the queueing delay it is expected to see.
+     */
+    Cycles linkDelay(int link_id, int bytes, Cycles when, int &flits);
+
+    /**
+     * Walk the route from a local source node to a local destination
+     * node and return the latency of the traversal.
+     */
+    Cycles traverse(NodeID src, NodeID dst, int vnet, int bytes, int &hops,
+                    int &flits);
+
+    /**
+     * Deliver the message at the head of an input buffer, or return
+     * false and the destination that is blocking it.
+     */
+    bool deliver(NodeID src, int vnet, MessageBuffer *buffer, Tick now,
+                 NodeID &blocked_dest);
+
+    // Private copy constructor and assignment operator
+    AnalyticalNetwork(const AnalyticalNetwork& obj);
+    AnalyticalNetwork& operator=(const AnalyticalNetwork& obj);
+
+    const Cycles m_window;
+    const double m_max_utilization;
+
+    std::vector<Link> m_links;
+    std::vector<Cycles> m_router_latency;
+    // Output ports of each router.
+    std::vector<std::vector<OutPort>> m_out_ports;
+    // Output port taken at each router towards each local node, per vnet.
+    std::vector<std::vector<std::vector<int>>> m_next_port;
+
+    // Injection link and router of each local node, per vnet.
+    std::vector<std::vector<int>> m_inj_link;
+    std::vector<std::vector<int>> m_inj_router;
+
+    std::vector<std::unique_ptr<InPort>> m_in_ports;
+    // Ports blocked on each destination buffer, per vnet, and whether the
+    // dequeue callback of that buffer has been registered.
+    std::vector<std::vector<std::vector<InPort *>>> m_blocked;
+    std::vector<std::vector<bool>> m_dequeue_callback;
+
+    // Latest arrival scheduled into each destination buffer, used to keep
+    // ordered virtual networks in FIFO order.
+    std::vector<std::vector<Tick>> m_last_arrival;
+
+    // Statistical variables
+    Stats::Vector m_packets_received;
+    Stats::Vector m_packets_injected;
+    Stats::Vector m_packet_network_latency;
+    Stats::Vector m_packet_queueing_latency;
+
+    Stats::Formula m_avg_packet_vnet_latency;
+    Stats::Formula m_avg_packet_vqueue_latency;
+    Stats::Formula m_avg_packet_network_latency;
+    Stats::Formula m_avg_packet_queueing_latency;
+    Stats::Formula m_avg_packet_latency;
+
+    Stats::Vector m_flits_received;
+    Stats::Vector m_flits_injected;
+
+    Stats::Scalar m_total_ext_in_link_utilization;
+    Stats::Scalar m_total_ext_out_link_utilization;
+    Stats::Scalar m_total_int_link_utilization;
+    Stats::Scalar m_average_link_utilization;
+
+    Stats::Scalar  m_total_hops;
+    Stats::Formula m_avg_hops;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const AnalyticalNetwork& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
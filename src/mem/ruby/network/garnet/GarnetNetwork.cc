@@ -54,8 +54,13 @@ using namespace std;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p), m_router_threads(p->router_threads),
+      m_router_eval_event([this]{ evaluateRouters(); },
+                          "GarnetNetwork router evaluation"),
+      m_router_eval_exit(false)
 {
+    setCustomReset();
+
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
     m_max_vcs_per_vnet = 0;
@@ -98,6 +103,17 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     inform("Garnet version %s\n", garnetVersion);
 }
 
+GarnetNetwork::~GarnetNetwork()
+{
+    if (!m_router_eval_workers.empty()) {
+        m_router_eval_exit = true;
+        m_router_eval_start->wait();
+        for (auto &worker : m_router_eval_workers) {
+            worker.join();
+        }
+    }
+}
+
 void
 GarnetNetwork::init()
 {
@@ -141,6 +157,80 @@ GarnetNetwork::init()
             router->printFaultVector(cout);
         }
     }
+
+    // The simulation thread takes part in the router evaluation, only
+    // spawn the additional workers.
+    if (m_router_threads > 1) {
+        m_router_eval_start.reset(new Barrier(m_router_threads));
+        m_router_eval_done.reset(new Barrier(m_router_threads));
+        for (unsigned tid = 1; tid < m_router_threads; tid++) {
+            m_router_eval_workers.emplace_back(
+                &GarnetNetwork::routerEvalThread, this, tid);
+        }
+    }
+}
+
+void
+GarnetNetwork::scheduleRouterEval(Router *router)
+{
+    assert(parallelRouterEval());
+    if (!router->markEvalPending()) {
+        return;
+    }
+
+    m_routers_to_eval.push_back(router);
+    if (!m_router_eval_event.scheduled()) {
+        schedule(m_router_eval_event, curTick());
+    }
+}
+
+void
+GarnetNetwork::evaluateRouters()
+{
+    // Read phase. Routers only consume flits and credits from their own
+    // input links and only produce into their own output queues, so their
+    // evaluations are independent of each other within a cycle. Trace
+    // output is not thread safe, fall back to a serial evaluation when
+    // tracing the network.
+    if (m_router_eval_workers.empty() || m_routers_to_eval.size() < 2 ||
+        DTRACE(RubyNetwork)) {
+        evaluateRouterShare(0, 1);
+    } else {
+        m_router_eval_start->wait();
+        evaluateRouterShare(0, m_router_threads);
+        m_router_eval_done->wait();
+    }
+
+    // Commit phase
+    for (auto router : m_routers_to_eval) {
+        router->commitWakeups();
+    }
+    m_routers_to_eval.clear();
+}
+
+void
+GarnetNetwork::evaluateRouterShare(unsigned tid, unsigned num_threads)
+{
+    for (size_t i = tid; i < m_routers_to_eval.size(); i += num_threads) {
+        m_routers_to_eval[i]->evaluateDeferred();
+    }
+}
+
+void
+GarnetNetwork::routerEvalThread(unsigned tid)
+{
+    // Routers read the current tick and their clock through the event
+    // queue of the simulation thread, which is stopped while they run.
+    curEventQueue(eventq);
+
+    while (true) {
+        m_router_eval_start->wait();
+        if (m_router_eval_exit) {
+            return;
+        }
+        evaluateRouterShare(tid, m_router_threads);
+        m_router_eval_done->wait();
+    }
 }
 
 /*
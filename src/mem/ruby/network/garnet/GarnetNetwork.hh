@@ -33,8 +33,12 @@
 #define __MEM_RUBY_NETWORK_GARNET_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 
+#include "base/barrier.hh"
+
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet/CommonTypes.hh"
@@ -52,7 +56,7 @@ class GarnetNetwork : public Network
   public:
     typedef GarnetNetworkParams Params;
     GarnetNetwork(const Params *p);
-    ~GarnetNetwork() = default;
+    ~GarnetNetwork();
 
     void init();
 
@@ -84,6 +88,10 @@ class GarnetNetwork : public Network
     int getNumRouters();
     int get_router_id(int ni, int vnet);
 
+    // Parallel router evaluation
+    bool parallelRouterEval() const { return m_router_threads > 0; }
+    void scheduleRouterEval(Router *router);
+
 
     // Methods used by Topology to setup the network
     void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
@@ -189,6 +197,26 @@ class GarnetNetwork : public Network
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
+    /**
+     * Evaluate all the routers woken up in the current cycle. The
+     * evaluation is split in two phases: the routers first run their
+     * pipeline stages, possibly in parallel, while all the wakeups they
+     * generate are buffered; the wakeups are then committed to the event
+     * queue serially, in the order the routers were woken up.
+     */
+    void evaluateRouters();
+    void evaluateRouterShare(unsigned tid, unsigned num_threads);
+    void routerEvalThread(unsigned tid);
+
+    // Number of host threads evaluating routers, 0 if disabled
+    const unsigned m_router_threads;
+    std::vector<Router *> m_routers_to_eval;
+    EventFunctionWrapper m_router_eval_event;
+    std::vector<std::thread> m_router_eval_workers;
+    std::unique_ptr<Barrier> m_router_eval_start;
+    std::unique_ptr<Barrier> m_router_eval_done;
+    bool m_router_eval_exit;
+
     std::vector<VNET_type > m_vnet_type;
     std::vector<Router *> m_routers;   // All Routers in Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
@@ -48,6 +48,9 @@ class GarnetNetwork(RubyNetwork):
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    router_threads = Param.UInt32(0, "number of host threads evaluating "
+        "the routers woken up in a cycle together (0: evaluate each "
+        "router on its own wakeup)")
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
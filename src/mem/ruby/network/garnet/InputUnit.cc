@@ -141,7 +141,8 @@ InputUnit::increment_credit(int in_vc, bool free_signal, Tick curTime)
     m_router->get_id(), in_vc, free_signal, m_credit_link->name());
     Credit *t_credit = new Credit(in_vc, free_signal, curTime);
     creditQueue.insert(t_credit);
-    m_credit_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+    m_router->scheduleConsumer(m_credit_link,
+                               m_router->clockEdge(Cycles(1)));
 }
 
 
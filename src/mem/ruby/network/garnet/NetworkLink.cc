@@ -43,6 +43,8 @@ NetworkLink::NetworkLink(const Params *p)
       m_virt_nets(p->virt_nets), linkBuffer(),
       link_consumer(nullptr), link_srcQueue(nullptr)
 {
+    setCustomReset();
+
     int num_vnets = (p->supported_vnets).size();
     mVnets.resize(num_vnets);
     bitWidth = p->width;
@@ -133,7 +133,8 @@ OutputUnit::wakeup()
         delete t_credit;
 
         if (m_credit_link->isReady(curTick())) {
-            scheduleEvent(Cycles(1));
+            m_router->scheduleConsumer(this,
+                                       m_router->clockEdge(Cycles(1)));
         }
     }
 }
@@ -160,7 +161,7 @@ void
 OutputUnit::insert_flit(flit *t_flit)
 {
     outBuffer.insert(t_flit);
-    m_out_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+    m_router->scheduleConsumer(m_out_link, m_router->clockEdge(Cycles(1)));
 }
 
 uint32_t
@@ -45,9 +45,11 @@ Router::Router(const Params *p)
   : BasicRouter(p), Consumer(this), m_latency(p->latency),
     m_virtual_networks(p->virt_nets), m_vc_per_vnet(p->vcs_per_vnet),
     m_num_vcs(m_virtual_networks * m_vc_per_vnet), m_bit_width(p->width),
-    m_network_ptr(nullptr), routingUnit(this), switchAllocator(this),
-    crossbarSwitch(this)
+    m_network_ptr(nullptr), m_eval_pending(false), m_defer_wakeups(false),
+    routingUnit(this), switchAllocator(this), crossbarSwitch(this)
 {
+    setCustomReset();
+
     m_input_unit.clear();
     m_output_unit.clear();
 }
@@ -63,6 +65,47 @@ Router::init()
 
 void
 Router::wakeup()
+{
+    if (m_network_ptr->parallelRouterEval()) {
+        // The network evaluates all the routers woken up in this cycle
+        // together
+        m_network_ptr->scheduleRouterEval(this);
+        return;
+    }
+
+    evaluate();
+}
+
+void
+Router::evaluateDeferred()
+{
+    m_defer_wakeups = true;
+    evaluate();
+}
+
+void
+Router::commitWakeups()
+{
+    m_defer_wakeups = false;
+    m_eval_pending = false;
+    for (auto &wakeup : m_deferred_wakeups) {
+        wakeup.first->scheduleEventAbsolute(wakeup.second);
+    }
+    m_deferred_wakeups.clear();
+}
+
+void
+Router::scheduleConsumer(Consumer *consumer, Tick when)
+{
+    if (m_defer_wakeups) {
+        m_deferred_wakeups.emplace_back(consumer, when);
+    } else {
+        consumer->scheduleEventAbsolute(when);
+    }
+}
+
+void
+Router::evaluate()
 {
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
     assert(clockEdge() == curTick());
@@ -167,7 +210,7 @@ void
 Router::schedule_wakeup(Cycles time)
 {
     // wake up after time cycles
-    scheduleEvent(time);
+    scheduleConsumer(this, clockEdge(time));
 }
 
 std::string
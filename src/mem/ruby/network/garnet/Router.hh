@@ -64,6 +64,28 @@ class Router : public BasicRouter, public Consumer
     void wakeup();
     void print(std::ostream& out) const {};
 
+    // Run the router pipeline stages for the current cycle
+    void evaluate();
+
+    /**
+     * Schedule a wakeup of a consumer driven by this router (the router
+     * itself, one of its output units or one of its links). While the
+     * router is evaluated as part of a parallel batch the wakeups are
+     * buffered and only handed to the event queue by commitWakeups().
+     */
+    void scheduleConsumer(Consumer *consumer, Tick when);
+
+    // Parallel evaluation support, see GarnetNetwork::evaluateRouters()
+    bool
+    markEvalPending()
+    {
+        bool was_pending = m_eval_pending;
+        m_eval_pending = true;
+        return !was_pending;
+    }
+    void evaluateDeferred();
+    void commitWakeups();
+
     void init();
     void addInPort(PortDirection inport_dirn, NetworkLink *link,
                    CreditLink *credit_link);
@@ -137,6 +159,10 @@ class Router : public BasicRouter, public Consumer
     uint32_t m_bit_width;
     GarnetNetwork *m_network_ptr;
 
+    bool m_eval_pending;
+    bool m_defer_wakeups;
+    std::vector<std::pair<Consumer *, Tick>> m_deferred_wakeups;
+
     RoutingUnit routingUnit;
     SwitchAllocator switchAllocator;
     CrossbarSwitch crossbarSwitch;
@@ -37,6 +37,7 @@
 #include "mem/ruby/slicc_interface/Message.hh"
 
 RoutingUnit::RoutingUnit(Router *router)
+    : m_rng(router->get_id())
 {
     m_router = router;
     m_routing_table.clear();
@@ -127,8 +128,14 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
 
     // Randomly select any candidate output link
     int candidate = 0;
-    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet)) {
+        // rand() is shared by all routers, so it cannot be used when they
+        // are evaluated concurrently.
+        if (m_router->get_net_ptr()->parallelRouterEval())
+            candidate = m_rng.random<int>(0, num_candidates - 1);
+        else
+            candidate = rand() % num_candidates;
+    }
 
     output_link = output_link_candidates.at(candidate);
     return output_link;
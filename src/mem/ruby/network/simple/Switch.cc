@@ -55,6 +55,8 @@ Switch::Switch(const Params *p)
   : BasicRouter(p), perfectSwitch(m_id, this, p->virt_nets),
     m_num_connected_buffers(0)
 {
+    setCustomReset();
+
     m_port_buffers.reserve(p->port_buffers.size());
     for (auto& buffer : p->port_buffers) {
         m_port_buffers.emplace_back(buffer);
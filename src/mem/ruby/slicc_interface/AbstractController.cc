@@ -58,6 +58,8 @@ AbstractController::AbstractController(const Params *p)
       memoryPort(csprintf("%s.memory", name()), this),
       addrRanges(p->addr_ranges.begin(), p->addr_ranges.end())
 {
+    setCustomReset();
+
     if (m_version == 0) {
         // Combine the statistics from all controllers
         // of this particular type.
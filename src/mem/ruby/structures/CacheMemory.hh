@@ -43,7 +43,6 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -187,6 +186,25 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    // Index of (set, way) in the flat, set-major tag store
+    size_t
+    blockIndex(int64_t cacheSet, int way) const
+    {
+        return cacheSet * m_cache_assoc + way;
+    }
+
+    AbstractCacheEntry*&
+    entryAt(int64_t cacheSet, int way)
+    {
+        return m_cache[blockIndex(cacheSet, way)];
+    }
+
+    AbstractCacheEntry*
+    entryAt(int64_t cacheSet, int way) const
+    {
+        return m_cache[blockIndex(cacheSet, way)];
+    }
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -195,10 +213,15 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    /**
+     * The tag store is kept flat and set-major: the ways of set S occupy
+     * indices [S * assoc, (S + 1) * assoc). m_tags mirrors the line
+     * address of each allocated entry (or MaxAddr for an empty way) so a
+     * lookup scans a handful of contiguous Addrs instead of chasing entry
+     * pointers or consulting a global hash map.
+     */
+    std::vector<AbstractCacheEntry*> m_cache;
+    std::vector<Addr> m_tags;
 
     /**
      * We use BaseReplacementPolicy from Classic system here, hence we can use
@@ -29,6 +29,8 @@
 
 #include "mem/ruby/system/CacheRecorder.hh"
 
+#include <algorithm>
+
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
@@ -44,22 +46,27 @@ TraceRecord::print(ostream& out) const
 }
 
 CacheRecorder::CacheRecorder()
-    : m_uncompressed_trace(NULL),
-      m_uncompressed_trace_size(0),
-      m_block_size_bytes(RubySystem::getBlockSizeBytes())
+    : m_trace(NULL),
+      m_trace_size(0),
+      m_bytes_read(0), m_records_read(0), m_records_flushed(0),
+      m_block_size_bytes(RubySystem::getBlockSizeBytes()),
+      m_max_outstanding(1), m_outstanding(0), m_stalled(NULL)
 {
 }
 
-CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
-                             uint64_t uncompressed_trace_size,
+CacheRecorder::CacheRecorder(gzFile trace,
+                             uint64_t trace_size,
                              std::vector<Sequencer*>& seq_map,
-                             uint64_t block_size_bytes)
-    : m_uncompressed_trace(uncompressed_trace),
-      m_uncompressed_trace_size(uncompressed_trace_size),
+                             uint64_t block_size_bytes,
+                             unsigned max_outstanding)
+    : m_trace(trace),
+      m_trace_size(trace_size),
       m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
-      m_records_flushed(0), m_block_size_bytes(block_size_bytes)
+      m_records_flushed(0), m_block_size_bytes(block_size_bytes),
+      m_max_outstanding(std::max(max_outstanding, 1U)), m_outstanding(0),
+      m_stalled(NULL)
 {
-    if (m_uncompressed_trace != NULL) {
+    if (m_trace != NULL) {
         if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
             // Block sizes larger than when the trace was recorded are not
             // supported, as we cannot reliably turn accesses to smaller blocks
@@ -72,18 +79,34 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
 
 CacheRecorder::~CacheRecorder()
 {
-    if (m_uncompressed_trace != NULL) {
-        delete [] m_uncompressed_trace;
-        m_uncompressed_trace = NULL;
+    if (m_trace != NULL) {
+        gzclose(m_trace);
+        m_trace = NULL;
+    }
+    assert(m_pending.empty());
+    delete m_stalled;
+    for (auto fetch : m_free_fetches) {
+        delete fetch;
     }
     m_seq_map.clear();
 }
 
+Sequencer *
+CacheRecorder::getSequencer(int cntrl_id) const
+{
+    assert(!m_seq_map.empty());
+    // A trace recorded on a system with more controllers than this one
+    // is folded onto the controllers that exist here.
+    Sequencer *seq = m_seq_map[cntrl_id % m_seq_map.size()];
+    assert(seq != NULL);
+    return seq;
+}
+
 void
 CacheRecorder::enqueueNextFlushRequest()
 {
-    if (m_records_flushed < m_records.size()) {
-        TraceRecord* rec = m_records[m_records_flushed];
+    if (m_records_flushed < m_record_order.size()) {
+        const TraceRecord* rec = getRecord(m_records_flushed);
         m_records_flushed++;
         auto req = std::make_shared<Request>(rec->m_data_address,
                                              m_block_size_bytes, 0,
@@ -91,8 +114,7 @@ CacheRecorder::enqueueNextFlushRequest()
         MemCmd::Command requestType = MemCmd::FlushReq;
         Packet *pkt = new Packet(req, requestType);
 
-        Sequencer* m_sequencer_ptr = m_seq_map[rec->m_cntrl_id];
-        assert(m_sequencer_ptr != NULL);
+        Sequencer* m_sequencer_ptr = getSequencer(rec->m_cntrl_id);
         m_sequencer_ptr->makeRequest(pkt);
 
         DPRINTF(RubyCacheTrace, "Flushing %s\n", *rec);
@@ -101,61 +123,148 @@ CacheRecorder::enqueueNextFlushRequest()
     }
 }
 
-void
-CacheRecorder::enqueueNextFetchRequest()
+CacheRecorder::PendingFetch *
+CacheRecorder::readNextRecord()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    if (m_trace == NULL || m_bytes_read >= m_trace_size) {
+        return NULL;
+    }
 
-        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+    PendingFetch *fetch;
+    if (m_free_fetches.empty()) {
+        fetch = new PendingFetch;
+        fetch->record.resize(recordSize());
+    } else {
+        fetch = m_free_fetches.back();
+        m_free_fetches.pop_back();
+    }
+
+    if (gzread(m_trace, fetch->record.data(), recordSize()) !=
+        (int)recordSize()) {
+        fatal("Unable to read complete record %d from cache trace\n",
+              m_records_read);
+    }
+    fetch->packetsLeft = m_block_size_bytes /
+                         RubySystem::getBlockSizeBytes();
+    fetch->packetsIssued = 0;
 
+    m_bytes_read += recordSize();
+    m_records_read++;
+    return fetch;
+}
+
+bool
+CacheRecorder::issueFetch(PendingFetch *fetch)
+{
+    TraceRecord* traceRecord = fetch->get();
+    const unsigned block_size = RubySystem::getBlockSizeBytes();
+
+    if (fetch->packetsIssued == 0) {
+        // Hold the record back while an older record touching the same
+        // blocks is still in flight.
         for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
-                rec_bytes_read += RubySystem::getBlockSizeBytes()) {
-            RequestPtr req;
-            MemCmd::Command requestType;
-
-            if (traceRecord->m_type == RubyRequestType_LD) {
-                requestType = MemCmd::ReadReq;
-                req = std::make_shared<Request>(
-                    traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0,
-                                    Request::funcRequestorId);
-            }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
-                requestType = MemCmd::ReadReq;
-                req = std::make_shared<Request>(
-                        traceRecord->m_data_address + rec_bytes_read,
-                        RubySystem::getBlockSizeBytes(),
-                        Request::INST_FETCH, Request::funcRequestorId);
-            }   else {
-                requestType = MemCmd::WriteReq;
-                req = std::make_shared<Request>(
-                    traceRecord->m_data_address + rec_bytes_read,
-                    RubySystem::getBlockSizeBytes(), 0,
-                                Request::funcRequestorId);
+                rec_bytes_read += block_size) {
+            if (m_pending.count(traceRecord->m_data_address +
+                                rec_bytes_read)) {
+                return false;
             }
+        }
+        DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
+    }
 
-            Packet *pkt = new Packet(req, requestType);
-            pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+    Sequencer* m_sequencer_ptr = getSequencer(traceRecord->m_cntrl_id);
 
-            Sequencer* m_sequencer_ptr = m_seq_map[traceRecord->m_cntrl_id];
-            assert(m_sequencer_ptr != NULL);
-            m_sequencer_ptr->makeRequest(pkt);
+    for (int rec_bytes_read = fetch->packetsIssued * block_size;
+            rec_bytes_read < m_block_size_bytes;
+            rec_bytes_read += block_size) {
+        RequestPtr req;
+        MemCmd::Command requestType;
+        Addr addr = traceRecord->m_data_address + rec_bytes_read;
+
+        if (traceRecord->m_type == RubyRequestType_LD) {
+            requestType = MemCmd::ReadReq;
+            req = std::make_shared<Request>(addr, block_size, 0,
+                                            Request::funcRequestorId);
+        }   else if (traceRecord->m_type == RubyRequestType_IFETCH) {
+            requestType = MemCmd::ReadReq;
+            req = std::make_shared<Request>(addr, block_size,
+                    Request::INST_FETCH, Request::funcRequestorId);
+        }   else {
+            requestType = MemCmd::WriteReq;
+            req = std::make_shared<Request>(addr, block_size, 0,
+                                            Request::funcRequestorId);
         }
 
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
-        m_records_read++;
-    } else {
+        Packet *pkt = new Packet(req, requestType);
+        pkt->dataStatic(traceRecord->m_data + rec_bytes_read);
+
+        RequestStatus status = m_sequencer_ptr->makeRequest(pkt);
+        if (status != RequestStatus_Issued) {
+            // The sequencer is full, retry once one of our own requests
+            // has completed.
+            DPRINTF(RubyCacheTrace, "Sequencer busy, stalling %s\n",
+                    *traceRecord);
+            delete pkt;
+            return false;
+        }
+
+        m_pending[addr] = fetch;
+        fetch->packetsIssued++;
+        m_outstanding++;
+    }
+
+    return true;
+}
+
+void
+CacheRecorder::enqueueNextFetchRequest()
+{
+    while (m_outstanding < m_max_outstanding) {
+        PendingFetch *fetch = m_stalled ? m_stalled : readNextRecord();
+        m_stalled = NULL;
+        if (fetch == NULL) {
+            break;
+        }
+
+        if (!issueFetch(fetch)) {
+            m_stalled = fetch;
+            break;
+        }
+    }
+
+    if (m_outstanding == 0 && m_stalled == NULL) {
         DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
     }
 }
 
+void
+CacheRecorder::fetchRequestComplete(PacketPtr pkt)
+{
+    auto it = m_pending.find(pkt->getAddr());
+    assert(it != m_pending.end());
+    PendingFetch *fetch = it->second;
+    m_pending.erase(it);
+
+    assert(m_outstanding > 0);
+    m_outstanding--;
+
+    assert(fetch->packetsLeft > 0);
+    if (--fetch->packetsLeft == 0) {
+        m_free_fetches.push_back(fetch);
+    }
+
+    enqueueNextFetchRequest();
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
 {
-    TraceRecord* rec = (TraceRecord*)malloc(sizeof(TraceRecord) +
-                                            m_block_size_bytes);
+    const uint64_t offset = m_record_buf.size();
+    m_record_buf.resize(offset + recordSize());
+    m_record_order.push_back(m_record_order.size());
+
+    TraceRecord* rec = (TraceRecord*)(m_record_buf.data() + offset);
     rec->m_cntrl_id     = cntrl;
     rec->m_time         = time;
     rec->m_data_address = data_addr;
@@ -163,42 +272,30 @@ CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
     rec->m_type         = type;
     memcpy(rec->m_data, data.getData(0, m_block_size_bytes),
            m_block_size_bytes);
-
-    m_records.push_back(rec);
 }
 
 uint64_t
-CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
+CacheRecorder::writeRecords(gzFile trace, const std::string &filename)
 {
-    std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
+    // Most recently accessed blocks go first. Sorting the index rather than
+    // the records keeps the (potentially multi-GiB) data where it is.
+    std::stable_sort(m_record_order.begin(), m_record_order.end(),
+        [this](uint64_t a, uint64_t b) {
+            const uint8_t *base = m_record_buf.data();
+            return ((const TraceRecord *)(base + a * recordSize()))->m_time >
+                   ((const TraceRecord *)(base + b * recordSize()))->m_time;
+        });
 
-    int size = m_records.size();
     uint64_t current_size = 0;
-    int record_size = sizeof(TraceRecord) + m_block_size_bytes;
-
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
+    for (uint64_t i = 0; i < m_record_order.size(); ++i) {
+        if (gzwrite(trace, getRecord(i), recordSize()) != (int)recordSize()) {
+            fatal("Write failed on memory trace file '%s'\n", filename);
         }
-
-        // Copy the current record into the buffer
-        memcpy(&((*buf)[current_size]), m_records[i], record_size);
-        current_size += record_size;
-
-        free(m_records[i]);
-        m_records[i] = NULL;
+        current_size += recordSize();
     }
 
-    m_records.clear();
+    m_record_order.clear();
+    m_record_buf.clear();
+    m_record_buf.shrink_to_fit();
     return current_size;
 }
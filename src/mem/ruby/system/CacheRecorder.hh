@@ -35,9 +35,13 @@
 #ifndef __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 #define __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
 
+#include <zlib.h>
+
+#include <unordered_map>
 #include <vector>
 
 #include "base/types.hh"
+#include "mem/packet.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
@@ -45,11 +49,13 @@
 
 class Sequencer;
 
-/*!
- * Class for recording cache contents. Note that the last element of the
- * class is an array of length zero. It is used for creating variable
- * length object, so that while writing the data to a file one does not
- * need to copy the meta data and the actual data separately.
+/*
+ * The on-disk trace is a gzip'd stream of these records, each followed by
+ * the recorded block's data. The layout is shared by every protocol: a
+ * record only names the controller whose cache held the block, which is
+ * remapped onto the sequencers of the restoring system, so a trace can
+ * warm up a different protocol or cache geometry than the one that
+ * recorded it (as long as the recorded block size is not smaller).
  */
 class TraceRecord {
   public:
@@ -69,14 +75,33 @@ class CacheRecorder
     CacheRecorder();
     ~CacheRecorder();
 
-    CacheRecorder(uint8_t* uncompressed_trace,
-                  uint64_t uncompressed_trace_size,
+    /*!
+     * Create a recorder that replays the trace in the given gzip stream.
+     * Records are decoded incrementally as the warmup proceeds, so the
+     * uncompressed trace is never held in memory as a whole. The
+     * recorder takes ownership of the stream.
+     *
+     * @param trace Stream positioned at the first record, or NULL.
+     * @param trace_size Uncompressed size of the trace in bytes.
+     * @param max_outstanding Maximum number of warmup requests that may
+     *        be in flight at once across all sequencers.
+     */
+    CacheRecorder(gzFile trace,
+                  uint64_t trace_size,
                   std::vector<Sequencer*>& SequencerMap,
-                  uint64_t block_size_bytes);
+                  uint64_t block_size_bytes,
+                  unsigned max_outstanding = 1);
     void addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                    RubyRequestType type, Tick time, DataBlock& data);
 
-    uint64_t aggregateRecords(uint8_t **data, uint64_t size);
+    /*!
+     * Write all the recorded records, most recently accessed first, to
+     * the given gzip stream. Records are written straight from the
+     * recording buffer and released once written.
+     *
+     * @return The uncompressed number of bytes written.
+     */
+    uint64_t writeRecords(gzFile trace, const std::string &filename);
 
     /*!
      * Function for flushing the memory contents of the caches to the
@@ -91,32 +116,82 @@ class CacheRecorder
     /*!
      * Function for fetching warming up the memory and the caches. It goes
      * through the recorded contents of the caches, as available in the
-     * checkpoint and issues fetch requests. Except for the first one, a
-     * fetch request is issued only after the previous one has completed.
-     * It should be possible to use this with any protocol.
+     * checkpoint and issues fetch requests. Up to max_outstanding fetches
+     * are kept in flight; a record is held back while an earlier record
+     * for the same block is still outstanding so that the final cache
+     * state does not depend on the completion order. It should be
+     * possible to use this with any protocol.
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Called by a sequencer when a warmup fetch has completed, before the
+     * packet is deleted. Releases the record and refills the window.
+     */
+    void fetchRequestComplete(PacketPtr pkt);
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
-    std::vector<TraceRecord*> m_records;
-    uint8_t* m_uncompressed_trace;
-    uint64_t m_uncompressed_trace_size;
+    /** A record that has been read from the trace and is being fetched. */
+    struct PendingFetch
+    {
+        std::vector<uint8_t> record;
+        unsigned packetsIssued;
+        unsigned packetsLeft;
+
+        TraceRecord *
+        get()
+        {
+            return reinterpret_cast<TraceRecord *>(record.data());
+        }
+    };
+
+    uint64_t recordSize() const
+    {
+        return sizeof(TraceRecord) + m_block_size_bytes;
+    }
+
+    const TraceRecord *
+    getRecord(uint64_t idx) const
+    {
+        return reinterpret_cast<const TraceRecord *>(
+            m_record_buf.data() + m_record_order[idx] * recordSize());
+    }
+
+    /** Map a recorded controller onto a sequencer of this system. */
+    Sequencer *getSequencer(int cntrl_id) const;
+
+    /** Decode the next record from the trace, or NULL at the end. */
+    PendingFetch *readNextRecord();
+
+    /** Issue all the packets of a fetch, returns false on back-pressure */
+    bool issueFetch(PendingFetch *fetch);
+
+    // Recording: records are appended to a single contiguous buffer and
+    // sorted through an index vector when they are written out.
+    std::vector<uint8_t> m_record_buf;
+    std::vector<uint64_t> m_record_order;
+
+    // Replay
+    gzFile m_trace;
+    uint64_t m_trace_size;
     std::vector<Sequencer*> m_seq_map;
     uint64_t m_bytes_read;
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
-};
 
-inline bool
-compareTraceRecords(const TraceRecord* n1, const TraceRecord* n2)
-{
-    return n1->m_time > n2->m_time;
-}
+    const unsigned m_max_outstanding;
+    unsigned m_outstanding;
+    /** Record that could not be issued yet and must go next */
+    PendingFetch *m_stalled;
+    /** Outstanding fetches indexed by the line addresses they touch */
+    std::unordered_map<Addr, PendingFetch *> m_pending;
+    std::vector<PendingFetch *> m_free_fetches;
+};
 
 inline std::ostream&
 operator<<(std::ostream& out, const TraceRecord& obj)
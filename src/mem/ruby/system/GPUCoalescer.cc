@@ -159,6 +159,8 @@ GPUCoalescer::GPUCoalescer(const Params *p)
       deadlockCheckEvent([this]{ wakeup(); }, "GPUCoalescer deadlock check"),
       gmTokenPort(name() + ".gmTokenPort", this)
 {
+    setCustomReset();
+
     m_store_waiting_on_load_cycles = 0;
     m_store_waiting_on_store_cycles = 0;
     m_load_waiting_on_store_cycles = 0;
@@ -75,6 +75,8 @@ RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
       m_cache_recorder(NULL)
 {
+    setCustomReset();
+
     m_randomization = p->randomization;
 
     m_block_size_bytes = p->block_size_bytes;
@@ -168,7 +170,7 @@ RubySystem::~RubySystem()
 }
 
 void
-RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
+RubySystem::makeCacheRecorder(gzFile cache_trace,
                               uint64_t cache_trace_size,
                               uint64_t block_size_bytes)
 {
@@ -196,8 +198,9 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
     }
 
     // Create the CacheRecorder and record the cache trace
-    m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+    m_cache_recorder = new CacheRecorder(cache_trace, cache_trace_size,
+                                         sequencer_map, block_size_bytes,
+                                         params()->warmup_max_outstanding);
 }
 
 void
@@ -272,33 +275,26 @@ RubySystem::memWriteback()
     // checkpoint is immediately taken.
 }
 
-void
-RubySystem::writeCompressedTrace(uint8_t *raw_data, string filename,
-                                 uint64_t uncompressed_trace_size)
+gzFile
+RubySystem::openCompressedTrace(string filename, bool write)
 {
-    // Create the checkpoint file for the memory
-    string thefile = CheckpointIn::dir() + "/" + filename.c_str();
-
-    int fd = creat(thefile.c_str(), 0664);
+    int fd = write ? creat(filename.c_str(), 0664) :
+                     open(filename.c_str(), O_RDONLY);
     if (fd < 0) {
-        perror("creat");
-        fatal("Can't open memory trace file '%s'\n", filename);
+        perror(write ? "creat" : "open");
+        fatal("Unable to open cache trace file '%s'\n", filename);
     }
 
-    gzFile compressedMemory = gzdopen(fd, "wb");
-    if (compressedMemory == NULL)
+    gzFile trace = gzdopen(fd, write ? "wb" : "rb");
+    if (trace == NULL) {
         fatal("Insufficient memory to allocate compression state for %s\n",
               filename);
-
-    if (gzwrite(compressedMemory, raw_data, uncompressed_trace_size) !=
-        uncompressed_trace_size) {
-        fatal("Write failed on memory trace file '%s'\n", filename);
     }
 
-    if (gzclose(compressedMemory)) {
-        fatal("Close failed on memory trace file '%s'\n", filename);
-    }
-    delete[] raw_data;
+    // Records are streamed through zlib one at a time, a larger buffer
+    // keeps the number of underlying reads and writes down.
+    gzbuffer(trace, 1 << 20);
+    return trace;
 }
 
 void
@@ -317,12 +313,15 @@ RubySystem::serialize(CheckpointOut &cp) const
         fatal("Call memWriteback() before serialize() to create ruby trace");
     }
 
-    // Aggregate the trace entries together into a single array
-    uint8_t *raw_data = new uint8_t[4096];
-    uint64_t cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
-                                                                 4096);
+    // Stream the trace entries into the checkpoint
     string cache_trace_file = name() + ".cache.gz";
-    writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
+    gzFile trace = openCompressedTrace(
+        CheckpointIn::dir() + "/" + cache_trace_file, true);
+    uint64_t cache_trace_size = m_cache_recorder->writeRecords(
+        trace, cache_trace_file);
+    if (gzclose(trace)) {
+        fatal("Close failed on memory trace file '%s'\n", cache_trace_file);
+    }
 
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
@@ -339,42 +338,9 @@ RubySystem::drainResume()
     }
 }
 
-void
-RubySystem::readCompressedTrace(string filename, uint8_t *&raw_data,
-                                uint64_t &uncompressed_trace_size)
-{
-    // Read the trace file
-    gzFile compressedTrace;
-
-    // trace file
-    int fd = open(filename.c_str(), O_RDONLY);
-    if (fd < 0) {
-        perror("open");
-        fatal("Unable to open trace file %s", filename);
-    }
-
-    compressedTrace = gzdopen(fd, "rb");
-    if (compressedTrace == NULL) {
-        fatal("Insufficient memory to allocate compression state for %s\n",
-              filename);
-    }
-
-    raw_data = new uint8_t[uncompressed_trace_size];
-    if (gzread(compressedTrace, raw_data, uncompressed_trace_size) <
-            uncompressed_trace_size) {
-        fatal("Unable to read complete trace from file %s\n", filename);
-    }
-
-    if (gzclose(compressedTrace)) {
-        fatal("Failed to close cache trace file '%s'\n", filename);
-    }
-}
-
 void
 RubySystem::unserialize(CheckpointIn &cp)
 {
-    uint8_t *uncompressed_trace = NULL;
-
     // This value should be set to the checkpoint-system's block-size.
     // Optional, as checkpoints without it can be run if the
     // checkpoint-system's block-size == current block-size.
@@ -388,13 +354,13 @@ RubySystem::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(cache_trace_size);
     cache_trace_file = cp.getCptDir() + "/" + cache_trace_file;
 
-    readCompressedTrace(cache_trace_file, uncompressed_trace,
-                        cache_trace_size);
+    // The trace is decoded incrementally while the warmup runs.
+    gzFile trace = openCompressedTrace(cache_trace_file, false);
     m_warmup_enabled = true;
     m_systems_to_warmup++;
 
     // Create the cache recorder that will hang around until startup.
-    makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
+    makeCacheRecorder(trace, cache_trace_size, block_size_bytes);
 }
 
 void
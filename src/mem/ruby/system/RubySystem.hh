@@ -112,15 +112,11 @@ class RubySystem : public ClockedObject
     RubySystem(const RubySystem& obj);
     RubySystem& operator=(const RubySystem& obj);
 
-    void makeCacheRecorder(uint8_t *uncompressed_trace,
+    void makeCacheRecorder(gzFile cache_trace,
                            uint64_t cache_trace_size,
                            uint64_t block_size_bytes);
 
-    static void readCompressedTrace(std::string filename,
-                                    uint8_t *&raw_data,
-                                    uint64_t &uncompressed_trace_size);
-    static void writeCompressedTrace(uint8_t *raw_data, std::string file,
-                                     uint64_t uncompressed_trace_size);
+    static gzFile openCompressedTrace(std::string filename, bool write);
 
     void processRubyEvent();
   private:
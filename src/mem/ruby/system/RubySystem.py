@@ -47,6 +47,9 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    warmup_max_outstanding = Param.Unsigned(1, "Maximum number of cache \
+        warmup requests in flight when restoring from a checkpoint")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
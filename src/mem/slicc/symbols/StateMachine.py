@@ -387,6 +387,24 @@ bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
 static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
 static int m_num_controllers;
+''')
+
+        if self.symtab.slicc.transition_table:
+            params = self.transitionParams()
+            code('''
+
+// Transition dispatch table, indexed by state and event
+typedef TransitionResult (${c_ident}::*TransitionFunc)($params);
+static const TransitionFunc
+    m_transition_table[${ident}_State_NUM][${ident}_Event_NUM];
+
+// Transitions
+''')
+            for trans in self.transitionCases().values():
+                code('TransitionResult '
+                     '${{self.transitionFuncName(trans[0])}}($params);')
+
+        code('''
 
 // Internal functions
 ''')
@@ -1264,6 +1282,181 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
+    def transitionParams(self):
+        '''Parameter list shared by the generated transition functions'''
+
+        params = ['%s_State& next_state' % self.ident]
+        if self.TBEType != None:
+            params.append('%s*& m_tbe_ptr' % self.TBEType.c_ident)
+        if self.EntryType != None:
+            params.append('%s*& m_cache_entry_ptr' % self.EntryType.c_ident)
+        params.append('Addr addr')
+        return ', '.join(params)
+
+    def transitionFuncName(self, trans):
+        return 'transition_%s_%s' % (trans.state.ident, trans.event.ident)
+
+    def transitionCases(self):
+        '''Generate the code of every transition. Transitions that share
+        the same code are grouped together; the returned map goes from the
+        code to the list of transitions using it.'''
+
+        ident = self.ident
+
+        # This map will allow suppress generating duplicate code
+        cases = OrderedDict()
+
+        for trans in self.transitions:
+            case = self.symtab.codeFormatter()
+            # Only set next_state if it changes
+            if trans.state != trans.nextState:
+                if trans.nextState.isWildcard():
+                    # When * is encountered as an end state of a transition,
+                    # the next state is determined by calling the
+                    # machine-specific getNextState function. The next state
+                    # is determined before any actions of the transition
+                    # execute, and therefore the next state calculation cannot
+                    # depend on any of the transitionactions.
+                    case('next_state = getNextState(addr);')
+                else:
+                    ns_ident = trans.nextState.ident
+                    case('next_state = ${ident}_State_${ns_ident};')
+
+            actions = trans.actions
+            request_types = trans.request_types
+
+            # Check for resources
+            case_sorter = []
+            res = trans.resources
+            for key,val in res.items():
+                val = '''
+if (!%s.areNSlotsAvailable(%s, clockEdge()))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val)
+                case_sorter.append(val)
+
+            # Check all of the request_types for resource constraints
+            for request_type in request_types:
+                val = '''
+if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    return TransitionResult_ResourceStall;
+}
+''' % (self.ident, request_type.ident)
+                case_sorter.append(val)
+
+            # Emit the code sequences in a sorted order.  This makes the
+            # output deterministic (without this the output order can vary
+            # since Map's keys() on a vector of pointers is not deterministic
+            for c in sorted(case_sorter):
+                case("$c")
+
+            # Record access types for this transition
+            for request_type in request_types:
+                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+
+            # Figure out if we stall
+            stall = False
+            for action in actions:
+                if action.ident == "z_stall":
+                    stall = True
+                    break
+
+            if stall:
+                case('return TransitionResult_ProtocolStall;')
+            else:
+                if self.TBEType != None and self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
+                elif self.TBEType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_tbe_ptr, addr);')
+                elif self.EntryType != None:
+                    for action in actions:
+                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
+                else:
+                    for action in actions:
+                        case('${{action.ident}}(addr);')
+                case('return TransitionResult_Valid;')
+
+            case = str(case)
+
+            # Look to see if this transition code is unique.
+            if case not in cases:
+                cases[case] = []
+
+            cases[case].append(trans)
+
+        return cases
+
+    def printCTransitionTable(self, code, cases):
+        '''Output the body of doTransitionWorker as a lookup into a dense
+        table of transition functions, followed by those functions and the
+        table itself'''
+
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+        params = self.transitionParams()
+
+        args = ['next_state']
+        if self.TBEType != None:
+            args.append('m_tbe_ptr')
+        if self.EntryType != None:
+            args.append('m_cache_entry_ptr')
+        args.append('addr')
+        args = ', '.join(args)
+
+        code('''
+    TransitionFunc func = m_transition_table[state][event];
+    if (func == nullptr) {
+        panic("Invalid transition\\n"
+              "%s time: %d addr: %#x event: %s state: %s\\n",
+              name(), curCycle(), addr, event, state);
+    }
+
+    return (this->*func)($args);
+}
+''')
+
+        # One function per unique code block. Transitions that share
+        # the same code also share the function.
+        func_names = {}
+        for case,transitions in cases.items():
+            func = self.transitionFuncName(transitions[0])
+            for trans in transitions:
+                func_names[(trans.state, trans.event)] = func
+
+            code()
+            code('''
+TransitionResult
+${c_ident}::${func}($params)
+{
+''')
+            code.indent()
+            code('$case')
+            code.dedent()
+            code('}')
+
+        code('''
+const ${c_ident}::TransitionFunc
+${c_ident}::m_transition_table[${ident}_State_NUM][${ident}_Event_NUM] = {
+''')
+        code.indent()
+        for state in self.states.values():
+            code('// ${ident}_State_${{state.ident}}')
+            code('{')
+            code.indent()
+            for event in self.events.values():
+                func = func_names.get((state, event))
+                if func is None:
+                    code('nullptr, // ${{event.ident}}')
+                else:
+                    code('&${c_ident}::${func}, // ${{event.ident}}')
+            code.dedent()
+            code('},')
+        code.dedent()
+        code('};')
+        code()
+
     def printCSwitch(self, path):
         '''Output switch statement for transition table'''
 
@@ -1407,105 +1600,26 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         Addr addr)
 {
-    switch(HASH_FUN(state, event)) {
 ''')
 
-        # This map will allow suppress generating duplicate code
-        cases = OrderedDict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                if trans.nextState.isWildcard():
-                    # When * is encountered as an end state of a transition,
-                    # the next state is determined by calling the
-                    # machine-specific getNextState function. The next state
-                    # is determined before any actions of the transition
-                    # execute, and therefore the next state calculation cannot
-                    # depend on any of the transitionactions.
-                    case('next_state = getNextState(addr);')
-                else:
-                    ns_ident = trans.nextState.ident
-                    case('next_state = ${ident}_State_${ns_ident};')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.items():
-                val = '''
-if (!%s.areNSlotsAvailable(%s, clockEdge()))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
-
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
-}
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
-
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
-
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
-
-            case = str(case)
-
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
-
-            cases[case].append(case_string)
+        cases = self.transitionCases()
 
-        # Walk through all of the unique code blocks and spit out the
-        # corresponding case statement elements
-        for case,transitions in cases.items():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
-            code('    $case\n')
+        if self.symtab.slicc.transition_table:
+            self.printCTransitionTable(code, cases)
+        else:
+            code('    switch(HASH_FUN(state, event)) {')
+
+            # Walk through all of the unique code blocks and spit out the
+            # corresponding case statement elements
+            for case,transitions in cases.items():
+                # Iterative over all the multiple transitions that share
+                # the same code
+                for trans in transitions:
+                    code('  case HASH_FUN(${ident}_State_${{trans.state.ident}}, '
+                         '${ident}_Event_${{trans.event.ident}}):')
+                code('    $case\n')
 
-        code('''
+            code('''
       default:
         panic("Invalid transition\\n"
               "%s time: %d addr: %#x event: %s state: %s\\n",
@@ -0,0 +1,111 @@
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Host perf counter regions.
+
+Charges the host cycles, instructions, cache misses and branch
+mispredictions of gem5 itself to regions of the simulator's code, and
+reports them under host_perf in the stats. Outside of any region,
+counts go to the current phase: config, instantiate and then one phase
+per stat reset once the simulation has started (by default all of them
+go to 'simulate').
+"""
+
+from __future__ import print_function
+
+from contextlib import contextmanager
+
+import _m5.core
+
+_enabled = False
+_phases = []
+_phase = 0
+_simulating = False
+
+# Regions charged by the Python side, besides the phases
+_regions = [ 'config', 'instantiate', 'restore', 'checkpoint',
+             'stats_dump', 'stats_reset' ]
+
+def enable(phases=None, events=False):
+    """Start counting.
+
+    phases is the list of phase names to move through on each stat reset
+    during the simulation, the last one is kept until the end. With
+    events, event processing is charged to the types of the SimObjects
+    that own the events.
+    """
+    global _enabled, _phases
+
+    _phases = phases or [ 'simulate' ]
+    _m5.core.hostPerfEnable(events)
+    # Regions can only be created before the stats are registered
+    for name in _regions + _phases:
+        _m5.core.hostPerfRegion(name)
+    _m5.core.hostPerfSetPhase('config')
+    _enabled = True
+
+def enabled():
+    return _enabled
+
+def set_phase(name):
+    if _enabled:
+        _m5.core.hostPerfSetPhase(name)
+
+@contextmanager
+def region(name):
+    """Charge the body of a with statement to a region"""
+    if not _enabled:
+        yield
+        return
+
+    _m5.core.hostPerfEnter(name)
+    try:
+        yield
+    finally:
+        _m5.core.hostPerfExit()
+
+def reg_stats(root):
+    """Register the stats of all regions, with an event region for each
+    SimObject type in the configuration"""
+    if _enabled:
+        types = sorted(set(obj.type for obj in root.descendants()))
+        _m5.core.hostPerfRegStats(types)
+
+def start_simulation():
+    global _simulating, _phase
+
+    if _enabled:
+        _simulating = True
+        _phase = 0
+        set_phase(_phases[_phase])
+
+def next_phase():
+    """Move on to the next simulation phase, called on stat resets"""
+    global _phase
+
+    if _simulating and _phase + 1 < len(_phases):
+        _phase += 1
+        set_phase(_phases[_phase])
@@ -146,10 +146,30 @@ def parse_options():
         help="End debug output at TICK")
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug [Default: %default]")
+    option("--debug-binary", action='store_true', default=False,
+        help="Write debug output to --debug-file in a binary format, " \
+             "see util/decode_debug_trace.py")
+    option("--debug-recorder", metavar="N", type='int', default=0,
+        help="Keep the last N debug messages of each thread in memory " \
+             "instead of writing them out, and save them to the output " \
+             "directory on panic, fatal, a crash or m5 dumptrace")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
+    option("--profile-events", metavar="FILE", default="",
+        help="Measure the host time taken by each event and write a " \
+             "report to FILE in the output directory")
+    option("--host-perf", action='store_true', default=False,
+        help="Count host perf events (cycles, instructions, cache and " \
+             "branch misses) in regions of gem5 and report them in the " \
+             "host_perf stats")
+    option("--host-perf-phases", metavar="PHASES", default="simulate",
+        help="Comma separated names of the simulation phases, moving " \
+             "to the next one on each stat reset [Default: %default]")
+    option("--host-perf-events", action='store_true', default=False,
+        help="Also charge event processing to the SimObject types " \
+             "that own the events (implies --host-perf)")
 
     # Help options
     group("Help Options")
@@ -419,12 +439,28 @@ def main(*args):
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    if options.debug_recorder:
+        trace.outputRecorder(options.debug_recorder)
+    elif options.debug_binary:
+        if options.debug_file in ('cout', 'cerr'):
+            print("--debug-binary needs a --debug-file", file=sys.stderr)
+            sys.exit(1)
+        trace.outputBinary(options.debug_file)
+    else:
+        trace.output(options.debug_file)
 
     for ignore in options.debug_ignore:
         _check_tracing()
         trace.ignore(ignore)
 
+    if options.profile_events:
+        event.enableProfiling(options.profile_events)
+
+    if options.host_perf or options.host_perf_events:
+        from m5 import host_perf
+        host_perf.enable(options.host_perf_phases.split(','),
+                         events=options.host_perf_events)
+
     sys.argv = arguments
     sys.path = [ os.path.dirname(sys.argv[0]) ] + sys.path
 
@@ -48,6 +48,7 @@ import _m5.drain
 import _m5.core
 from _m5.stats import updateEvents as updateStatEvents
 
+from . import host_perf
 from . import stats
 from . import SimObject
 from . import ticks
@@ -79,6 +80,8 @@ def instantiate(ckpt_dir=None):
     if not root:
         fatal("Need to instantiate Root() before calling instantiate()")
 
+    host_perf.set_phase('instantiate')
+
     # we need to fix the global frequency
     ticks.fixGlobalFrequency()
 
@@ -123,6 +126,7 @@ def instantiate(ckpt_dir=None):
 
     # Do a third pass to initialize statistics
     stats._bindStatHierarchy(root)
+    host_perf.reg_stats(root)
     root.regStats()
 
     # Do a fourth pass to initialize probe points
@@ -142,10 +146,11 @@ def instantiate(ckpt_dir=None):
 
     # Restore checkpoint (if any)
     if ckpt_dir:
-        _drain_manager.preCheckpointRestore()
-        ckpt = _m5.core.getCheckpoint(ckpt_dir)
-        _m5.core.unserializeGlobals(ckpt);
-        for obj in root.descendants(): obj.loadState(ckpt)
+        with host_perf.region('restore'):
+            _drain_manager.preCheckpointRestore()
+            ckpt = _m5.core.getCheckpoint(ckpt_dir)
+            _m5.core.unserializeGlobals(ckpt);
+            for obj in root.descendants(): obj.loadState(ckpt)
     else:
         for obj in root.descendants(): obj.initState()
 
@@ -172,6 +177,8 @@ def simulate(*args, **kwargs):
         # Reset to put the stats in a consistent state.
         stats.reset()
 
+        host_perf.start_simulation()
+
     if _drain_manager.isDrained():
         _drain_manager.resume()
 
@@ -233,10 +240,11 @@ def checkpoint(dir):
     if not isinstance(root, objects.Root):
         raise TypeError("Checkpoint must be called on a root object.")
 
-    drain()
-    memWriteback(root)
-    print("Writing checkpoint")
-    _m5.core.serializeAll(dir)
+    with host_perf.region('checkpoint'):
+        drain()
+        memWriteback(root)
+        print("Writing checkpoint")
+        _m5.core.serializeAll(dir)
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
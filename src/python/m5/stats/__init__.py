@@ -43,6 +43,7 @@ from __future__ import absolute_import
 import m5
 
 import _m5.stats
+from m5 import host_perf
 from m5.objects import Root
 from m5.params import isNullPointer
 from m5.util import attrdict, fatal
@@ -185,6 +186,33 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "col", ])
+def _columnarFactory(fn, changed=False, desc=True):
+    """Output stats in a binary, column oriented format.
+
+    Every stat is flattened into one or more double precision columns.
+    The stat names and descriptions are written once, at the first
+    dump, and every dump after that only appends the column values.
+    This makes periodic stat dumps much smaller and faster than the
+    text format. Files can be read with run_spec/colstats.py.
+
+    Known limitations:
+      * Vector distributions and sparse histograms are unsupported.
+      * The set of stats must not change between dumps.
+      * No support for forking.
+
+    Parameters:
+      * changed (bool): Only store the columns that changed since the
+                        previous dump (default: False)
+      * desc (bool): Output stat descriptions (default: True)
+
+    Example:
+      col://stats.col?changed=True;desc=False
+
+    """
+
+    return _m5.stats.initColumnar(fn, changed, desc)
+
 def addStatVisitor(url):
     """Add a stat visitor specified using a URL string
 
@@ -237,19 +265,6 @@ def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
 
-def _visit_groups(visitor, root=None):
-    if root is None:
-        root = Root.getInstance()
-    for group in root.getStatGroups().values():
-        visitor(group)
-        _visit_groups(visitor, root=group)
-
-def _visit_stats(visitor, root=None):
-    def for_each_stat(g):
-        for stat in g.getStats():
-            visitor(g, stat)
-    _visit_groups(for_each_stat, root=root)
-
 def _bindStatHierarchy(root):
     def _bind_obj(name, obj):
         if isNullPointer(obj):
@@ -287,31 +302,15 @@ def enable():
     enabled, all statistics must be created and initialized and once
     the package is enabled, no more statistics can be created.'''
 
-    def check_stat(group, stat):
-        if not stat.check() or not stat.baseCheck():
-            fatal("statistic '%s' (%d) was not properly initialized " \
-                  "by a regStats() function\n", stat.name, stat.id)
-
-        if not (stat.flags & flags.display):
-            stat.name = "__Stat%06d" % stat.id
-
+    # Check and enable all stats, and record them in dump order so they
+    # can be prepared, dumped and reset in bulk from C++.
+    _m5.stats.buildRegistry()
 
     # Legacy stat
     global stats_list
-    stats_list = list(_m5.stats.statsList())
-
-    for stat in stats_list:
-        check_stat(None, stat)
-
-    stats_list.sort(key=lambda s: s.name.split('.'))
+    stats_list = list(_m5.stats.legacyStats())
     for stat in stats_list:
         stats_dict[stat.name] = stat
-        stat.enable()
-
-
-    # New stats
-    _visit_stats(check_stat)
-    _visit_stats(lambda g, s: s.enable())
 
     _m5.stats.enable();
 
@@ -319,12 +318,7 @@ def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    # Legacy stats
-    for stat in stats_list:
-        stat.prepare()
-
-    # New stats
-    _visit_stats(lambda g, s: s.prepare())
+    _m5.stats.prepareAll()
 
 def _dump_to_visitor(visitor, roots=None):
     # New stats
@@ -345,12 +339,8 @@ def _dump_to_visitor(visitor, roots=None):
             for p in reversed(root.path_list()):
                 visitor.endGroup()
     else:
-        # Legacy stats
-        for stat in stats_list:
-            stat.visit(visitor)
-
-        # New stats starting from root.
-        dump_group(Root.getInstance())
+        # Legacy stats, then new stats starting from root
+        _m5.stats.visitAll(visitor)
 
 lastDump = 0
 # List[SimObject].
@@ -359,6 +349,10 @@ global_dump_roots = []
 def dump(roots=None):
     '''Dump all statistics data to the registered outputs'''
 
+    with host_perf.region('stats_dump'):
+        _dump(roots)
+
+def _dump(roots):
     all_roots = []
     if roots is not None:
         all_roots.extend(roots)
@@ -394,14 +388,16 @@ def dump(roots=None):
 def reset():
     '''Reset all statistics to the base state'''
 
-    # call reset stats on all SimObjects
-    root = Root.getInstance()
-    if root:
-        root.resetStats()
+    with host_perf.region('stats_reset'):
+        _reset()
 
-    # call any other registered legacy stats reset callbacks
-    for stat in stats_list:
-        stat.reset()
+    # Phases of the simulation are delimited by stat resets
+    host_perf.next_phase()
+
+def _reset():
+    # Reset the stats in bulk, and call resetStats() on the SimObjects
+    # and groups that declare a custom reset
+    _m5.stats.resetAll()
 
     _m5.stats.processResetQueue()
 
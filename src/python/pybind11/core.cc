@@ -55,6 +55,7 @@
 #include "base/types.hh"
 #include "sim/core.hh"
 #include "sim/drain.hh"
+#include "sim/host_perf.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_object.hh"
 
@@ -282,6 +283,24 @@ pybind_init_core(py::module &m_native)
 
         ;
 
+    /*
+     * Host perf regions
+     */
+    m_core
+        .def("hostPerfEnable", &HostPerf::enable)
+        .def("hostPerfRegion", [](const std::string &name) {
+            HostPerf::region(name);
+        })
+        .def("hostPerfEnter", [](const std::string &name) {
+            HostPerf::enter(HostPerf::region(name));
+        })
+        .def("hostPerfExit", &HostPerf::exit)
+        .def("hostPerfSetPhase", [](const std::string &name) {
+            HostPerf::setPhase(HostPerf::region(name));
+        })
+        .def("hostPerfRegStats", &HostPerf::regStats)
+        ;
+
 
     init_drain(m_native);
     init_serialize(m_native);
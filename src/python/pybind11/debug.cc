@@ -45,7 +45,9 @@
 #include <map>
 #include <vector>
 
+#include "base/binary_trace.hh"
 #include "base/debug.hh"
+#include "base/flight_recorder.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
 #include "sim/debug.hh"
@@ -67,6 +69,23 @@ output(const char *filename)
     Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream->stream()));
 }
 
+static void
+outputBinary(const char *filename)
+{
+    OutputStream *file_stream = simout.find(filename);
+
+    if (!file_stream)
+        file_stream = simout.create(filename, true);
+
+    Trace::setDebugLogger(new Trace::BinaryLogger(*file_stream->stream()));
+}
+
+static void
+outputRecorder(size_t slots)
+{
+    Trace::setDebugLogger(new Trace::FlightRecorder(slots));
+}
+
 static void
 ignore(const char *expr)
 {
@@ -119,6 +138,8 @@ pybind_init_debug(py::module &m_native)
     py::module m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("outputBinary", &outputBinary)
+        .def("outputRecorder", &outputRecorder)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
@@ -44,6 +44,7 @@
 #include "pybind11/stl.h"
 
 #include "base/logging.hh"
+#include "sim/event_profiler.hh"
 #include "sim/eventq.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
@@ -109,6 +110,7 @@ pybind_init_event(py::module &m_native)
     m.def("getEventQueue", []() { return curEventQueue(); },
           py::return_value_policy::reference);
     m.def("setEventQueue", [](EventQueue *q) { return curEventQueue(q); });
+    m.def("enableProfiling", &EventProfiler::enable);
     m.def("getEventQueue", &getEventQueue,
           py::return_value_policy::reference);
 
@@ -44,10 +44,13 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/columnar.hh"
+#include "base/stats/registry.hh"
 #include "base/stats/text.hh"
 #if USE_HDF5
 #include "base/stats/hdf5.hh"
 #endif
+#include "sim/root.hh"
 #include "sim/stat_control.hh"
 #include "sim/stat_register.hh"
 
@@ -102,6 +105,7 @@ pybind_init_stats(py::module &m_native)
 #if USE_HDF5
         .def("initHDF5", &Stats::initHDF5)
 #endif
+        .def("initColumnar", &Stats::initColumnar)
         .def("registerPythonStatsHandlers",
              &Stats::registerPythonStatsHandlers)
         .def("schedStatEvent", &Stats::schedStatEvent)
@@ -112,6 +116,17 @@ pybind_init_stats(py::module &m_native)
         .def("enable", &Stats::enable)
         .def("enabled", &Stats::enabled)
         .def("statsList", &Stats::statsList)
+        .def("buildRegistry", []() {
+            Stats::registry().build(Root::root());
+        })
+        .def("legacyStats", []() {
+            return Stats::registry().legacyStats();
+        })
+        .def("prepareAll", []() { Stats::registry().prepare(); })
+        .def("resetAll", []() { Stats::registry().reset(); })
+        .def("visitAll", [](Stats::Output &output) {
+            Stats::registry().visit(output);
+        })
         ;
 
     py::class_<Stats::Output>(m, "Output")
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_EVENT_OWNER_CACHE_HH__
+#define __SIM_EVENT_OWNER_CACHE_HH__
+
+#include <string>
+#include <unordered_map>
+
+#include "sim/eventq.hh"
+
+/**
+ * Per-owner data of tools that charge event processing to the objects
+ * that own the events, keyed by the event's name, which usually starts
+ * with the name of its owner, and its description.
+ *
+ * Events are not remembered by address. Most events are
+ * EventFunctionWrappers with the same description, so nothing cheaper
+ * than the name tells an event apart from one that took the address of
+ * a deleted one. A cache is not thread safe, so each event queue or
+ * thread needs its own.
+ */
+template <typename T>
+class EventOwnerCache
+{
+  private:
+    /** Values by name and description */
+    std::unordered_map<std::string, T> values;
+
+    /** Reused to build keys */
+    std::string key;
+
+  public:
+    /**
+     * Find the value of an event.
+     *
+     * @param event The event
+     * @param make Called with the name and description of the event to
+     *             create the value if there is none for them yet
+     */
+    template <typename Make>
+    T &
+    lookup(const Event *event, Make &&make)
+    {
+        const char *description = event->description();
+        const std::string name = event->name();
+        key = name;
+        key.push_back('\0');
+        key.append(description);
+
+        auto it = values.find(key);
+        if (it == values.end())
+            it = values.emplace(key, make(name, description)).first;
+        return it->second;
+    }
+
+    /** Values by name and description, separated by a null character */
+    const std::unordered_map<std::string, T> &all() const { return values; }
+};
+
+#endif // __SIM_EVENT_OWNER_CACHE_HH__
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profiler.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Clock::time_point startTime;
+
+std::mutex profilersMutex;
+std::vector<std::unique_ptr<EventProfiler>> profilers;
+
+} // anonymous namespace
+
+bool EventProfiler::_enabled = false;
+
+void
+EventProfiler::enable(const std::string &filename)
+{
+    if (_enabled)
+        return;
+
+    _enabled = true;
+    startTime = Clock::now();
+    registerExitCallback([filename]() { report(filename); });
+}
+
+EventProfiler *
+EventProfiler::create()
+{
+    std::lock_guard<std::mutex> lock(profilersMutex);
+    profilers.emplace_back(new EventProfiler);
+    return profilers.back().get();
+}
+
+void
+EventProfiler::process(Event *event)
+{
+    // Look the event up first, the event may be gone after processing
+    Entry &entry = entries.lookup(event,
+        [](const std::string &name, const char *description) {
+            Entry entry;
+            entry.name = name;
+            entry.description = description;
+            return entry;
+        });
+
+    const Clock::time_point start = Clock::now();
+    event->process();
+    const Clock::duration time = Clock::now() - start;
+
+    entry.count++;
+    entry.ns +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+void
+EventProfiler::report(const std::string &filename)
+{
+    const double host_seconds = std::chrono::duration<double>(
+        Clock::now() - startTime).count();
+
+    // Merge the entries of all the event queues
+    std::unordered_map<std::string, Entry> merged;
+    uint64_t total_count = 0;
+    uint64_t total_ns = 0;
+    for (auto &profiler : profilers) {
+        for (auto &kv : profiler->entries.all()) {
+            Entry &entry = merged[kv.first];
+            entry.name = kv.second.name;
+            entry.description = kv.second.description;
+            entry.count += kv.second.count;
+            entry.ns += kv.second.ns;
+            total_count += kv.second.count;
+            total_ns += kv.second.ns;
+        }
+    }
+
+    std::vector<const Entry *> sorted;
+    for (auto &kv : merged)
+        sorted.push_back(&kv.second);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Entry *a, const Entry *b) { return a->ns > b->ns; });
+
+    OutputStream *file = simout.create(filename);
+    std::ostream &os = *file->stream();
+
+    ccprintf(os, "# %d events took %.3f s of %.3f s host time\n",
+             total_count, total_ns / 1e9, host_seconds);
+    ccprintf(os, "# %-10s %6s %12s %10s %12s  %s\n", "time (ms)", "%",
+             "events", "ns/event", "events/s", "event (description)");
+    for (const Entry *entry : sorted) {
+        ccprintf(os, "%12.3f %6.2f %12d %10.1f %12d  %s (%s)\n",
+                 entry->ns / 1e6,
+                 total_ns ? 100.0 * entry->ns / total_ns : 0.0,
+                 entry->count,
+                 entry->count ? (double)entry->ns / entry->count : 0.0,
+                 (uint64_t)(host_seconds > 0 ?
+                            entry->count / host_seconds : 0),
+                 entry->name, entry->description);
+    }
+
+    simout.close(file);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_EVENT_PROFILER_HH__
+#define __SIM_EVENT_PROFILER_HH__
+
+#include <cstdint>
+#include <string>
+
+#include "sim/event_owner_cache.hh"
+
+/**
+ * Measures the host time taken by each event an event queue processes,
+ * to find out which objects the simulator spends its time in.  Time is
+ * charged to the event's name, which usually starts with the name of the
+ * SimObject that owns it, and its description.  The report is written to
+ * the output directory when gem5 exits.
+ */
+class EventProfiler
+{
+  public:
+    /**
+     * Profile the events of all event queues from now on.
+     *
+     * @param filename Name of the report in the output directory
+     */
+    static void enable(const std::string &filename);
+
+    static bool enabled() { return _enabled; }
+
+    /** Create the profiler of an event queue */
+    static EventProfiler *create();
+
+    /** Process an event and charge the time it takes to it */
+    void process(Event *event);
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        std::string description;
+        uint64_t count = 0;
+        uint64_t ns = 0;
+    };
+
+    EventOwnerCache<Entry> entries;
+
+    static bool _enabled;
+
+    EventProfiler() {}
+
+    static void report(const std::string &filename);
+};
+
+#endif // __SIM_EVENT_PROFILER_HH__
@@ -41,6 +41,8 @@
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
 #include "sim/core.hh"
+#include "sim/event_profiler.hh"
+#include "sim/host_perf.hh"
 
 using namespace std;
 
@@ -219,7 +221,16 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (DTRACE(Event))
             event->trace("executed");
-        event->process();
+        // The host perf counts include the profiler's overhead rather
+        // than the other way around, since the profiler times each event
+        HostPerf::Scope perf_scope(HostPerf::eventRegion(event));
+        if (EventProfiler::enabled()) {
+            if (!profiler)
+                profiler = EventProfiler::create();
+            profiler->process(event);
+        } else {
+            event->process();
+        }
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -419,7 +430,7 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), profiler(NULL)
 {
 }
 
@@ -51,6 +51,7 @@
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
+class EventProfiler;
 class BaseGlobalEvent;
 
 //! Simulation Quantum for multiple eventq simulation.
@@ -649,6 +650,9 @@ class EventQueue
      */
     std::mutex service_mutex;
 
+    //! Host time profiler, created when event profiling is enabled.
+    EventProfiler *profiler;
+
     //! Insert / remove event from the queue. Should only be called
     //! by thread operating this queue.
     void insert(Event *event);
@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/host_perf.hh"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cxxabi.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "sim/event_owner_cache.hh"
+#include "sim/root.hh"
+#include "sim/sim_object.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Hardware perf events of one thread, read together as a group */
+class CounterGroup
+{
+  public:
+    CounterGroup();
+    ~CounterGroup();
+
+    /** Read the counters, leaving the unavailable ones at zero */
+    void read(uint64_t *values) const;
+
+  private:
+    int leader;
+    std::vector<int> fds;
+    /** Position of each counter in the group, or -1 if unavailable */
+    int slot[HostPerf::NumCounters];
+};
+
+#if defined(__linux__)
+
+const uint64_t hwEvents[HostPerf::NumCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+CounterGroup::CounterGroup()
+    : leader(-1)
+{
+    int error = 0;
+    for (int i = 0; i < HostPerf::NumCounters; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = hwEvents[i];
+        attr.read_format = PERF_FORMAT_GROUP;
+        // Only count gem5 itself, which also works with a
+        // perf_event_paranoid of 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // Count the calling thread on any CPU
+        int fd = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd == -1) {
+            error = errno;
+            slot[i] = -1;
+            continue;
+        }
+        if (leader == -1)
+            leader = fd;
+        slot[i] = fds.size();
+        fds.push_back(fd);
+    }
+
+    if (error) {
+        warn_once("HostPerf: Only %d of %d host perf counters are available "
+                  "(%s). Check /proc/sys/kernel/perf_event_paranoid.\n",
+                  fds.size(), HostPerf::NumCounters, strerror(error));
+    }
+}
+
+CounterGroup::~CounterGroup()
+{
+    for (int fd : fds)
+        close(fd);
+}
+
+void
+CounterGroup::read(uint64_t *values) const
+{
+    uint64_t data[1 + HostPerf::NumCounters] = {};
+    if (leader != -1 && ::read(leader, data, sizeof(data)) < 0)
+        memset(data, 0, sizeof(data));
+
+    for (int i = 0; i < HostPerf::NumCounters; i++)
+        values[i] = slot[i] == -1 ? 0 : data[1 + slot[i]];
+}
+
+#else
+
+CounterGroup::CounterGroup()
+    : leader(-1)
+{
+    for (int i = 0; i < HostPerf::NumCounters; i++)
+        slot[i] = -1;
+    warn_once("HostPerf: Host perf counters are only supported on Linux.\n");
+}
+
+CounterGroup::~CounterGroup()
+{
+}
+
+void
+CounterGroup::read(uint64_t *values) const
+{
+    for (int i = 0; i < HostPerf::NumCounters; i++)
+        values[i] = 0;
+}
+
+#endif
+
+/** Stats of a region */
+struct RegionStats : public Stats::Group
+{
+    RegionStats(Stats::Group *parent, const std::string &name,
+                HostPerf::Region &region);
+
+    Stats::Value entries;
+    Stats::Value hostSeconds;
+    Stats::Value cycles;
+    Stats::Value instructions;
+    Stats::Value llcMisses;
+    Stats::Value branchMisses;
+    Stats::Formula ipc;
+    Stats::Formula llcMpki;
+    Stats::Formula branchMpki;
+};
+
+} // anonymous namespace
+
+class HostPerf::Region
+{
+  public:
+    Region(const std::string &_name)
+        : name(_name), ns(0), entries(0)
+    {
+        for (auto &count : counts)
+            count = 0;
+    }
+
+    void
+    charge(const uint64_t *delta, uint64_t delta_ns)
+    {
+        for (int i = 0; i < NumCounters; i++)
+            counts[i].fetch_add(delta[i], std::memory_order_relaxed);
+        ns.fetch_add(delta_ns, std::memory_order_relaxed);
+    }
+
+    const std::string name;
+    std::atomic<uint64_t> counts[NumCounters];
+    std::atomic<uint64_t> ns;
+    std::atomic<uint64_t> entries;
+    std::unique_ptr<RegionStats> stats;
+};
+
+namespace {
+
+RegionStats::RegionStats(Stats::Group *parent, const std::string &name,
+                         HostPerf::Region &region)
+    : Stats::Group(parent, name.c_str()),
+      ADD_STAT(entries, "Number of times the region was entered"),
+      ADD_STAT(hostSeconds, "Host time spent in the region (s)"),
+      ADD_STAT(cycles, "Host cycles spent in the region"),
+      ADD_STAT(instructions, "Host instructions executed in the region"),
+      ADD_STAT(llcMisses, "Host last level cache misses in the region"),
+      ADD_STAT(branchMisses, "Host branch mispredictions in the region"),
+      ADD_STAT(ipc, "Host instructions per cycle in the region"),
+      ADD_STAT(llcMpki,
+               "Host last level cache misses per 1000 instructions"),
+      ADD_STAT(branchMpki,
+               "Host branch mispredictions per 1000 instructions")
+{
+    HostPerf::Region *r = &region;
+    entries.functor([r]() { return r->entries.load(); });
+    hostSeconds
+        .functor([r]() { return r->ns.load() / 1e9; })
+        .precision(3)
+        ;
+    cycles.functor([r]() { return r->counts[HostPerf::Cycles].load(); });
+    instructions.functor([r]() {
+        return r->counts[HostPerf::Instructions].load(); });
+    llcMisses.functor([r]() {
+        return r->counts[HostPerf::LLCMisses].load(); });
+    branchMisses.functor([r]() {
+        return r->counts[HostPerf::BranchMisses].load(); });
+
+    ipc.precision(3);
+    llcMpki.precision(3);
+    branchMpki.precision(3);
+    ipc = instructions / cycles;
+    llcMpki = llcMisses * 1000 / instructions;
+    branchMpki = branchMisses * 1000 / instructions;
+}
+
+/** Region state of a thread */
+struct ThreadState
+{
+    CounterGroup counters;
+    uint64_t last[HostPerf::NumCounters];
+    Clock::time_point lastTime;
+
+    /** Region counts are charged to */
+    HostPerf::Region *current = nullptr;
+    /** Regions to go back to, the bottom one is the phase */
+    std::vector<HostPerf::Region *> stack;
+
+    /** Event regions by event name and description */
+    EventOwnerCache<HostPerf::Region *> eventRegions;
+};
+
+std::mutex regionsMutex;
+std::map<std::string, std::unique_ptr<HostPerf::Region>> regions;
+bool statsRegistered = false;
+std::vector<std::unique_ptr<Stats::Group>> groups;
+
+std::atomic<HostPerf::Region *> phase(nullptr);
+HostPerf::Region *otherEvents = nullptr;
+
+const std::string EventPrefix = "events.";
+
+ThreadState &
+threadState()
+{
+    thread_local std::unique_ptr<ThreadState> state;
+    if (!state) {
+        state.reset(new ThreadState);
+        state->counters.read(state->last);
+        state->lastTime = Clock::now();
+        state->current = phase.load();
+    }
+    return *state;
+}
+
+/** Charge the counts since the last call to the current region */
+void
+charge(ThreadState &state)
+{
+    uint64_t now[HostPerf::NumCounters];
+    state.counters.read(now);
+    const Clock::time_point now_time = Clock::now();
+
+    if (state.current) {
+        uint64_t delta[HostPerf::NumCounters];
+        for (int i = 0; i < HostPerf::NumCounters; i++)
+            delta[i] = now[i] - state.last[i];
+        state.current->charge(delta,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now_time - state.lastTime).count());
+    }
+
+    memcpy(state.last, now, sizeof(now));
+    state.lastTime = now_time;
+    // Threads pick up phase changes when they are outside any region
+    if (state.stack.empty())
+        state.current = phase.load();
+}
+
+/** The type of a SimObject as in its Python class */
+std::string
+objectType(const SimObject *obj)
+{
+    const char *mangled = typeid(*obj->params()).name();
+    int status;
+    char *demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+    std::string type = status == 0 ? demangled : mangled;
+    free(demangled);
+
+    const std::string suffix = "Params";
+    if (type.size() > suffix.size() &&
+        type.compare(type.size() - suffix.size(), suffix.size(),
+                     suffix) == 0) {
+        type.resize(type.size() - suffix.size());
+    }
+    return type;
+}
+
+/** Find the region of the object an event name belongs to */
+HostPerf::Region *
+ownerRegion(std::string name)
+{
+    // Event names usually start with the name of their owner
+    while (true) {
+        if (SimObject *obj = SimObject::find(name.c_str())) {
+            std::lock_guard<std::mutex> lock(regionsMutex);
+            auto it = regions.find(EventPrefix + objectType(obj));
+            return it != regions.end() ? it->second.get() : otherEvents;
+        }
+        auto pos = name.rfind('.');
+        if (pos == std::string::npos)
+            return otherEvents;
+        name.resize(pos);
+    }
+}
+
+} // anonymous namespace
+
+bool HostPerf::_enabled = false;
+bool HostPerf::_eventsEnabled = false;
+
+void
+HostPerf::enable(bool events)
+{
+    _enabled = true;
+    _eventsEnabled = _eventsEnabled || events;
+}
+
+HostPerf::Region *
+HostPerf::region(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(regionsMutex);
+    auto it = regions.find(name);
+    if (it != regions.end())
+        return it->second.get();
+
+    fatal_if(statsRegistered,
+             "Host perf region %s created after the stats were registered.",
+             name);
+    return regions.emplace(name, new Region(name)).first->second.get();
+}
+
+void
+HostPerf::enter(Region *region)
+{
+    ThreadState &state = threadState();
+    charge(state);
+    state.stack.push_back(state.current);
+    state.current = region;
+    region->entries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+HostPerf::exit()
+{
+    ThreadState &state = threadState();
+    panic_if(state.stack.empty(), "Leaving a host perf region twice.");
+    charge(state);
+    state.current = state.stack.back();
+    state.stack.pop_back();
+}
+
+void
+HostPerf::setPhase(Region *region)
+{
+    phase = region;
+    ThreadState &state = threadState();
+    charge(state);
+    if (!state.stack.empty())
+        state.stack.front() = region;
+}
+
+void
+HostPerf::regStats(const std::vector<std::string> &types)
+{
+    if (!_enabled)
+        return;
+
+    if (_eventsEnabled) {
+        for (const auto &type : types)
+            region(EventPrefix + type);
+        otherEvents = region(EventPrefix + "other");
+    }
+
+    std::lock_guard<std::mutex> lock(regionsMutex);
+    statsRegistered = true;
+
+    groups.emplace_back(new Stats::Group(Root::root(), "host_perf"));
+    std::map<std::string, Stats::Group *> parents;
+    parents[""] = groups.back().get();
+    for (auto &entry : regions) {
+        // Regions with dots in their names go in nested groups
+        const std::string &name = entry.first;
+        std::string parent_name;
+        Stats::Group *parent = parents[""];
+        size_t start = 0;
+        for (auto pos = name.find('.'); pos != std::string::npos;
+             pos = name.find('.', start)) {
+            parent_name = name.substr(0, pos);
+            auto it = parents.find(parent_name);
+            if (it == parents.end()) {
+                groups.emplace_back(new Stats::Group(parent,
+                    name.substr(start, pos - start).c_str()));
+                it = parents.emplace(parent_name, groups.back().get()).first;
+            }
+            parent = it->second;
+            start = pos + 1;
+        }
+
+        Region &region = *entry.second;
+        region.stats.reset(new RegionStats(parent, name.substr(start),
+                                           region));
+    }
+}
+
+HostPerf::Region *
+HostPerf::findEventRegion(const Event *event)
+{
+    return threadState().eventRegions.lookup(event,
+        [](const std::string &name, const char *description) {
+            return ownerRegion(name);
+        });
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_HOST_PERF_HH__
+#define __SIM_HOST_PERF_HH__
+
+#include <string>
+#include <vector>
+
+class Event;
+
+/**
+ * Counts host performance events (cycles, instructions, last level cache
+ * misses and branch mispredictions) in regions of the simulator's own
+ * code, using Linux perf events on the thread that runs the region.
+ * Each region gets a group of stats under host_perf, with its IPC and
+ * misses per thousand instructions.
+ *
+ * Regions nest, and counts are charged to the innermost region, so a
+ * stat dump inside the simulation loop doesn't count towards the
+ * simulation. Outside of any region, counts go to the current phase,
+ * which the Python side moves through config, instantiate and the
+ * simulation phases. Optionally, event processing is charged to a
+ * region for the type of the SimObject that owns the event.
+ *
+ * Counters are opened per thread when the thread first enters a region.
+ * If perf events aren't available (see perf_event_paranoid), regions
+ * still count their entries and host time. Stats are not reset with the
+ * other stats, so the phases before the simulation keep their counts.
+ */
+class HostPerf
+{
+  public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        LLCMisses,
+        BranchMisses,
+        NumCounters
+    };
+
+    class Region;
+
+    /**
+     * Start counting.
+     *
+     * @param events Charge event processing to the types of the
+     *               SimObjects that own the events
+     */
+    static void enable(bool events);
+
+    static bool enabled() { return _enabled; }
+    static bool eventsEnabled() { return _eventsEnabled; }
+
+    /**
+     * Get a region by name, creating it if needed. Regions have to be
+     * created before the stats are registered.
+     */
+    static Region *region(const std::string &name);
+
+    /** Charge what follows to a region until the matching exit() */
+    static void enter(Region *region);
+    static void exit();
+
+    /** Set the region charged outside of any other region */
+    static void setPhase(Region *region);
+
+    /**
+     * Register the stats of all regions.
+     *
+     * @param types SimObject types to create event regions for
+     */
+    static void regStats(const std::vector<std::string> &types);
+
+    /**
+     * The region to charge processing an event to, which is the one of
+     * the type of the SimObject that owns it, or nullptr if event
+     * processing isn't charged to regions.
+     */
+    static Region *
+    eventRegion(const Event *event)
+    {
+        return _eventsEnabled ? findEventRegion(event) : nullptr;
+    }
+
+    /** Charges the enclosing block to a region */
+    class Scope
+    {
+      public:
+        Scope(Region *region)
+            : active(_enabled && region)
+        {
+            if (active)
+                enter(region);
+        }
+
+        ~Scope()
+        {
+            if (active)
+                exit();
+        }
+
+      private:
+        const bool active;
+    };
+
+  private:
+    static bool _enabled;
+    static bool _eventsEnabled;
+
+    static Region *findEventRegion(const Event *event);
+};
+
+#endif // __SIM_HOST_PERF_HH__
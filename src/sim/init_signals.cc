@@ -55,6 +55,7 @@
 
 #include "base/atomicio.hh"
 #include "base/cprintf.hh"
+#include "base/flight_recorder.hh"
 #include "base/logging.hh"
 #include "sim/async.hh"
 #include "sim/backtrace.hh"
@@ -152,6 +153,7 @@ abortHandler(int sigtype)
     }
 
     print_backtrace();
+    Trace::dumpFlightRecorderFromSignal();
     raiseFatalSignal(sigtype);
 }
 
@@ -162,6 +164,7 @@ segvHandler(int sigtype)
     STATIC_ERR("gem5 has encountered a segmentation fault!\n\n");
 
     print_backtrace();
+    Trace::dumpFlightRecorderFromSignal();
     raiseFatalSignal(SIGSEGV);
 }
 
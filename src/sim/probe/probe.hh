@@ -279,6 +279,14 @@ class ProbePointArg : public ProbePoint
                         listeners.end());
     }
 
+    /**
+     * @brief check if there are any listeners attached to this probe.
+     *
+     * This can be used to avoid building the notification argument
+     * when nobody is listening.
+     */
+    bool hasListeners() const { return !listeners.empty(); }
+
     /**
      * @brief called at the ProbePoint call site, passes arg to each listener.
      * @param arg the argument to pass to each listener.
@@ -52,6 +52,7 @@
 #include <vector>
 
 #include "base/debug.hh"
+#include "base/flight_recorder.hh"
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
@@ -356,6 +357,15 @@ dumpresetstats(ThreadContext *tc, Tick delay, Tick period)
     Stats::schedStatEvent(true, true, when, repeat);
 }
 
+void
+dumptrace(ThreadContext *tc)
+{
+    DPRINTF(PseudoInst, "PseudoInst::dumptrace()\n");
+    if (!Trace::dumpFlightRecorder())
+        warn_once("m5 dumptrace ignored, there is no debug flight "
+                  "recorder (see --debug-recorder).\n");
+}
+
 void
 m5checkpoint(ThreadContext *tc, Tick delay, Tick period)
 {
@@ -106,6 +106,7 @@ void resetstats(ThreadContext *tc, Tick delay, Tick period);
 void dumpstats(ThreadContext *tc, Tick delay, Tick period);
 void dumpresetstats(ThreadContext *tc, Tick delay, Tick period);
 void m5checkpoint(ThreadContext *tc, Tick delay, Tick period);
+void dumptrace(ThreadContext *tc);
 void debugbreak(ThreadContext *tc);
 void switchcpu(ThreadContext *tc);
 void workbegin(ThreadContext *tc, uint64_t workid, uint64_t threadid);
@@ -200,6 +201,10 @@ pseudoInstWork(ThreadContext *tc, uint8_t func, uint64_t &result)
         invokeSimcall<ABI>(tc, m5checkpoint);
         return true;
 
+      case M5OP_DUMP_TRACE:
+        invokeSimcall<ABI>(tc, dumptrace);
+        return true;
+
       case M5OP_WRITE_FILE:
         result = invokeSimcall<ABI, store_ret>(tc, writefile);
         return true;
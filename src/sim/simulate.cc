@@ -30,11 +30,13 @@
 
 #include "sim/simulate.hh"
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
 
 #include "base/logging.hh"
 #include "base/pollevent.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "sim/async.hh"
 #include "sim/eventq.hh"
@@ -178,6 +180,14 @@ doSimLoop(EventQueue *eventq)
 {
     // set the per thread current eventq pointer
     curEventQueue(eventq);
+    // and the shard this thread updates in sharded stats, which is the
+    // index of its queue
+    const unsigned shard = std::find(mainEventQueue.begin(),
+            mainEventQueue.end(), eventq) - mainEventQueue.begin();
+    fatal_if(shard >= Stats::MaxShards,
+             "Sharded stats support at most %d event queues.",
+             Stats::MaxShards);
+    Stats::threadShard = shard;
     eventq->handleAsyncInsertions();
 
     while (1) {
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stat_sampler.hh"
+
+#include <set>
+
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "base/stats/group.hh"
+#include "base/trace.hh"
+#include "debug/Stats.hh"
+#include "sim/core.hh"
+#include "sim/root.hh"
+
+StatSampler::StatSampler(const Params *p)
+    : SimObject(p), period(p->period), lastSample(MaxTick),
+      output(p->file_name.empty() ? name() + ".col" : p->file_name,
+             p->only_changed, true, false),
+      sampleEvent([this]{ sample(); }, name(), false,
+                  Event::Stat_Event_Pri)
+{
+    fatal_if(p->stats.empty(), "%s: No stats to sample.", name());
+    fatal_if(period == 0, "%s: The sampling period can't be 0.", name());
+
+    patterns.setExpression(p->stats);
+
+    registerExitCallback([this]() { finish(); });
+}
+
+void
+StatSampler::startup()
+{
+    select();
+    inform("%s: Sampling %d stats every %d ticks\n", name(),
+           sampled.size() - 1, period);
+
+    schedule(sampleEvent, curTick());
+}
+
+void
+StatSampler::select()
+{
+    // Timestamp the samples
+    for (auto *info : Stats::statsList()) {
+        if (info->name == "final_tick")
+            add(info, "", info->name);
+    }
+
+    for (auto *info : Stats::statsList()) {
+        if (info->name != "final_tick" && patterns.match(info->name))
+            add(info, "", info->name);
+    }
+
+    selectGroup(Root::root(), "", false);
+
+    fatal_if(sampled.size() == 1, "%s: No stats match the patterns.",
+             name());
+}
+
+void
+StatSampler::selectGroup(Stats::Group *group, const std::string &path,
+                         bool in_selected)
+{
+    bool selected = false;
+    for (auto *info : group->getStats()) {
+        const std::string stat_name = path.empty() ?
+            info->name : path + "." + info->name;
+        if (patterns.match(stat_name)) {
+            add(info, path, stat_name);
+            selected = true;
+        }
+    }
+
+    // preDumpStats() recurses into the subgroups, so only the outermost
+    // groups are kept
+    if (selected && !in_selected)
+        groups.push_back(group);
+
+    for (const auto &child : group->getStatGroups()) {
+        selectGroup(child.second, path.empty() ?
+                    child.first : path + "." + child.first,
+                    in_selected || selected);
+    }
+}
+
+void
+StatSampler::add(Stats::Info *info, const std::string &path,
+                 const std::string &name)
+{
+    // Columnar files only have the stats that are displayed
+    if (!info->flags.isSet(Stats::display))
+        return;
+
+    DPRINTF(Stats, "%s: Sampling %s\n", this->name(), name);
+    sampled.push_back({ path, info });
+}
+
+void
+StatSampler::record()
+{
+    // Bring the stats that are updated lazily up to date, as for a dump
+    for (auto *group : groups)
+        group->preDumpStats();
+
+    output.begin();
+    for (const auto &s : sampled) {
+        if (!s.path.empty())
+            output.beginGroup(s.path.c_str());
+        s.info->prepare();
+        s.info->visit(output);
+        if (!s.path.empty())
+            output.endGroup();
+    }
+    output.end();
+
+    lastSample = curTick();
+}
+
+void
+StatSampler::sample()
+{
+    record();
+    schedule(sampleEvent, curTick() + period);
+}
+
+void
+StatSampler::finish()
+{
+    // Nothing was sampled if the simulation never started
+    if (lastSample == MaxTick)
+        return;
+
+    if (curTick() != lastSample)
+        record();
+    output.flush();
+}
+
+StatSampler *
+StatSamplerParams::create()
+{
+    return new StatSampler(this);
+}
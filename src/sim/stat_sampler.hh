@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020 The Regents of the University of California
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_STAT_SAMPLER_HH__
+#define __SIM_STAT_SAMPLER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/match.hh"
+#include "base/stats/columnar.hh"
+#include "params/StatSampler.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace Stats {
+class Group;
+class Info;
+}
+
+/**
+ * Periodically records a selected set of stats into a columnar stat file
+ * (see base/stats/columnar.hh), giving a time series of the stats
+ * without dumping all of them. Stats are selected by their dotted names
+ * when the simulation starts, so the cost of a sample only depends on
+ * the number of selected stats. final_tick is always recorded first to
+ * timestamp the samples.
+ *
+ * Samples don't reset any stats, so the series are cumulative, and
+ * rates have to be computed from the differences between samples.
+ */
+class StatSampler : public SimObject
+{
+  public:
+    typedef StatSamplerParams Params;
+
+    StatSampler(const Params *p);
+
+    void startup() override;
+
+  protected:
+    /** A selected stat and the path of the group it belongs to */
+    struct Sampled
+    {
+        std::string path;
+        Stats::Info *info;
+    };
+
+    /** Find the stats matching the patterns */
+    void select();
+    /** @param in_selected Whether an enclosing group has selected stats */
+    void selectGroup(Stats::Group *group, const std::string &path,
+                     bool in_selected);
+    void add(Stats::Info *info, const std::string &path,
+             const std::string &name);
+
+    /** Record the selected stats */
+    void record();
+
+    /** Record a sample and schedule the next one */
+    void sample();
+
+    /** Record a last sample when the simulator exits */
+    void finish();
+
+    const Tick period;
+    ObjectMatch patterns;
+
+    /** Tick of the last sample */
+    Tick lastSample;
+
+    std::vector<Sampled> sampled;
+
+    /** The outermost groups of the sampled stats, updated with their
+     *  subgroups before each sample */
+    std::vector<Stats::Group *> groups;
+
+    Stats::Columnar output;
+
+    EventFunctionWrapper sampleEvent;
+};
+
+#endif // __SIM_STAT_SAMPLER_HH__
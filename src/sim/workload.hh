@@ -44,8 +44,10 @@ class Workload : public SimObject
 
     struct WorkloadStats : public Stats::Group
     {
-        Stats::Scalar arm;
-        Stats::Scalar quiesce;
+        // Counted by every CPU of the system, which may be simulated by
+        // different threads.
+        Stats::ShardedScalar arm;
+        Stats::ShardedScalar quiesce;
 
         WorkloadStats(Workload *workload) : Stats::Group(workload),
             arm(this, "inst.arm", "number of arm instructions executed"),
@@ -0,0 +1,545 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Render a binary debug trace written with --debug-binary in the same text
+# format as --debug-file, optionally keeping only some flags, objects or a
+# window of time.  The file format is described in src/base/binary_trace.hh.
+#
+#   decode_debug_trace.py m5out/trace.bin
+#   decode_debug_trace.py --flags Cache,Exec --objects 'system.cpu*' \
+#       --start 1000000 --end 2000000 m5out/trace.bin out.txt
+#
+# Messages from different simulation threads are written a chunk at a
+# time, so with several event queues they come out grouped by thread
+# rather than interleaved by tick.
+
+from __future__ import print_function
+
+import argparse
+import fnmatch
+import io
+import struct
+import sys
+
+MAGIC = b'gem5dbg\0'
+VERSION = 1
+STRING_CHUNK = 0
+RECORD_CHUNK = 1
+MAX_TICK = 2 ** 64 - 1
+
+# Argument kinds, see src/base/trace_args.hh
+SIGNED_INT, UNSIGNED_INT, SIGNED_CHAR, UNSIGNED_CHAR, BOOL, FLOAT, STRING = \
+    range(7)
+
+# cp::Format
+NONE, STR, INTEGER, CHARACTER, FLOATING = range(5)
+DEC, HEX, OCT = range(3)
+BEST, FIXED, SCIENTIFIC = range(3)
+
+class Format(object):
+    __slots__ = ('alternate_form', 'flush_left', 'print_sign', 'fill_zero',
+                 'uppercase', 'base', 'format', 'float_format', 'precision',
+                 'width', 'get_precision', 'get_width')
+
+    def __init__(self):
+        self.alternate_form = False
+        self.flush_left = False
+        self.print_sign = False
+        self.fill_zero = False
+        self.uppercase = False
+        self.base = DEC
+        self.format = NONE
+        self.float_format = BEST
+        self.precision = -1
+        self.width = 0
+        self.get_precision = False
+        self.get_width = False
+
+    def copy(self):
+        other = Format()
+        for slot in Format.__slots__:
+            setattr(other, slot, getattr(self, slot))
+        return other
+
+def _literal(fmt, pos):
+    """Text up to the next conversion as cp::Print::process() writes it.
+    Returns the text and the position of the '%' (or the end)."""
+    out = []
+    end = len(fmt)
+    while pos < end:
+        c = fmt[pos]
+        if c == '%':
+            if pos + 1 < end and fmt[pos + 1] == '%':
+                out.append('%')
+                pos += 2
+                continue
+            break
+        if c == '\r':
+            pos += 1
+            if pos >= end or fmt[pos] != '\n':
+                out.append('\n')
+            continue
+        out.append(c)
+        pos += 1
+    return ''.join(out), pos
+
+def _conversion(fmt, pos):
+    """Parse the conversion at fmt[pos] == '%' like
+    cp::Print::process_flag().  Returns the Format and the position
+    after it."""
+    f = Format()
+    done = False
+    end_number = False
+    have_precision = False
+    number = 0
+    end = len(fmt)
+    while not done:
+        pos += 1
+        c = fmt[pos] if pos < end else '\0'
+        if '0' <= c <= '9':
+            if end_number:
+                continue
+        elif number > 0:
+            end_number = True
+
+        if c == 's':
+            f.format = STR
+            done = True
+        elif c == 'c':
+            f.format = CHARACTER
+            done = True
+        elif c == 'l':
+            continue
+        elif c == 'p':
+            f.format = INTEGER
+            f.base = HEX
+            f.alternate_form = True
+            done = True
+        elif c in 'xX':
+            f.uppercase = f.uppercase or c == 'X'
+            f.base = HEX
+            f.format = INTEGER
+            done = True
+        elif c == 'o':
+            f.base = OCT
+            f.format = INTEGER
+            done = True
+        elif c in 'diu':
+            f.format = INTEGER
+            done = True
+        elif c in 'gG':
+            f.uppercase = f.uppercase or c == 'G'
+            f.format = FLOATING
+            f.float_format = BEST
+            done = True
+        elif c in 'eE':
+            f.uppercase = f.uppercase or c == 'E'
+            f.format = FLOATING
+            f.float_format = SCIENTIFIC
+            done = True
+        elif c == 'f':
+            f.format = FLOATING
+            f.float_format = FIXED
+            done = True
+        elif c == '#':
+            f.alternate_form = True
+        elif c == '-':
+            f.flush_left = True
+        elif c == '+':
+            f.print_sign = True
+        elif c == ' ':
+            pass
+        elif c == '.':
+            f.width = number
+            f.precision = 0
+            have_precision = True
+            number = 0
+            end_number = False
+        elif c == '0' and number == 0:
+            f.fill_zero = True
+        elif '0' <= c <= '9':
+            number = number * 10 + ord(c) - ord('0')
+        elif c == '*':
+            if have_precision:
+                f.get_precision = True
+            else:
+                f.get_width = True
+        else:
+            done = True
+
+        if end_number:
+            if have_precision:
+                f.precision = number
+            else:
+                f.width = number
+            end_number = False
+            number = 0
+
+        if done:
+            if f.format == INTEGER and have_precision:
+                f.width = f.precision
+                f.fill_zero = True
+            elif f.format == FLOATING and not have_precision and \
+                    f.fill_zero:
+                f.precision = f.width
+    return f, pos + 1
+
+class CompiledFormat(object):
+    """A format string split into literal text and conversions"""
+    def __init__(self, fmt):
+        self.text = fmt
+        # (literal, Format or None, position of the conversion)
+        self.parts = []
+        pos = 0
+        while True:
+            literal, start = _literal(fmt, pos)
+            if start >= len(fmt):
+                self.parts.append((literal, None, start))
+                break
+            conversion, pos = _conversion(fmt, start)
+            self.parts.append((literal, conversion, start))
+
+    def extra(self, index):
+        """What cp::Print::end_args() prints from part index on"""
+        literal, conversion, pos = self.parts[index]
+        fmt = self.text
+        out = [literal]
+        while pos < len(fmt):
+            if fmt[pos] == '%':
+                if fmt[pos + 1:pos + 2] != '%':
+                    out.append('<extra arg>')
+                out.append('%')
+                pos += 2
+            else:
+                literal, pos = _literal(fmt, pos)
+                out.append(literal)
+        return ''.join(out)
+
+def _pad(text, width, fill, left):
+    if len(text) >= width:
+        return text
+    padding = fill * (width - len(text))
+    return text + padding if left else padding + text
+
+def _float_text(value, precision, fixed=False, scientific=False,
+                uppercase=False, showpos=False):
+    """A double as an ostream with these flags prints it"""
+    conv = 'f' if fixed else 'e' if scientific else 'g'
+    if uppercase:
+        conv = conv.upper()
+    return ('%' + ('+' if showpos else '') + '.*' + conv) % (precision, value)
+
+class Printer(object):
+    """Formats messages like ccprintf, given decoded arguments"""
+    def __init__(self):
+        self.formats = {}
+
+    def format(self, fmt, args):
+        compiled = self.formats.get(fmt)
+        if compiled is None:
+            compiled = self.formats[fmt] = CompiledFormat(fmt)
+
+        out = []
+        # Stream state that survives from one argument to the next
+        self.precision = 6
+        index = 0
+        cont = False
+        f = None
+        for kind, size, value in args:
+            if not cont:
+                if index < len(compiled.parts):
+                    literal, conversion, _ = compiled.parts[index]
+                    out.append(literal)
+                    index += 1
+                    f = conversion.copy() if conversion else Format()
+                else:
+                    f = Format()
+
+            if f.get_width:
+                f.get_width = False
+                cont = True
+                f.width = value if kind == SIGNED_INT and size == 4 else 0
+                continue
+            if f.get_precision:
+                f.get_precision = False
+                cont = True
+                f.precision = \
+                    value if kind == SIGNED_INT and size == 4 else 0
+                continue
+
+            if f.format == CHARACTER:
+                out.append(self._char(kind, value))
+            elif f.format == INTEGER:
+                out.append(self._integer(kind, size, value, f))
+            elif f.format == FLOATING:
+                out.append(self._float(kind, value, f))
+            elif f.format == STR:
+                out.append(self._string(kind, value, f))
+            else:
+                out.append('<bad format>')
+
+        if index < len(compiled.parts):
+            out.append(compiled.extra(index))
+        return ''.join(out)
+
+    def _char(self, kind, value):
+        if kind in (BOOL, FLOAT, STRING):
+            return '<bad arg type for char format>'
+        return chr(value & 0xff)
+
+    def _stream(self, kind, value, precision):
+        """An argument streamed with default flags"""
+        if kind in (SIGNED_CHAR, UNSIGNED_CHAR):
+            return chr(value & 0xff)
+        if kind == FLOAT:
+            return _float_text(value, precision)
+        if kind == STRING:
+            return value
+        return str(value)
+
+    def _integer(self, kind, size, value, f):
+        prefix = ''
+        width = f.width
+        if f.alternate_form and f.fill_zero:
+            if f.base == HEX:
+                prefix = '0x'
+                width -= 2
+            elif f.base == OCT:
+                prefix = '0'
+                width -= 1
+        fill = '0' if f.fill_zero else ' '
+        left = f.flush_left and not f.fill_zero
+
+        if kind == FLOAT:
+            text = _float_text(value, self.precision,
+                               uppercase=f.uppercase, showpos=f.print_sign)
+        elif kind == STRING:
+            text = value
+        else:
+            signed = kind in (SIGNED_INT, BOOL)
+            if kind in (SIGNED_CHAR, UNSIGNED_CHAR):
+                # Characters are printed as int
+                signed, size = True, 4
+            elif kind == BOOL:
+                size = 8
+            if f.base == DEC:
+                text = str(value)
+                if f.print_sign and signed and value >= 0:
+                    text = '+' + text
+            else:
+                value &= (1 << (8 * size)) - 1
+                if f.base == HEX:
+                    text = '%x' % value
+                    base = '0x'
+                else:
+                    text = '%o' % value
+                    base = '0'
+                if f.alternate_form and not f.fill_zero and value:
+                    text = base + text
+                if f.uppercase:
+                    text = text.upper()
+        return prefix + _pad(text, width, fill, left)
+
+    def _float(self, kind, value, f):
+        if kind != FLOAT:
+            return '<bad arg type for float format>'
+
+        fixed = scientific = uppercase = False
+        if f.float_format == SCIENTIFIC:
+            if f.precision != -1:
+                if f.precision == 0:
+                    f.precision = 1
+                else:
+                    scientific = True
+                self.precision = f.precision
+            uppercase = f.uppercase
+        elif f.float_format == FIXED:
+            if f.precision != -1:
+                fixed = True
+                self.precision = f.precision
+        elif f.precision != -1:
+            self.precision = f.precision
+
+        text = _float_text(value, self.precision, fixed, scientific,
+                           uppercase)
+        return _pad(text, f.width, '0' if f.fill_zero else ' ', False)
+
+    def _string(self, kind, value, f):
+        if f.width > 0:
+            text = self._stream(kind, value, 6)
+            if f.width > len(text):
+                return _pad(text, f.width, ' ', f.flush_left)
+        return self._stream(kind, value, self.precision)
+
+def _decode_args(data):
+    args = []
+    pos = 0
+    end = len(data)
+    while pos < end:
+        kind = data[pos]
+        if not isinstance(kind, int):
+            kind = ord(kind)
+        if kind == STRING:
+            size, = struct.unpack_from('=I', data, pos + 1)
+            pos += 5
+            value = data[pos:pos + size].decode('latin-1')
+            pos += size
+        else:
+            size = data[pos + 1]
+            if not isinstance(size, int):
+                size = ord(size)
+            pos += 2
+            if kind == FLOAT:
+                value, = struct.unpack_from('=d', data, pos)
+            else:
+                signed = kind in (SIGNED_INT, SIGNED_CHAR)
+                code = { 1: 'b', 2: 'h', 4: 'i', 8: 'q' }[size]
+                if not signed:
+                    code = code.upper()
+                value, = struct.unpack_from('=' + code, data, pos)
+            pos += size
+        args.append((kind, size, value))
+    return args
+
+def _read(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError
+    return data
+
+def records(f):
+    """Yield (thread, tick, name, flag, format, args) for every message"""
+    if f.read(8) != MAGIC:
+        raise ValueError('Not a gem5 binary debug trace')
+    version, bom = struct.unpack('=II', _read(f, 8))
+    if bom != 0x01020304:
+        raise ValueError('Trace written with a different byte order')
+    if version != VERSION:
+        raise ValueError('Unsupported trace version %d' % version)
+
+    strings = {}
+    while True:
+        try:
+            kind, thread, size = struct.unpack('=IIQ', _read(f, 16))
+            data = _read(f, size)
+        except EOFError:
+            # Possibly cut short by a simulation that did not exit cleanly
+            return
+
+        pos = 0
+        if kind == STRING_CHUNK:
+            while pos < size:
+                sid, length = struct.unpack_from('=II', data, pos)
+                pos += 8
+                strings[sid] = data[pos:pos + length].decode('latin-1')
+                pos += length
+            continue
+
+        while pos < size:
+            tick, name, flag, fmt, args_size = \
+                struct.unpack_from('=QIIII', data, pos)
+            pos += 24
+            # A crash dump leaves the strings out if they were in use
+            yield (thread, tick, strings.get(name, '#%d' % name),
+                   strings.get(flag, '#%d' % flag), strings.get(fmt),
+                   data[pos:pos + args_size])
+            pos += args_size
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Render a gem5 binary debug trace as text')
+    parser.add_argument('trace', help='Binary trace written by gem5')
+    parser.add_argument('output', nargs='?', help='Output file [stdout]')
+    parser.add_argument('--flags', default=None,
+                        help='Comma separated debug flags to keep')
+    parser.add_argument('--objects', default=None,
+                        help='Comma separated object name patterns to keep '
+                        '(shell style wildcards)')
+    parser.add_argument('--start', type=int, default=0,
+                        help='Drop messages before this tick')
+    parser.add_argument('--end', type=int, default=None,
+                        help='Drop messages from this tick on')
+    parser.add_argument('--show-flags', action='store_true',
+                        help='Prefix messages with their flag, like the '
+                        'FmtFlag debug flag')
+    parser.add_argument('--no-ticks', action='store_true',
+                        help='Leave out the tick, like the FmtTicksOff '
+                        'debug flag')
+    options = parser.parse_args()
+
+    flags = set(options.flags.split(',')) if options.flags else None
+    objects = options.objects.split(',') if options.objects else None
+    printer = Printer()
+    name_matches = {}
+    # Messages without a tick (DPRINTFR) go with the last message from
+    # their thread that had one
+    last_tick = {}
+
+    # Text is passed through byte for byte, like the ostream would
+    if options.output:
+        out = io.open(options.output, 'w', encoding='latin-1', newline='')
+    else:
+        out = io.open(sys.stdout.fileno(), 'w', encoding='latin-1',
+                      newline='', closefd=False)
+    with open(options.trace, 'rb') as f:
+        for thread, tick, name, flag, fmt, args in records(f):
+            if tick == MAX_TICK:
+                when = last_tick.get(thread, 0)
+            else:
+                when = last_tick[thread] = tick
+            if when < options.start or \
+                    (options.end is not None and when >= options.end):
+                continue
+            if flags is not None and flag not in flags:
+                continue
+            if objects is not None:
+                keep = name_matches.get(name)
+                if keep is None:
+                    keep = name_matches[name] = any(
+                        fnmatch.fnmatchcase(name, p) for p in objects)
+                if not keep:
+                    continue
+
+            line = []
+            if tick != MAX_TICK and not options.no_ticks:
+                line.append('%7d: ' % tick)
+            if options.show_flags and flag:
+                line.append(flag + ': ')
+            if name:
+                line.append(name + ': ')
+            if fmt is None:
+                line.append(' '.join(str(value) for _, _, value in
+                                     _decode_args(args)) + '\n')
+            else:
+                line.append(printer.format(fmt, _decode_args(args)))
+            out.write(''.join(line))
+
+    out.close()
+
+if __name__ == '__main__':
+    main()
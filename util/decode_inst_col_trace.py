@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Read instruction traces written by the InstColTrace tracer.  The file
+# format is described in src/cpu/inst_col_trace.hh.
+#
+# Run as a script, it prints a trace in the same text format as
+# decode_inst_trace.py does for InstPBTrace:
+#
+#   decode_inst_col_trace.py m5out/trace.ict [trace.txt]
+#
+# As a module, it hands out a block of records at a time, with one array
+# per column.  The arrays are numpy arrays if numpy is installed, which
+# is what makes reading fast, and lists otherwise:
+#
+#   import decode_inst_col_trace as ict
+#   with open('m5out/trace.ict', 'rb') as f:
+#       trace = ict.Trace(f)
+#       for block in trace.blocks():
+#           loads = block.op_class == trace.op_classes.index('MemRead')
+#           ...
+#
+# Blocks of different CPUs are interleaved, so records are only in tick
+# order within a CPU.
+
+from __future__ import print_function
+
+import struct
+import sys
+import zlib
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+MAGIC = b'gem5ict\0'
+VERSION = 1
+
+# Name, width in bytes and whether the column holds deltas
+COLUMNS = [
+    ('tick', 8, True),
+    ('cpu', 4, False),
+    ('pc', 8, True),
+    ('inst', 4, False),
+    ('inst_size', 1, False),
+    ('inst_bytes', 1, False),
+    ('op_class', 1, False),
+    ('mem_count', 1, False),
+    ('data_kind', 1, False),
+    ('data', 8, True),
+    ('mem_addr', 8, True),
+    ('mem_size', 4, False),
+    ('mem_flags', 4, False),
+]
+
+# struct codes of the unsigned types of each width
+CODES = { 1: 'B', 4: 'I', 8: 'Q' }
+
+MASK = 2 ** 64 - 1
+
+def _read(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError
+    return data
+
+def _unshuffle(raw, width):
+    """Undo the byte transposition of a column"""
+    if width == 1 or not raw:
+        return raw
+    count = len(raw) // width
+    out = bytearray(len(raw))
+    for b in range(width):
+        out[b::width] = raw[b * count:(b + 1) * count]
+    return bytes(out)
+
+def _decode_numpy(raw, width, delta):
+    count = len(raw) // width
+    values = numpy.frombuffer(raw, dtype=numpy.uint8)
+    if width > 1:
+        values = values.reshape(width, count).T.copy() \
+            .view('<u%d' % width).reshape(count)
+    if delta:
+        # Wraps around like the unsigned values it encodes
+        values = numpy.cumsum(values, dtype=numpy.uint64)
+    return values
+
+def _decode_python(raw, width, delta):
+    if width == 1:
+        return list(bytearray(raw))
+    raw = _unshuffle(raw, width)
+    values = list(struct.unpack('<%d%s' % (len(raw) // width, CODES[width]),
+                                raw))
+    if delta:
+        total = 0
+        for i, value in enumerate(values):
+            total = (total + value) & MASK
+            values[i] = total
+    return values
+
+class Block(object):
+    """A block of records, with one attribute per column.  Ticks, PCs,
+    results and memory addresses are absolute values.  mem_start holds
+    the index of the first memory access of each record and data_index
+    the index of the result of each record in data, or -1."""
+
+    def __init__(self, records, columns):
+        self.records = records
+        for (name, _, _), values in zip(COLUMNS, columns):
+            setattr(self, name, values)
+
+        if numpy is not None:
+            counts = self.mem_count.astype(numpy.int64)
+            self.mem_start = numpy.cumsum(counts) - counts
+            has_data = self.data_kind != 0
+            self.data_index = numpy.where(
+                has_data, numpy.cumsum(has_data) - 1, -1)
+        else:
+            self.mem_start = []
+            self.data_index = []
+            mem = data = 0
+            for count, kind in zip(self.mem_count, self.data_kind):
+                self.mem_start.append(mem)
+                mem += count
+                self.data_index.append(data if kind else -1)
+                data += 1 if kind else 0
+
+class Trace(object):
+    def __init__(self, f):
+        self.file = f
+        if f.read(8) != MAGIC:
+            raise ValueError('Not a gem5 columnar instruction trace')
+        self.version, num_columns, self.tick_freq, num_classes = \
+            struct.unpack('<IIQI', _read(f, 20))
+        if self.version != VERSION or num_columns != len(COLUMNS):
+            raise ValueError('Unsupported trace version %d' % self.version)
+        self.op_classes = []
+        for _ in range(num_classes):
+            size, = struct.unpack('<I', _read(f, 4))
+            self.op_classes.append(_read(f, size).decode('ascii'))
+
+    def blocks(self):
+        decode = _decode_python if numpy is None else _decode_numpy
+        header = struct.Struct('<%dI' % (1 + 2 * len(COLUMNS)))
+        while True:
+            data = self.file.read(header.size)
+            if not data:
+                return
+            if len(data) != header.size:
+                raise EOFError('Truncated block header')
+            fields = header.unpack(data)
+            sizes = fields[1:]
+            payload = _read(self.file, sum(sizes[1::2]))
+
+            columns = []
+            offset = 0
+            for i, (_, width, delta) in enumerate(COLUMNS):
+                raw_size, size = sizes[2 * i], sizes[2 * i + 1]
+                raw = zlib.decompress(payload[offset:offset + size]) \
+                    if size else b''
+                offset += size
+                if len(raw) != raw_size:
+                    raise ValueError('Corrupt column in block')
+                columns.append(decode(raw, width, delta))
+            yield Block(fields[0], columns)
+
+def _tolist(values):
+    return values.tolist() if hasattr(values, 'tolist') else values
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print('Usage: %s <trace> [ASCII output]' % sys.argv[0])
+        sys.exit(1)
+
+    out = open(sys.argv[2], 'w') if len(sys.argv) == 3 else sys.stdout
+    with open(sys.argv[1], 'rb') as f:
+        trace = Trace(f)
+        names = [' : %10s' % name for name in trace.op_classes]
+        num_insts = 0
+        for block in trace.blocks():
+            columns = [ _tolist(getattr(block, name)) for name in
+                        ('tick', 'cpu', 'inst', 'pc', 'op_class', 'mem_count',
+                         'mem_addr', 'mem_size') ]
+            tick, cpu, inst, pc, op_class, mem_count, addr, size = columns
+            lines = []
+            mem = 0
+            for i in range(block.records):
+                line = '%-20d: (%03d/%03d) %#010x @ %#016x ' % \
+                    (tick[i], 0, cpu[i], inst[i], pc[i]) + names[op_class[i]]
+                for _ in range(mem_count[i]):
+                    line += ' %#x-%#x;' % (addr[mem], addr[mem] + size[mem])
+                    mem += 1
+                lines.append(line)
+            lines.append('')
+            out.write('\n'.join(lines))
+            num_insts += block.records
+
+    if out is not sys.stdout:
+        out.close()
+        print('Parsed instructions:', num_insts)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,383 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 The Regents of the University of California
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Read, write and convert block packet traces, the format written by
+# BlockMemTraceProbe and replayed by TraceGen.  The format is described
+# in src/mem/block_trace.hh.
+#
+#   packet_block_trace.py decode m5out/system.monitor.pbt trace.txt
+#   packet_block_trace.py from-proto system.monitor.trc.gz trace.pbt
+#   packet_block_trace.py to-proto trace.pbt system.monitor.trc.gz
+#
+# decode prints the same text as decode_packet_trace.py.  The protobuf
+# conversions need the Python protobuf module, like the other packet
+# trace scripts.
+#
+# As a module, BlockTraceReader hands out the records one at a time or a
+# block at a time, as numpy record arrays if numpy is installed:
+#
+#   import packet_block_trace
+#   with open('trace.pbt', 'rb') as f:
+#       trace = packet_block_trace.BlockTraceReader(f)
+#       trace.seek(1000000000)
+#       for block in trace.blocks():
+#           reads = block[block['cmd'] == 1]
+
+from __future__ import print_function
+
+import argparse
+import bisect
+import struct
+import sys
+import zlib
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+MAGIC = b'gem5pbt\0'
+INDEX_MAGIC = b'gem5idx\0'
+VERSION = 1
+BLOCK_COMPRESSED = 0x1
+
+# tick, addr, pc, flags, size, cmd, requestor id
+RECORD = struct.Struct('<QQQQIHH')
+BLOCK_HEADER = struct.Struct('<QIIQ')
+INDEX_ENTRY = struct.Struct('<QQQ')
+TRAILER = struct.Struct('<QQ8s')
+
+FIELDS = ('tick', 'addr', 'pc', 'flags', 'size', 'cmd', 'requestor_id')
+if numpy is not None:
+    DTYPE = numpy.dtype([('tick', '<u8'), ('addr', '<u8'), ('pc', '<u8'),
+                         ('flags', '<u8'), ('size', '<u4'), ('cmd', '<u2'),
+                         ('requestor_id', '<u2')])
+
+# ReadReq and WriteReq in the MemCmd::Command enum of src/mem/packet.hh
+READ_REQ = 1
+WRITE_REQ = 4
+
+def _read(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError
+    return data
+
+def _read_string(f):
+    size, = struct.unpack('<I', _read(f, 4))
+    return _read(f, size).decode('utf-8')
+
+def _write_string(f, value):
+    value = value.encode('utf-8')
+    f.write(struct.pack('<I', len(value)))
+    f.write(value)
+
+class BlockTraceReader(object):
+    def __init__(self, f):
+        self.file = f
+        if f.read(8) != MAGIC:
+            raise ValueError('Not a block packet trace')
+        version, record_size, self.tick_freq = \
+            struct.unpack('<IIQ', _read(f, 16))
+        if version != VERSION or record_size != RECORD.size:
+            raise ValueError('Unsupported trace version %d' % version)
+        self.obj_id = _read_string(f)
+        num_requestors, = struct.unpack('<I', _read(f, 4))
+        self.requestors = [ _read_string(f) for _ in range(num_requestors) ]
+        self.data_offset = f.tell()
+        self._read_index()
+        self._offset = self.data_offset
+        self._skip_until = None
+
+    def _read_index(self):
+        """Load the block index, if the trace has one"""
+        self.index = []
+        self.index_offset = None
+        f = self.file
+        f.seek(0, 2)
+        size = f.tell()
+        if size >= self.data_offset + TRAILER.size:
+            f.seek(size - TRAILER.size)
+            offset, count, magic = TRAILER.unpack(_read(f, TRAILER.size))
+            if magic == INDEX_MAGIC and offset >= self.data_offset and \
+                    offset + count * INDEX_ENTRY.size + TRAILER.size == size:
+                f.seek(offset)
+                data = _read(f, count * INDEX_ENTRY.size)
+                self.index = [
+                    INDEX_ENTRY.unpack_from(data, i * INDEX_ENTRY.size)
+                    for i in range(count) ]
+                self.index_offset = offset
+        f.seek(self.data_offset)
+
+    @property
+    def num_records(self):
+        """Number of records in an indexed trace, or None"""
+        if self.index_offset is None:
+            return None
+        if not self.index:
+            return 0
+        # The last block is the only one that may be short
+        last_offset, _, last_first = self.index[-1]
+        self.file.seek(last_offset)
+        _, records, _, _ = BLOCK_HEADER.unpack(
+            _read(self.file, BLOCK_HEADER.size))
+        return last_first + records
+
+    def reset(self):
+        self._offset = self.data_offset
+        self._skip_until = None
+
+    def seek(self, tick):
+        """Move to the first record at or after a tick"""
+        self._offset = self.data_offset
+        if self.index:
+            ticks = [ first_tick for _, first_tick, _ in self.index ]
+            pos = bisect.bisect_left(ticks, tick)
+            if pos:
+                self._offset = self.index[pos - 1][0]
+        self._skip_until = tick
+
+    def raw_blocks(self):
+        """Decompressed blocks as bytes, from the current position"""
+        f = self.file
+        end = self.index_offset
+        while end is None or self._offset < end:
+            f.seek(self._offset)
+            header = f.read(BLOCK_HEADER.size)
+            if not header:
+                return
+            if len(header) != BLOCK_HEADER.size:
+                raise EOFError('Truncated block header')
+            _, records, flags, size = BLOCK_HEADER.unpack(header)
+            data = _read(f, size)
+            if flags & BLOCK_COMPRESSED:
+                data = zlib.decompress(data)
+            if len(data) != records * RECORD.size:
+                raise ValueError('Corrupt block at offset %d' % self._offset)
+            self._offset += BLOCK_HEADER.size + size
+            yield data
+
+    def blocks(self):
+        """Blocks of records, as numpy record arrays if numpy is
+        installed and as lists of tuples of FIELDS otherwise"""
+        for data in self.raw_blocks():
+            if numpy is not None:
+                block = numpy.frombuffer(data, dtype=DTYPE)
+                if self._skip_until is not None:
+                    block = block[block['tick'] >= self._skip_until]
+            else:
+                block = [ RECORD.unpack_from(data, i)
+                          for i in range(0, len(data), RECORD.size) ]
+                if self._skip_until is not None:
+                    block = [ r for r in block if r[0] >= self._skip_until ]
+            if len(block):
+                self._skip_until = None
+                yield block
+
+    def records(self):
+        """Records as tuples of FIELDS"""
+        skip = self._skip_until
+        self._skip_until = None
+        for data in self.raw_blocks():
+            for i in range(0, len(data), RECORD.size):
+                record = RECORD.unpack_from(data, i)
+                if skip is not None:
+                    if record[0] < skip:
+                        continue
+                    skip = None
+                yield record
+
+class BlockTraceWriter(object):
+    def __init__(self, f, obj_id, tick_freq, requestors, block_size=16384,
+                 compress=True):
+        self.file = f
+        self.block_size = block_size
+        self.compress = compress
+        self.block = []
+        self.index = []
+        self.records = 0
+
+        f.write(MAGIC)
+        f.write(struct.pack('<IIQ', VERSION, RECORD.size, tick_freq))
+        _write_string(f, obj_id)
+        f.write(struct.pack('<I', len(requestors)))
+        for name in requestors:
+            _write_string(f, name)
+        self.offset = f.tell()
+
+    def write(self, tick, addr, size, cmd, flags=0, pc=0, requestor_id=0):
+        self.block.append(RECORD.pack(tick, addr, pc, flags, size, cmd,
+                                      requestor_id))
+        if len(self.block) == self.block_size:
+            self._flush()
+
+    def _flush(self):
+        if not self.block:
+            return
+        first_tick = RECORD.unpack_from(self.block[0])[0]
+        data = b''.join(self.block)
+        flags = 0
+        if self.compress:
+            data = zlib.compress(data, 1)
+            flags |= BLOCK_COMPRESSED
+        self.file.write(BLOCK_HEADER.pack(first_tick, len(self.block), flags,
+                                          len(data)))
+        self.file.write(data)
+        self.index.append((self.offset, first_tick, self.records))
+        self.offset += BLOCK_HEADER.size + len(data)
+        self.records += len(self.block)
+        self.block = []
+
+    def close(self):
+        self._flush()
+        for entry in self.index:
+            self.file.write(INDEX_ENTRY.pack(*entry))
+        self.file.write(TRAILER.pack(self.offset, len(self.index),
+                                     INDEX_MAGIC))
+
+def _packet_pb2():
+    import os
+    import subprocess
+    util_dir = os.path.dirname(os.path.realpath(__file__))
+    subprocess.check_call(['make', '--quiet', '-C', util_dir,
+                           'packet_pb2.py'])
+    import packet_pb2
+    return packet_pb2
+
+def decode(args):
+    with open(args.input, 'rb') as f, open(args.output, 'w') as out:
+        num_packets = 0
+        for tick, addr, pc, flags, size, cmd, requestor_id in \
+                BlockTraceReader(f).records():
+            kind = 'r' if cmd == READ_REQ else \
+                ('w' if cmd == WRITE_REQ else 'u')
+            out.write('%s,%s,%s,%s,%s,%s' % (requestor_id, kind, addr, size,
+                                             flags, tick))
+            out.write(',%s\n' % pc if pc else '\n')
+            num_packets += 1
+    print('Parsed packets:', num_packets)
+
+def from_proto(args):
+    import protolib
+    packet_pb2 = _packet_pb2()
+
+    proto_in = protolib.openFileRd(args.input)
+    if proto_in.read(4) != b'gem5':
+        sys.exit('Unrecognized file %s' % args.input)
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+    requestors = {}
+    for id_string in header.id_strings:
+        requestors[id_string.key] = id_string.value
+    names = [ requestors.get(i, '') for i in
+              range(max(requestors.keys()) + 1 if requestors else 0) ]
+
+    num_packets = 0
+    with open(args.output, 'wb') as f:
+        writer = BlockTraceWriter(f, header.obj_id, header.tick_freq, names,
+                                  args.block_size, not args.no_compress)
+        packet = packet_pb2.Packet()
+        while protolib.decodeMessage(proto_in, packet):
+            writer.write(packet.tick, packet.addr, packet.size, packet.cmd,
+                         packet.flags, packet.pc, packet.pkt_id)
+            num_packets += 1
+        writer.close()
+    proto_in.close()
+    print('Converted packets:', num_packets)
+
+def to_proto(args):
+    import gzip
+    import protolib
+    packet_pb2 = _packet_pb2()
+
+    if args.output.endswith('.gz'):
+        proto_out = gzip.open(args.output, 'wb')
+    else:
+        proto_out = open(args.output, 'wb')
+
+    num_packets = 0
+    with open(args.input, 'rb') as f:
+        trace = BlockTraceReader(f)
+        proto_out.write(b'gem5')
+        header = packet_pb2.PacketHeader()
+        header.obj_id = trace.obj_id
+        header.tick_freq = trace.tick_freq
+        for i, name in enumerate(trace.requestors):
+            id_string = header.id_strings.add()
+            id_string.key = i
+            id_string.value = name
+        protolib.encodeMessage(proto_out, header)
+
+        for tick, addr, pc, flags, size, cmd, requestor_id in trace.records():
+            packet = packet_pb2.Packet()
+            packet.tick = tick
+            packet.cmd = cmd
+            packet.addr = addr
+            packet.size = size
+            packet.flags = flags & 0xffffffff
+            packet.pkt_id = requestor_id
+            if pc:
+                packet.pc = pc
+            protolib.encodeMessage(proto_out, packet)
+            num_packets += 1
+    proto_out.close()
+    print('Converted packets:', num_packets)
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode and convert block packet traces')
+    commands = parser.add_subparsers(dest='command')
+
+    cmd = commands.add_parser('decode', help='Print a block trace as text')
+    cmd.add_argument('input')
+    cmd.add_argument('output')
+    cmd.set_defaults(func=decode)
+
+    cmd = commands.add_parser('from-proto',
+                              help='Convert a protobuf trace to a block trace')
+    cmd.add_argument('input')
+    cmd.add_argument('output')
+    cmd.add_argument('--block-size', type=int, default=16384,
+                     help='Number of packets per block')
+    cmd.add_argument('--no-compress', action='store_true',
+                     help='Store the blocks uncompressed')
+    cmd.set_defaults(func=from_proto)
+
+    cmd = commands.add_parser('to-proto',
+                              help='Convert a block trace to a protobuf trace')
+    cmd.add_argument('input')
+    cmd.add_argument('output')
+    cmd.set_defaults(func=to_proto)
+
+    args = parser.parse_args()
+    if not hasattr(args, 'func'):
+        parser.error('No command given')
+    args.func(args)
+
+if __name__ == '__main__':
+    main()